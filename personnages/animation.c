@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// ANIMATION - sprite sheets, clips and animated sequences
+// =============================================================================
+//
+// A sprite sheet is one texture plus a list of clips; a clip is a run of
+// frames, each an atlas region with its own duration. Sheets are described
+// by a small text file:
+//
+//   # comment
+//   image first_player.png
+//   clip idle loop                          start a clip (loop | once)
+//   frame 0 0 200 300 400                   x y w h duration_ms
+//   grid walk loop 0 300 200 300 6 100      name mode x y w h count duration_ms
+//                                           (count frames side by side)
+//
+// Sheets are loaded once and shared by every instance that uses them. An
+// instance only stores a clip, a frame index and the time spent on that
+// frame, so advancing it is a few additions and drawing it is a source rect.
+// Atlas textures come from the scene texture cache (declare the image in the
+// scene that loads the sheet so it is decoded in the background) and are
+// only held while a sheet is referenced; the clips stay in the pools so
+// loading the sheet again only takes the texture back.
+
+// Sheets, clips and frames live in fixed pools
+static SpriteSheet sheets[ANIM_MAX_SHEETS];
+static int sheet_count = 0;
+static AnimationClip clips[ANIM_MAX_CLIPS];
+static int clip_count = 0;
+static AnimationFrame frames[ANIM_MAX_FRAMES];
+static int frame_count = 0;
+static AnimationInstance instances[ANIM_MAX_INSTANCES];
+
+// Start a clip in the pools; frames are appended until the next clip
+static AnimationClip* begin_clip(int sheet, const char* name, const char* mode) {
+    if (clip_count >= ANIM_MAX_CLIPS) {
+        printf("Error: Maximum animation clips limit reached (%d)\n", ANIM_MAX_CLIPS);
+        return NULL;
+    }
+    AnimationClip* clip = &clips[clip_count++];
+    memset(clip, 0, sizeof(*clip));
+    strncpy(clip->name, name, sizeof(clip->name) - 1);
+    clip->sheet = sheet;
+    clip->first_frame = frame_count;
+    clip->loop = strcmp(mode, "once") != 0;
+    sheets[sheet].clip_count++;
+    return clip;
+}
+
+static int add_frame(AnimationClip* clip, int x, int y, int w, int h, int duration_ms) {
+    if (!clip) return -1;
+    if (frame_count >= ANIM_MAX_FRAMES) {
+        printf("Error: Maximum animation frames limit reached (%d)\n", ANIM_MAX_FRAMES);
+        return -1;
+    }
+    if (duration_ms < 1) duration_ms = 1;
+    frames[frame_count].region = (SDL_Rect){x, y, w, h};
+    frames[frame_count].duration_ms = duration_ms;
+    frame_count++;
+    clip->frame_count++;
+    clip->total_ms += duration_ms;
+    return 0;
+}
+
+// Load a sheet description (or return the already loaded sheet).
+// Returns the sheet index, or -1 on failure.
+int load_sprite_sheet(const char* path) {
+    for (int i = 0; i < sheet_count; i++) {
+        if (strcmp(sheets[i].path, path) != 0) continue;
+        // An unused sheet gave its texture back: take it again
+        if (!sheets[i].texture) {
+            sheets[i].texture = acquire_scene_image(sheets[i].image);
+            if (!sheets[i].texture) {
+                printf("Failed to load sheet image '%s'\n", sheets[i].image);
+                return -1;
+            }
+        }
+        sheets[i].refcount++;
+        return i;
+    }
+    if (sheet_count >= ANIM_MAX_SHEETS) {
+        printf("Error: Maximum sprite sheets limit reached (%d)\n", ANIM_MAX_SHEETS);
+        return -1;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("Failed to open sprite sheet '%s'\n", path);
+        return -1;
+    }
+
+    int index = sheet_count;
+    SpriteSheet* sheet = &sheets[index];
+    memset(sheet, 0, sizeof(*sheet));
+    strncpy(sheet->path, path, sizeof(sheet->path) - 1);
+    sheet->first_clip = clip_count;
+
+    // Pools are rolled back if the file turns out to be invalid
+    int saved_clips = clip_count;
+    int saved_frames = frame_count;
+    AnimationClip* clip = NULL;
+    char line[512];
+    int line_number = 0;
+    int ok = 1;
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        char keyword[16], name[64], mode[16];
+        int x, y, w, h, count, duration;
+
+        if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#') continue;
+
+        if (strcmp(keyword, "image") == 0) {
+            if (sheet->texture) release_scene_image(sheet->texture);
+            sheet->texture = NULL;
+            if (sscanf(line, "%*s %255s", sheet->image) == 1) {
+                sheet->texture = acquire_scene_image(sheet->image);
+            }
+            if (!sheet->texture) {
+                printf("Failed to load sheet image (%s:%d)\n", path, line_number);
+                ok = 0;
+            }
+        } else if (strcmp(keyword, "clip") == 0 &&
+                   sscanf(line, "%*s %63s %15s", name, mode) == 2) {
+            clip = begin_clip(index, name, mode);
+            ok = clip != NULL;
+        } else if (strcmp(keyword, "frame") == 0 &&
+                   sscanf(line, "%*s %d %d %d %d %d", &x, &y, &w, &h, &duration) == 5) {
+            ok = add_frame(clip, x, y, w, h, duration) == 0;
+        } else if (strcmp(keyword, "grid") == 0 &&
+                   sscanf(line, "%*s %63s %15s %d %d %d %d %d %d",
+                          name, mode, &x, &y, &w, &h, &count, &duration) == 8) {
+            clip = begin_clip(index, name, mode);
+            for (int i = 0; clip && i < count && ok; i++) {
+                ok = add_frame(clip, x + i * w, y, w, h, duration) == 0;
+            }
+            ok = ok && clip != NULL;
+        } else {
+            printf("Error: Invalid line in sprite sheet '%s' (line %d)\n", path, line_number);
+            ok = 0;
+        }
+    }
+    fclose(file);
+
+    // Every clip needs at least one frame
+    for (int i = saved_clips; ok && i < clip_count; i++) {
+        if (clips[i].frame_count == 0) {
+            printf("Error: Clip '%s' in '%s' has no frames\n", clips[i].name, path);
+            ok = 0;
+        }
+    }
+    if (ok && !sheet->texture) {
+        printf("Error: Sprite sheet '%s' has no image\n", path);
+        ok = 0;
+    }
+    if (!ok) {
+        release_scene_image(sheet->texture);
+        memset(sheet, 0, sizeof(*sheet));
+        clip_count = saved_clips;
+        frame_count = saved_frames;
+        return -1;
+    }
+
+    sheet->refcount = 1;
+    sheet_count++;
+    printf("Sprite sheet '%s' loaded (%d clips, %d frames)\n",
+           path, sheet->clip_count, frame_count - saved_frames);
+    return index;
+}
+
+// Find a clip of a sheet by name (-1 if missing)
+int find_animation_clip(int sheet, const char* name) {
+    if (sheet < 0 || sheet >= sheet_count) return -1;
+    for (int i = 0; i < sheets[sheet].clip_count; i++) {
+        int c = sheets[sheet].first_clip + i;
+        if (strcmp(clips[c].name, name) == 0) return c;
+    }
+    return -1;
+}
+
+// Drop one reference to a sheet. The last one gives its texture back; the
+// clips and frames stay pooled until cleanup_animations().
+void release_sprite_sheet(int sheet) {
+    if (sheet < 0 || sheet >= sheet_count || sheets[sheet].refcount == 0) return;
+    if (--sheets[sheet].refcount == 0) {
+        release_scene_image(sheets[sheet].texture);
+        sheets[sheet].texture = NULL;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Instances
+// -----------------------------------------------------------------------------
+
+// Animate a sequence with a clip of a sheet (the sheet is referenced until
+// the animation stops or another sheet is played). Returns the instance index.
+int play_sequence_animation(Sequence* seq, int sheet, const char* clip_name) {
+    if (!seq) return -1;
+    int clip = find_animation_clip(sheet, clip_name);
+    if (clip < 0) {
+        printf("Error: Clip '%s' not found\n", clip_name);
+        return -1;
+    }
+
+    int index = seq->animation;
+    if (index < 0) {
+        for (int i = 0; i < ANIM_MAX_INSTANCES; i++) {
+            if (!instances[i].active) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) {
+            printf("Error: Maximum animation instances limit reached (%d)\n", ANIM_MAX_INSTANCES);
+            return -1;
+        }
+        sheets[sheet].refcount++;
+    } else if (clips[instances[index].clip].sheet != sheet) {
+        // Playing another sheet: move the reference over
+        sheets[sheet].refcount++;
+        release_sprite_sheet(clips[instances[index].clip].sheet);
+    }
+
+    AnimationInstance* inst = &instances[index];
+    memset(inst, 0, sizeof(*inst));
+    inst->active = 1;
+    inst->clip = clip;
+    inst->speed = 1.0f;
+    seq->animation = index;
+    return index;
+}
+
+// Switch an instance to another clip of its sheet (no-op if already playing)
+void set_animation_clip(int instance, const char* clip_name) {
+    if (instance < 0 || instance >= ANIM_MAX_INSTANCES || !instances[instance].active) return;
+
+    AnimationInstance* inst = &instances[instance];
+    int clip = find_animation_clip(clips[inst->clip].sheet, clip_name);
+    if (clip < 0 || clip == inst->clip) return;
+    inst->clip = clip;
+    inst->frame = 0;
+    inst->time_ms = 0.0f;
+    inst->finished = 0;
+}
+
+// Playback rate of an instance (1 = as authored)
+void set_animation_speed(int instance, float speed) {
+    if (instance < 0 || instance >= ANIM_MAX_INSTANCES) return;
+    instances[instance].speed = speed;
+}
+
+// Stop animating a sequence (it goes back to its static image)
+void stop_sequence_animation(Sequence* seq) {
+    if (!seq || seq->animation < 0) return;
+    AnimationInstance* inst = &instances[seq->animation];
+    release_sprite_sheet(clips[inst->clip].sheet);
+    inst->active = 0;
+    seq->animation = -1;
+}
+
+// Advance every instance by the frame time
+void update_animations(double frame_seconds) {
+    float elapsed_ms = (float)(frame_seconds * 1000.0);
+
+    for (int i = 0; i < ANIM_MAX_INSTANCES; i++) {
+        AnimationInstance* inst = &instances[i];
+        if (!inst->active || inst->finished) continue;
+
+        const AnimationClip* clip = &clips[inst->clip];
+        inst->time_ms += elapsed_ms * inst->speed;
+
+        // Skip whole cycles at once after a long stall
+        if (clip->loop && inst->time_ms >= (float)clip->total_ms * 2.0f) {
+            inst->time_ms -= (float)clip->total_ms * (int)(inst->time_ms / clip->total_ms - 1.0f);
+        }
+
+        while (inst->time_ms >= frames[clip->first_frame + inst->frame].duration_ms) {
+            inst->time_ms -= frames[clip->first_frame + inst->frame].duration_ms;
+            if (inst->frame + 1 < clip->frame_count) {
+                inst->frame++;
+            } else if (clip->loop) {
+                inst->frame = 0;
+            } else {
+                inst->finished = 1;
+                inst->time_ms = 0.0f;
+                break;
+            }
+        }
+    }
+}
+
+// Texture and source region for the current frame of a sequence's
+// animation. Returns 0 if the sequence is not animated.
+int get_sequence_animation_frame(const Sequence* seq, SDL_Texture** texture, SDL_Rect* region) {
+    if (!seq || seq->animation < 0) return 0;
+    const AnimationInstance* inst = &instances[seq->animation];
+    if (!inst->active) return 0;
+
+    const AnimationClip* clip = &clips[inst->clip];
+    *texture = sheets[clip->sheet].texture;
+    *region = frames[clip->first_frame + inst->frame].region;
+    return 1;
+}
+
+// Pick idle / walk for each player from its simulated velocity
+void animate_players(const GameSimulation* sim) {
+    for (int i = 0; i < 2; i++) {
+        const Sequence* seq = sim->sequences[i];
+        if (!seq || seq->animation < 0) continue;
+
+        float vx = sim->players[i].vx;
+        float vy = sim->players[i].vy;
+        float speed_sq = vx * vx + vy * vy;
+        set_animation_clip(seq->animation, speed_sq > 40.0f * 40.0f ? "walk" : "idle");
+    }
+}
+
+// Reset the pools (sheet textures belong to the scene texture cache)
+void cleanup_animations(void) {
+    memset(sheets, 0, sizeof(sheets));
+    memset(instances, 0, sizeof(instances));
+    sheet_count = 0;
+    clip_count = 0;
+    frame_count = 0;
+}
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// ARENA - frame allocator, scratch surfaces and heap counters
+// =============================================================================
+//
+// Data that only lives until the frame is presented (particle meshes, ...)
+// comes from a linear arena: an allocation is a pointer
+// bump, and everything is released at once by reset_frame_arena() right after
+// SDL_RenderPresent. Nothing allocated here may be kept across frames.
+//
+// Surfaces used as temporary pixel buffers are pooled by size instead of
+// being created and freed each time.
+//
+// Allocations made through SDL's allocator (SDL, SDL_image, SDL_ttf and our
+// own SDL_malloc calls) go through counting wrappers, so the benchmarks can
+// check that steady-state frames make no SDL heap allocations. Plain malloc
+// (FreeType inside SDL_ttf, the GPU driver, libc) is not seen: a count of
+// zero does not mean the frame never touched the heap.
+
+// Arena storage, 16-byte aligned for SIMD users
+static _Alignas(16) Uint8 frame_arena[FRAME_ARENA_SIZE];
+static size_t arena_used = 0;
+static size_t arena_peak = 0;
+static int arena_overflows = 0;
+
+// Heap counters (updated from any thread)
+static SDL_atomic_t allocation_count;
+static SDL_atomic_t free_count;
+static SDL_malloc_func real_malloc = NULL;
+static SDL_calloc_func real_calloc = NULL;
+static SDL_realloc_func real_realloc = NULL;
+static SDL_free_func real_free = NULL;
+
+// Surfaces reused as scratch pixel buffers
+static SDL_Surface* scratch_surfaces[SCRATCH_SURFACE_POOL];
+static int scratch_in_use[SCRATCH_SURFACE_POOL];
+static int scratch_hits = 0;
+static int scratch_misses = 0;
+
+// -----------------------------------------------------------------------------
+// Heap counters
+// -----------------------------------------------------------------------------
+
+static void* SDLCALL counting_malloc(size_t size) {
+    SDL_AtomicAdd(&allocation_count, 1);
+    return real_malloc(size);
+}
+
+static void* SDLCALL counting_calloc(size_t count, size_t size) {
+    SDL_AtomicAdd(&allocation_count, 1);
+    return real_calloc(count, size);
+}
+
+static void* SDLCALL counting_realloc(void* memory, size_t size) {
+    SDL_AtomicAdd(&allocation_count, 1);
+    return real_realloc(memory, size);
+}
+
+static void SDLCALL counting_free(void* memory) {
+    if (memory) SDL_AtomicAdd(&free_count, 1);
+    real_free(memory);
+}
+
+// Route SDL's allocator through the counters. Must be the first SDL call.
+int install_allocation_counters(void) {
+    SDL_GetMemoryFunctions(&real_malloc, &real_calloc, &real_realloc, &real_free);
+    if (SDL_SetMemoryFunctions(counting_malloc, counting_calloc,
+                               counting_realloc, counting_free) != 0) {
+        printf("Failed to install allocation counters: %s\n", SDL_GetError());
+        real_malloc = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Frame arena (main thread only)
+// -----------------------------------------------------------------------------
+
+// Allocate transient memory, valid until the next reset_frame_arena().
+// Returns NULL if the arena is full.
+void* frame_alloc(size_t size) {
+    size_t offset = (arena_used + 15) & ~(size_t)15;
+    if (size > FRAME_ARENA_SIZE - offset) {
+        if (arena_overflows++ == 0) {
+            printf("Error: Frame arena exhausted (%zu bytes requested, %zu used)\n",
+                   size, arena_used);
+        }
+        return NULL;
+    }
+    arena_used = offset + size;
+    return frame_arena + offset;
+}
+
+// Release everything allocated this frame (after SDL_RenderPresent)
+void reset_frame_arena(void) {
+    if (arena_used > arena_peak) arena_peak = arena_used;
+    arena_used = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Scratch surfaces
+// -----------------------------------------------------------------------------
+
+// Borrow an ARGB8888 surface of exactly w x h (main thread only).
+// Contents are undefined.
+SDL_Surface* acquire_scratch_surface(int w, int h) {
+    int free_slot = -1;
+    for (int i = 0; i < SCRATCH_SURFACE_POOL; i++) {
+        if (scratch_in_use[i]) continue;
+        SDL_Surface* s = scratch_surfaces[i];
+        if (s && s->w == w && s->h == h) {
+            scratch_in_use[i] = 1;
+            scratch_hits++;
+            return s;
+        }
+        // Prefer an empty slot over replacing a surface of another size
+        if (free_slot < 0 || (scratch_surfaces[free_slot] && !s)) free_slot = i;
+    }
+
+    scratch_misses++;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        printf("Failed to create scratch surface: %s\n", SDL_GetError());
+        return NULL;
+    }
+    if (free_slot < 0) return surface;   // Pool exhausted: freed on release
+
+    if (scratch_surfaces[free_slot]) SDL_FreeSurface(scratch_surfaces[free_slot]);
+    scratch_surfaces[free_slot] = surface;
+    scratch_in_use[free_slot] = 1;
+    return surface;
+}
+
+// Give a scratch surface back to the pool
+void release_scratch_surface(SDL_Surface* surface) {
+    if (!surface) return;
+    for (int i = 0; i < SCRATCH_SURFACE_POOL; i++) {
+        if (scratch_surfaces[i] == surface) {
+            scratch_in_use[i] = 0;
+            return;
+        }
+    }
+    SDL_FreeSurface(surface);
+}
+
+// -----------------------------------------------------------------------------
+// Statistics / cleanup
+// -----------------------------------------------------------------------------
+
+MemoryStats get_memory_stats(void) {
+    MemoryStats stats;
+    stats.allocations = SDL_AtomicGet(&allocation_count);
+    stats.frees = SDL_AtomicGet(&free_count);
+    stats.arena_used = arena_used;
+    stats.arena_peak = arena_used > arena_peak ? arena_used : arena_peak;
+    stats.arena_overflows = arena_overflows;
+    stats.scratch_hits = scratch_hits;
+    stats.scratch_misses = scratch_misses;
+    return stats;
+}
+
+void print_memory_stats(void) {
+    MemoryStats stats = get_memory_stats();
+    printf("\n=== MEMORY STATS ===\n");
+    printf("SDL heap: %d allocations, %d frees (%s)\n", stats.allocations, stats.frees,
+           real_malloc ? "SDL allocator" : "counters not installed");
+    printf("Frame arena: peak %.1f KB of %d KB, %d overflows\n",
+           stats.arena_peak / 1024.0, FRAME_ARENA_SIZE / 1024, stats.arena_overflows);
+    printf("Scratch surfaces: %d reused, %d created\n", stats.scratch_hits, stats.scratch_misses);
+    printf("====================\n");
+}
+
+void cleanup_scratch_surfaces(void) {
+    for (int i = 0; i < SCRATCH_SURFACE_POOL; i++) {
+        if (scratch_surfaces[i]) SDL_FreeSurface(scratch_surfaces[i]);
+        scratch_surfaces[i] = NULL;
+        scratch_in_use[i] = 0;
+    }
+}
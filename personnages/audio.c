@@ -0,0 +1,329 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// AUDIO ENGINE - device setup, sound effect bank and voice allocation
+// =============================================================================
+//
+// - The mixer buffer is sized from a latency target and the device's own
+//   preferred size instead of a fixed 2048 samples (~46ms at 44.1kHz).
+// - Short effects are decoded once into Mix_Chunks and kept in a bank.
+// - A fixed set of voices (mixer channels) is shared by all effects; when
+//   every voice is busy the lowest priority, oldest voice is stolen.
+// - Game code never calls into SDL_mixer directly: play_sound() pushes a
+//   command into a lock-free queue and a dedicated audio control thread
+//   applies it, so triggering a sound never waits on the audio device lock.
+
+#define AUDIO_TARGET_LATENCY_MS 10
+#define AUDIO_MIN_BUFFER 256
+#define AUDIO_MAX_BUFFER 4096
+
+// Global audio engine instance
+AudioEngine audio;
+
+// Round up to the next power of two
+static int next_power_of_two(int value) {
+    int p = 1;
+    while (p < value) p <<= 1;
+    return p;
+}
+
+// Pick a buffer size (in sample frames) for the default output device
+int choose_audio_buffer_size(int frequency) {
+    int samples = next_power_of_two(frequency * AUDIO_TARGET_LATENCY_MS / 1000);
+
+    // Some backends (e.g. PulseAudio) underrun below their preferred period,
+    // so never go under what the device reports. The devices are only listed
+    // once the audio subsystem runs (SDL_mixer would start it later).
+    if (!SDL_WasInit(SDL_INIT_AUDIO) && SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+        printf("Warning: Could not query audio devices: %s\n", SDL_GetError());
+    } else {
+        SDL_AudioSpec device_spec;
+        if (SDL_GetNumAudioDevices(0) > 0 && SDL_GetAudioDeviceSpec(0, 0, &device_spec) == 0 &&
+            device_spec.samples > samples) {
+            samples = next_power_of_two(device_spec.samples);
+        }
+    }
+
+    if (samples < AUDIO_MIN_BUFFER) samples = AUDIO_MIN_BUFFER;
+    if (samples > AUDIO_MAX_BUFFER) samples = AUDIO_MAX_BUFFER;
+    return samples;
+}
+
+// Audio control thread: drains the command queue and talks to SDL_mixer
+static int audio_command_thread(void* data);
+
+// Called by SDL_mixer (audio thread) when a voice finishes or is halted
+static void voice_finished(int channel) {
+    (void)channel;
+    SDL_AtomicAdd(&audio.active_voices, -1);
+}
+
+// Open the audio device and start the engine.
+// buffer_samples = 0 picks a size for the current device.
+int init_audio_engine(int frequency, int buffer_samples) {
+    memset(&audio, 0, sizeof(audio));
+
+    int samples = buffer_samples > 0 ? buffer_samples : choose_audio_buffer_size(frequency);
+
+    // Start small and back off if the device refuses the buffer size
+    while (Mix_OpenAudioDevice(frequency, MIX_DEFAULT_FORMAT, 2, samples, NULL,
+                               SDL_AUDIO_ALLOW_FREQUENCY_CHANGE) < 0) {
+        if (samples >= AUDIO_MAX_BUFFER) {
+            printf("SDL_mixer could not initialize! Mix_Error: %s\n", Mix_GetError());
+            return -1;
+        }
+        samples *= 2;
+    }
+
+    Mix_QuerySpec(&audio.frequency, &audio.format, &audio.channels);
+    audio.buffer_samples = samples;
+    audio.opened = 1;
+
+    Mix_AllocateChannels(AUDIO_VOICES);
+    Mix_ChannelFinished(voice_finished);
+    for (int i = 0; i < AUDIO_VOICES; i++) {
+        audio.voices[i].sound = -1;
+        audio.voices[i].priority = -1;
+    }
+
+    // Queue slots start with their own index as sequence number
+    for (int i = 0; i < AUDIO_QUEUE_SIZE; i++) {
+        SDL_AtomicSet(&audio.queue[i].sequence, i);
+    }
+    SDL_AtomicSet(&audio.queue_head, 0);
+    audio.queue_tail = 0;
+
+    audio.wake = SDL_CreateSemaphore(0);
+    SDL_AtomicSet(&audio.quit, 0);
+    audio.thread = audio.wake ? SDL_CreateThread(audio_command_thread, "audio_commands", NULL) : NULL;
+    if (!audio.thread) {
+        printf("Failed to start audio command thread: %s\n", SDL_GetError());
+        if (audio.wake) SDL_DestroySemaphore(audio.wake);
+        audio.wake = NULL;
+        Mix_CloseAudio();
+        audio.opened = 0;
+        return -1;
+    }
+
+    printf("SDL_mixer initialized (%d Hz, %d channels, %d sample buffer = %.1f ms, %d voices)\n",
+           audio.frequency, audio.channels, audio.buffer_samples,
+           audio.buffer_samples * 1000.0 / audio.frequency, AUDIO_VOICES);
+    return 0;
+}
+
+// Stop the engine, free every effect and close the device
+void shutdown_audio_engine(void) {
+    if (!audio.opened) return;
+
+    SDL_AtomicSet(&audio.quit, 1);
+    SDL_SemPost(audio.wake);
+    SDL_WaitThread(audio.thread, NULL);
+    SDL_DestroySemaphore(audio.wake);
+
+    Mix_HaltChannel(-1);
+    Mix_ChannelFinished(NULL);
+    for (int i = 0; i < audio.sound_count; i++) {
+        if (audio.sounds[i].chunk) {
+            Mix_FreeChunk(audio.sounds[i].chunk);
+            audio.sounds[i].chunk = NULL;
+        }
+    }
+
+    printf("Audio engine: %d sounds played, %d voices stolen, %d dropped, %d queue overflows\n",
+           audio.played, audio.stolen, audio.dropped, SDL_AtomicGet(&audio.queue_overflows));
+
+    Mix_CloseAudio();
+    audio.opened = 0;
+}
+
+// =============================================================================
+// SOUND BANK
+// =============================================================================
+
+// Decode a short effect into the bank. Returns its id, or -1 on failure.
+int load_sound(const char* name, const char* path, int priority, int volume) {
+    if (!audio.opened) return -1;
+    if (audio.sound_count >= AUDIO_MAX_SOUNDS) {
+        printf("Error: Maximum sound effects limit reached (%d)\n", AUDIO_MAX_SOUNDS);
+        return -1;
+    }
+
+    Mix_Chunk* chunk = Mix_LoadWAV(path);
+    if (!chunk) {
+        printf("Failed to load sound '%s': %s\n", path, Mix_GetError());
+        return -1;
+    }
+    Mix_VolumeChunk(chunk, volume);
+
+    SoundEffect* sfx = &audio.sounds[audio.sound_count];
+    strncpy(sfx->name, name, sizeof(sfx->name) - 1);
+    sfx->name[sizeof(sfx->name) - 1] = '\0';
+    sfx->chunk = chunk;
+    sfx->priority = priority;
+
+    printf("Sound '%s' loaded (%u bytes decoded, priority %d)\n", name, chunk->alen, priority);
+    return audio.sound_count++;
+}
+
+// Look up a sound id by name (resolve once, then use play_sound_id)
+int find_sound(const char* name) {
+    for (int i = 0; i < audio.sound_count; i++) {
+        if (strcmp(audio.sounds[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// =============================================================================
+// LOCK-FREE COMMAND QUEUE (bounded, multi-producer / single-consumer)
+// =============================================================================
+
+// Push a command; returns 0 on success, -1 if the queue is full
+static int push_audio_command(const AudioCommand* cmd) {
+    for (;;) {
+        int pos = SDL_AtomicGet(&audio.queue_head);
+        AudioQueueSlot* slot = &audio.queue[pos & (AUDIO_QUEUE_SIZE - 1)];
+        int diff = SDL_AtomicGet(&slot->sequence) - pos;
+
+        if (diff == 0) {
+            // Slot is free for this position: claim it
+            if (SDL_AtomicCAS(&audio.queue_head, pos, pos + 1)) {
+                slot->command = *cmd;
+                SDL_AtomicSet(&slot->sequence, pos + 1);  // Publish
+                return 0;
+            }
+        } else if (diff < 0) {
+            return -1;  // Consumer has not caught up: queue full
+        }
+        // Another producer claimed the slot first, retry
+    }
+}
+
+// Pop a command (audio control thread only); returns 0 if empty
+static int pop_audio_command(AudioCommand* cmd) {
+    int pos = audio.queue_tail;
+    AudioQueueSlot* slot = &audio.queue[pos & (AUDIO_QUEUE_SIZE - 1)];
+
+    if (SDL_AtomicGet(&slot->sequence) != pos + 1) return 0;
+
+    *cmd = slot->command;
+    SDL_AtomicSet(&slot->sequence, pos + AUDIO_QUEUE_SIZE);  // Release slot
+    audio.queue_tail = pos + 1;
+    return 1;
+}
+
+// Queue an effect by id. Never blocks; returns -1 if the command was dropped.
+int play_sound_id(int sound, int priority, int volume) {
+    if (!audio.opened || sound < 0 || sound >= audio.sound_count) return -1;
+
+    AudioCommand cmd = {AUDIO_CMD_PLAY, sound, priority, volume};
+    if (push_audio_command(&cmd) != 0) {
+        SDL_AtomicAdd(&audio.queue_overflows, 1);
+        return -1;
+    }
+    SDL_SemPost(audio.wake);
+    return 0;
+}
+
+// Queue an effect by name with its default priority
+int play_sound(const char* name) {
+    int sound = find_sound(name);
+    if (sound < 0) return -1;
+    return play_sound_id(sound, audio.sounds[sound].priority, MIX_MAX_VOLUME);
+}
+
+// Queue a request to silence every effect
+void stop_all_sounds(void) {
+    if (!audio.opened) return;
+
+    AudioCommand cmd = {AUDIO_CMD_STOP_ALL, -1, 0, 0};
+    if (push_audio_command(&cmd) == 0) {
+        SDL_SemPost(audio.wake);
+    }
+}
+
+// =============================================================================
+// VOICE ALLOCATION (audio control thread)
+// =============================================================================
+
+// Find a voice for a new sound: a free one, or the weakest one if it is
+// not more important than the new sound. Returns -1 if nothing can be used.
+static int allocate_voice(int priority) {
+    int victim = -1;
+
+    for (int i = 0; i < AUDIO_VOICES; i++) {
+        if (!Mix_Playing(i)) return i;
+
+        Voice* v = &audio.voices[i];
+        if (v->priority > priority) continue;
+        if (victim < 0 ||
+            v->priority < audio.voices[victim].priority ||
+            (v->priority == audio.voices[victim].priority &&
+             v->start_tick < audio.voices[victim].start_tick)) {
+            victim = i;
+        }
+    }
+
+    if (victim >= 0) {
+        Mix_HaltChannel(victim);
+        audio.stolen++;
+    }
+    return victim;
+}
+
+// Apply one command
+static void execute_audio_command(const AudioCommand* cmd) {
+    switch (cmd->type) {
+        case AUDIO_CMD_PLAY: {
+            int voice = allocate_voice(cmd->priority);
+            if (voice < 0) {
+                audio.dropped++;
+                return;
+            }
+            Mix_Volume(voice, cmd->volume);
+            // Count the voice first: a very short effect may finish (and be
+            // uncounted) before Mix_PlayChannel returns
+            SDL_AtomicAdd(&audio.active_voices, 1);
+            if (Mix_PlayChannel(voice, audio.sounds[cmd->sound].chunk, 0) < 0) {
+                SDL_AtomicAdd(&audio.active_voices, -1);
+                audio.dropped++;
+                return;
+            }
+            audio.voices[voice].sound = cmd->sound;
+            audio.voices[voice].priority = cmd->priority;
+            audio.voices[voice].start_tick = SDL_GetTicks();
+            audio.played++;
+            break;
+        }
+
+        case AUDIO_CMD_STOP_ALL:
+            Mix_HaltChannel(-1);
+            for (int i = 0; i < AUDIO_VOICES; i++) {
+                audio.voices[i].sound = -1;
+                audio.voices[i].priority = -1;
+            }
+            break;
+    }
+}
+
+static int audio_command_thread(void* data) {
+    (void)data;
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    while (!SDL_AtomicGet(&audio.quit)) {
+        SDL_SemWait(audio.wake);
+
+        AudioCommand cmd;
+        while (pop_audio_command(&cmd)) {
+            execute_audio_command(&cmd);
+        }
+    }
+    return 0;
+}
+
+// Number of voices currently playing an effect
+int get_active_voice_count(void) {
+    if (!audio.opened) return 0;
+    return SDL_AtomicGet(&audio.active_voices);
+}
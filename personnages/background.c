@@ -1,67 +1,447 @@
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include "header.h"
 
+// =============================================================================
+// BACKGROUND - parallax layers drawn from tiles, plus background music
+// =============================================================================
+//
+// Every layer is cut into BACKGROUND_TILE_SIZE tiles. Only tiles that touch
+// the viewport are drawn, and they are uploaded on first use into a small
+// per-layer cache, so GPU memory depends on the window size rather than on
+// the size of the layer. Layers can also come from one file per tile, in
+// which case nothing but the visible tiles is ever loaded. Tile files are
+// decoded on the job workers; until a tile is resident its place is filled
+// with the average color of the layer's last uploaded tile.
+//
+// Tiles cut from one image carry a one pixel border taken from their
+// neighbours (wrapping around for repeating layers), so linear filtering at
+// sub-pixel positions blends across tiles and no seams show. A tile file
+// only knows its own pixels, so those layers are drawn with nearest
+// filtering instead.
+
+#define TILE_TEXTURE_SIZE (BACKGROUND_TILE_SIZE + 2)
+
 // Global background instance
-Background background = {NULL, {0, 0, 0, 0}, 0, 0, NULL, 32};
+Background background = {.music_volume = 32};
 
-// Initialize the background by loading an image
-int init_background(SDL_Renderer* renderer, const char* image_path) {
-    printf("Loading background image: %s\n", image_path);
-    
-    // Load the image as a surface
-    SDL_Surface* surface = IMG_Load(image_path);
+// Staging buffer for one tile upload (ARGB8888 with border)
+static Uint32 tile_pixels[TILE_TEXTURE_SIZE * TILE_TEXTURE_SIZE];
+
+// Tile files being decoded on the job workers
+static BackgroundTileLoad tile_loads[BACKGROUND_TILE_LOADS];
+static JobCounter tile_counter;
+
+// Reserve and reset the next layer slot
+static BackgroundLayer* new_layer(float speed_x, float speed_y, int wrap_x, int wrap_y) {
+    if (background.layer_count >= BACKGROUND_MAX_LAYERS) {
+        printf("Error: Maximum background layers limit reached (%d)\n", BACKGROUND_MAX_LAYERS);
+        return NULL;
+    }
+
+    BackgroundLayer* layer = &background.layers[background.layer_count];
+    memset(layer, 0, sizeof(*layer));
+    layer->speed_x = speed_x;
+    layer->speed_y = speed_y;
+    layer->wrap_x = wrap_x;
+    layer->wrap_y = wrap_y;
+    for (int i = 0; i < BACKGROUND_TILE_CACHE; i++) {
+        layer->tiles[i].col = -1;
+        layer->tiles[i].row = -1;
+    }
+    return layer;
+}
+
+// Finish a layer once its size is known
+static int commit_layer(BackgroundLayer* layer, int width, int height) {
+    layer->width = width;
+    layer->height = height;
+    layer->cols = (width + BACKGROUND_TILE_SIZE - 1) / BACKGROUND_TILE_SIZE;
+    layer->rows = (height + BACKGROUND_TILE_SIZE - 1) / BACKGROUND_TILE_SIZE;
+
+    if (background.layer_count == 0) {
+        background.width = width;
+        background.height = height;
+    }
+    return background.layer_count++;
+}
+
+// Add a layer from a single image. The decoded image stays in memory and
+// tiles are uploaded from it as they come into view. Returns the layer index.
+int add_background_layer(const char* image_path, float speed_x, float speed_y, int wrap_x, int wrap_y) {
+    BackgroundLayer* layer = new_layer(speed_x, speed_y, wrap_x, wrap_y);
+    if (!layer) return -1;
+
+    SDL_Surface* surface = load_image_surface(image_path);
     if (!surface) {
-        printf("Failed to load background image: %s\n", IMG_GetError());
+        printf("Failed to load background layer '%s': %s\n", image_path, IMG_GetError());
         return -1;
     }
-    
-    // Store original dimensions
-    background.width = surface->w;
-    background.height = surface->h;
-    printf("Background image size: %dx%d\n", background.width, background.height);
-    
-    // Create texture from surface
-    background.texture = SDL_CreateTextureFromSurface(renderer, surface);
+
+    // Tiles are copied out pixel by pixel, so use one known format
+    layer->source = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
     SDL_FreeSurface(surface);
-    
-    if (!background.texture) {
-        printf("Failed to create texture: %s\n", SDL_GetError());
+    if (!layer->source) {
+        printf("Failed to convert background layer '%s': %s\n", image_path, SDL_GetError());
         return -1;
     }
-    
-    // Set destination rectangle (where to draw on screen)
-    // By default, draw at position (0, 0) with original size
-    background.dest_rect.x = 0;
-    background.dest_rect.y = 0;
-    background.dest_rect.w = background.width;
-    background.dest_rect.h = background.height;
-    
+
+    printf("Background layer %d: '%s' %dx%d (parallax %.2f, %.2f)\n", background.layer_count,
+           image_path, layer->source->w, layer->source->h, speed_x, speed_y);
+    return commit_layer(layer, layer->source->w, layer->source->h);
+}
+
+// Add a layer stored as one image per tile, named by 'tile_pattern' with the
+// column and row (e.g. "level/tile_%d_%d.png"). Tiles are loaded only when
+// visible. Returns the layer index.
+int add_background_tiled_layer(const char* tile_pattern, int width, int height,
+                               float speed_x, float speed_y, int wrap_x, int wrap_y) {
+    if (width <= 0 || height <= 0) return -1;
+
+    BackgroundLayer* layer = new_layer(speed_x, speed_y, wrap_x, wrap_y);
+    if (!layer) return -1;
+
+    strncpy(layer->tile_pattern, tile_pattern, sizeof(layer->tile_pattern) - 1);
+    layer->tile_pattern[sizeof(layer->tile_pattern) - 1] = '\0';
+
+    printf("Background layer %d: tiles '%s' %dx%d (parallax %.2f, %.2f)\n", background.layer_count,
+           tile_pattern, width, height, speed_x, speed_y);
+    return commit_layer(layer, width, height);
+}
+
+// Set the automatic scroll speed of a layer
+void set_background_layer_scroll(int layer, float pixels_per_second_x, float pixels_per_second_y) {
+    if (layer < 0 || layer >= background.layer_count) return;
+    background.layers[layer].scroll_x = pixels_per_second_x;
+    background.layers[layer].scroll_y = pixels_per_second_y;
+}
+
+// Move the camera; each layer follows it at its own parallax factor
+void set_background_camera(float x, float y) {
+    background.camera_x = x;
+    background.camera_y = y;
+}
+
+// Initialize the background by loading an image (fixed, non-repeating layer)
+int init_background(SDL_Renderer* renderer, const char* image_path) {
+    (void)renderer;  // Tiles are uploaded on first draw
+    printf("Loading background image: %s\n", image_path);
+
+    if (add_background_layer(image_path, 0.0f, 0.0f, 0, 0) < 0) {
+        return -1;
+    }
+    printf("Background image size: %dx%d\n", background.width, background.height);
     printf("Background initialized successfully\n");
     return 0;
 }
 
+// -----------------------------------------------------------------------------
+// Tile cache
+// -----------------------------------------------------------------------------
+
+// Wrap (repeating layers) or clamp a coordinate into [0, size)
+static int wrap_or_clamp(int value, int size, int wrap) {
+    if (wrap) {
+        value %= size;
+        return value < 0 ? value + size : value;
+    }
+    if (value < 0) return 0;
+    if (value >= size) return size - 1;
+    return value;
+}
+
+// Copy a tile and its one pixel border from the layer image
+static int stage_tile_from_source(const BackgroundLayer* layer, int col, int row) {
+    const SDL_Surface* src = layer->source;
+    int x0 = col * BACKGROUND_TILE_SIZE - 1;
+    int y0 = row * BACKGROUND_TILE_SIZE - 1;
+
+    for (int y = 0; y < TILE_TEXTURE_SIZE; y++) {
+        int sy = wrap_or_clamp(y0 + y, src->h, layer->wrap_y);
+        const Uint32* line = (const Uint32*)((const Uint8*)src->pixels + sy * src->pitch);
+        Uint32* dst = &tile_pixels[y * TILE_TEXTURE_SIZE];
+        for (int x = 0; x < TILE_TEXTURE_SIZE; x++) {
+            dst[x] = line[wrap_or_clamp(x0 + x, src->w, layer->wrap_x)];
+        }
+    }
+    return 0;
+}
+
+// Worker side: decode one tile file
+static void decode_tile(void* data) {
+    BackgroundTileLoad* load = (BackgroundTileLoad*)data;
+    load->surface = IMG_Load(load->path);
+    SDL_AtomicSet(&load->done, 1);
+}
+
+// Copy a decoded tile file; the border repeats the tile's own edge pixels
+// (the neighbours are separate files that may not be loaded)
+static int stage_tile_from_file(SDL_Surface* loaded) {
+    // Converted into a pooled surface: streamed tiles all share one size
+    SDL_Surface* surface = acquire_scratch_surface(loaded->w, loaded->h);
+    if (!surface) return -1;
+    SDL_SetSurfaceBlendMode(loaded, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(loaded, NULL, surface, NULL);
+
+    for (int y = 0; y < TILE_TEXTURE_SIZE; y++) {
+        int sy = wrap_or_clamp(y - 1, surface->h, 0);
+        const Uint32* line = (const Uint32*)((const Uint8*)surface->pixels + sy * surface->pitch);
+        Uint32* dst = &tile_pixels[y * TILE_TEXTURE_SIZE];
+        for (int x = 0; x < TILE_TEXTURE_SIZE; x++) {
+            dst[x] = line[wrap_or_clamp(x - 1, surface->w, 0)];
+        }
+    }
+    release_scratch_surface(surface);
+    return 0;
+}
+
+// Average color of the staged tile (sampled every 8th pixel)
+static Color staged_tile_average(void) {
+    Uint32 r = 0, g = 0, b = 0, a = 0, count = 0;
+    for (int y = 1; y < TILE_TEXTURE_SIZE - 1; y += 8) {
+        for (int x = 1; x < TILE_TEXTURE_SIZE - 1; x += 8) {
+            Uint32 p = tile_pixels[y * TILE_TEXTURE_SIZE + x];
+            a += p >> 24;
+            r += (p >> 16) & 0xFF;
+            g += (p >> 8) & 0xFF;
+            b += p & 0xFF;
+            count++;
+        }
+    }
+    return (Color){(Uint8)(r / count), (Uint8)(g / count), (Uint8)(b / count), (Uint8)(a / count)};
+}
+
+// Decoded surface of a tile file, or NULL while it is still decoding (the
+// decode is started on the first request). A finished load is handed over
+// once; the caller frees the surface.
+static SDL_Surface* take_tile_file(const BackgroundLayer* layer, int col, int row) {
+    int index = (int)(layer - background.layers);
+    BackgroundTileLoad* free_slot = NULL;
+
+    for (int i = 0; i < BACKGROUND_TILE_LOADS; i++) {
+        BackgroundTileLoad* load = &tile_loads[i];
+        if (load->active && load->layer == index && load->col == col && load->row == row) {
+            load->requested = background.frame;
+            if (load->failed || !SDL_AtomicGet(&load->done)) return NULL;
+
+            SDL_Surface* surface = load->surface;
+            load->surface = NULL;
+            if (!surface) {
+                printf("Failed to load background tile '%s'\n", load->path);
+                load->failed = 1;
+                return NULL;
+            }
+            load->active = 0;
+            return surface;
+        }
+        // A finished (or failed) load nobody asked for this frame gives its
+        // slot up: the tile scrolled out of view before it was used
+        if (!free_slot && (!load->active ||
+                           (SDL_AtomicGet(&load->done) && load->requested != background.frame))) {
+            free_slot = load;
+        }
+    }
+    if (!free_slot) return NULL;   // Every slot busy: asked again next frame
+
+    if (free_slot->surface) SDL_FreeSurface(free_slot->surface);
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->active = 1;
+    free_slot->layer = index;
+    free_slot->col = col;
+    free_slot->row = row;
+    free_slot->requested = background.frame;
+    snprintf(free_slot->path, sizeof(free_slot->path), layer->tile_pattern, col, row);
+
+    Job job = {decode_tile, free_slot, NULL};
+    run_jobs(&job, 1, &tile_counter);
+    return NULL;
+}
+
+// Find a tile in the cache, uploading it (and evicting the least recently
+// used one) if needed. Returns NULL if the tile is not resident yet.
+static BackgroundTile* get_tile(SDL_Renderer* renderer, BackgroundLayer* layer, int col, int row) {
+    BackgroundTile* victim = NULL;
+
+    for (int i = 0; i < BACKGROUND_TILE_CACHE; i++) {
+        BackgroundTile* tile = &layer->tiles[i];
+        if (tile->col == col && tile->row == row) {
+            tile->last_used = background.frame;
+            return tile;
+        }
+        // Prefer a free slot, otherwise the least recently used tile
+        if (tile->col < 0) {
+            if (!victim || victim->col >= 0) victim = tile;
+        } else if (!victim || (victim->col >= 0 && tile->last_used < victim->last_used)) {
+            victim = tile;
+        }
+    }
+
+    // Every slot is already on screen this frame: the cache is too small
+    if (victim->col >= 0 && victim->last_used == background.frame) return NULL;
+
+    int staged;
+    if (layer->source) {
+        staged = stage_tile_from_source(layer, col, row);
+    } else {
+        SDL_Surface* loaded = take_tile_file(layer, col, row);
+        if (!loaded) return NULL;
+        staged = stage_tile_from_file(loaded);
+        SDL_FreeSurface(loaded);
+        if (staged == 0) layer->placeholder = staged_tile_average();
+    }
+    if (staged != 0) return NULL;
+
+    if (!victim->texture) {
+        victim->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_STATIC,
+                                            TILE_TEXTURE_SIZE, TILE_TEXTURE_SIZE);
+        if (!victim->texture) {
+            printf("Failed to create background tile: %s\n", SDL_GetError());
+            return NULL;
+        }
+        SDL_SetTextureBlendMode(victim->texture, SDL_BLENDMODE_BLEND);
+        // Separate tile files have no neighbour pixels in their border
+        if (!layer->source) SDL_SetTextureScaleMode(victim->texture, SDL_ScaleModeNearest);
+    }
+    SDL_UpdateTexture(victim->texture, NULL, tile_pixels, TILE_TEXTURE_SIZE * (int)sizeof(Uint32));
+
+    if (victim->col >= 0) background.tile_evictions++;
+    background.tile_uploads++;
+    victim->col = col;
+    victim->row = row;
+    victim->last_used = background.frame;
+    return victim;
+}
+
+// -----------------------------------------------------------------------------
+// Drawing / update
+// -----------------------------------------------------------------------------
+
+// Queue the visible tiles of one layer
+static void draw_layer(SDL_Renderer* renderer, BackgroundLayer* layer) {
+    // Layer origin on screen, kept within one period for repeating axes
+    float origin_x = -(background.camera_x * layer->speed_x + layer->offset_x);
+    float origin_y = -(background.camera_y * layer->speed_y + layer->offset_y);
+    if (layer->wrap_x) origin_x -= floorf(origin_x / layer->width) * layer->width;
+    if (layer->wrap_y) origin_y -= floorf(origin_y / layer->height) * layer->height;
+
+    // Copies of the layer that can touch the viewport
+    int first_rep_x = layer->wrap_x ? -1 : 0;
+    int last_rep_x = layer->wrap_x ? (int)((SCREEN_WIDTH - origin_x) / layer->width) : 0;
+    int first_rep_y = layer->wrap_y ? -1 : 0;
+    int last_rep_y = layer->wrap_y ? (int)((SCREEN_HEIGHT - origin_y) / layer->height) : 0;
+
+    for (int rep_y = first_rep_y; rep_y <= last_rep_y; rep_y++) {
+        float base_y = origin_y + (float)rep_y * layer->height;
+        int row0 = (int)floorf(-base_y / BACKGROUND_TILE_SIZE);
+        int row1 = (int)floorf((SCREEN_HEIGHT - base_y) / BACKGROUND_TILE_SIZE);
+        if (row0 < 0) row0 = 0;
+        if (row1 > layer->rows - 1) row1 = layer->rows - 1;
+
+        for (int rep_x = first_rep_x; rep_x <= last_rep_x; rep_x++) {
+            float base_x = origin_x + (float)rep_x * layer->width;
+            int col0 = (int)floorf(-base_x / BACKGROUND_TILE_SIZE);
+            int col1 = (int)floorf((SCREEN_WIDTH - base_x) / BACKGROUND_TILE_SIZE);
+            if (col0 < 0) col0 = 0;
+            if (col1 > layer->cols - 1) col1 = layer->cols - 1;
+
+            for (int row = row0; row <= row1; row++) {
+                for (int col = col0; col <= col1; col++) {
+                    BackgroundTile* tile = get_tile(renderer, layer, col, row);
+
+                    // Edge tiles of a layer may be partial
+                    int tw = layer->width - col * BACKGROUND_TILE_SIZE;
+                    int th = layer->height - row * BACKGROUND_TILE_SIZE;
+                    if (tw > BACKGROUND_TILE_SIZE) tw = BACKGROUND_TILE_SIZE;
+                    if (th > BACKGROUND_TILE_SIZE) th = BACKGROUND_TILE_SIZE;
+
+                    // Neighbouring tiles share exact float edges
+                    SDL_FRect dest = {base_x + (float)(col * BACKGROUND_TILE_SIZE),
+                                      base_y + (float)(row * BACKGROUND_TILE_SIZE),
+                                      (float)tw, (float)th};
+                    if (!tile) {
+                        // Still decoding: fill the hole until the tile is resident
+                        if (!layer->source && layer->placeholder.a > 0) {
+                            SDL_Rect hole = {(int)floorf(dest.x), (int)floorf(dest.y), tw + 1, th + 1};
+                            queue_fill_rect(&hole, layer->placeholder);
+                            background.tiles_pending++;
+                        }
+                        continue;
+                    }
+                    SDL_Rect src = {1, 1, tw, th};
+                    queue_texture_f(tile->texture, &src, &dest, 255);
+                    background.tiles_drawn++;
+                }
+            }
+        }
+    }
+}
+
 // Draw the background
 void draw_background(SDL_Renderer* renderer) {
-    if (background.texture) {
-        SDL_RenderCopy(renderer, background.texture, NULL, &background.dest_rect);
+    background.frame++;
+    render_queue_set_layer(RENDER_LAYER_BACKGROUND);
+    for (int i = 0; i < background.layer_count; i++) {
+        draw_layer(renderer, &background.layers[i]);
     }
 }
 
-// Update background state (if animated/scrolling)
-void update_background(void) {
-    // Add your background update logic here
-    // e.g., scrolling backgrounds, parallax effects, etc.
+// Update background state: advance automatically scrolling layers
+void update_background(double frame_seconds) {
+    for (int i = 0; i < background.layer_count; i++) {
+        BackgroundLayer* layer = &background.layers[i];
+        layer->offset_x += layer->scroll_x * (float)frame_seconds;
+        layer->offset_y += layer->scroll_y * (float)frame_seconds;
+
+        // Keep offsets small so they stay precise to a fraction of a pixel
+        if (layer->wrap_x) layer->offset_x = fmodf(layer->offset_x, (float)layer->width);
+        if (layer->wrap_y) layer->offset_y = fmodf(layer->offset_y, (float)layer->height);
+    }
 }
 
-// Clean up background resources
+// Print tile cache statistics
+void print_background_stats(void) {
+    if (background.frame == 0) return;
+    printf("Background: %d layers, avg %.1f tiles drawn per frame, %d uploads, %d evictions, "
+           "%d placeholders while decoding\n",
+           background.layer_count, (double)background.tiles_drawn / background.frame,
+           background.tile_uploads, background.tile_evictions, background.tiles_pending);
+}
+
+// Clean up background resources. Must run before shutdown_job_system(),
+// which drops queued jobs.
 void cleanup_background(void) {
-    if (background.texture) {
-        SDL_DestroyTexture(background.texture);
-        background.texture = NULL;
-        printf("Background texture destroyed\n");
+    wait_for_counter(&tile_counter);
+    for (int i = 0; i < BACKGROUND_TILE_LOADS; i++) {
+        if (tile_loads[i].surface) SDL_FreeSurface(tile_loads[i].surface);
     }
+    memset(tile_loads, 0, sizeof(tile_loads));
+
+    for (int i = 0; i < background.layer_count; i++) {
+        BackgroundLayer* layer = &background.layers[i];
+        for (int t = 0; t < BACKGROUND_TILE_CACHE; t++) {
+            if (layer->tiles[t].texture) {
+                SDL_DestroyTexture(layer->tiles[t].texture);
+                layer->tiles[t].texture = NULL;
+            }
+        }
+        if (layer->source) {
+            SDL_FreeSurface(layer->source);
+            layer->source = NULL;
+        }
+    }
+    if (background.layer_count > 0) {
+        printf("Background layers destroyed\n");
+    }
+    background.layer_count = 0;
     
     // Stop and free music
+    if (background.streaming) {
+        shutdown_music_stream();
+        background.streaming = 0;
+        printf("Background music stream closed\n");
+    }
     if (background.music) {
         Mix_HaltMusic();
         Mix_FreeMusic(background.music);
@@ -73,8 +453,20 @@ void cleanup_background(void) {
 // Initialize background music
 int init_background_music(const char* music_path, int volume) {
     printf("Loading background music: %s\n", music_path);
+    background.music_volume = volume;
+    set_observable_int(OBSERVABLE_MUSIC_VOLUME, volume);
+    
+    // Stream the track when its format can be decoded incrementally
+    if (can_stream_music(music_path) && start_music_stream() == 0) {
+        strncpy(background.music_path, music_path, sizeof(background.music_path) - 1);
+        background.music_path[sizeof(background.music_path) - 1] = '\0';
+        background.streaming = 1;
+        set_music_stream_volume(volume);
+        printf("Background music will be streamed (volume: %d/128)\n", volume);
+        return 0;
+    }
     
-    // Load music file
+    // Otherwise load the whole file
     background.music = Mix_LoadMUS(music_path);
     if (!background.music) {
         printf("Failed to load background music: %s\n", Mix_GetError());
@@ -83,7 +475,6 @@ int init_background_music(const char* music_path, int volume) {
     
     // Set volume (0-128, where 128 is max)
     // For "low volume you can hear without feeling it", use around 25-35% of max
-    background.music_volume = volume;
     Mix_VolumeMusic(background.music_volume);
     
     printf("Background music loaded successfully (volume: %d/128)\n", volume);
@@ -92,7 +483,10 @@ int init_background_music(const char* music_path, int volume) {
 
 // Play background music on loop
 void play_background_music(void) {
-    if (background.music) {
+    if (background.streaming) {
+        play_music_stream(background.music_path, 1, 0);
+        printf("Background music started (streaming, looping)\n");
+    } else if (background.music) {
         // -1 means loop forever
         if (Mix_PlayMusic(background.music, -1) == -1) {
             printf("Failed to play music: %s\n", Mix_GetError());
@@ -104,19 +498,33 @@ void play_background_music(void) {
 
 // Stop background music
 void stop_background_music(void) {
-    Mix_HaltMusic();
+    if (background.streaming) {
+        stop_music_stream();
+    } else {
+        Mix_HaltMusic();
+    }
     printf("Background music stopped\n");
 }
 
 // Pause background music
 void pause_background_music(void) {
-    Mix_PauseMusic();
+    if (background.streaming) {
+        set_music_stream_paused(1);
+    } else {
+        Mix_PauseMusic();
+    }
+    set_observable_int(OBSERVABLE_MUSIC_PAUSED, 1);
     printf("Background music paused\n");
 }
 
 // Resume background music
 void resume_background_music(void) {
-    Mix_ResumeMusic();
+    if (background.streaming) {
+        set_music_stream_paused(0);
+    } else {
+        Mix_ResumeMusic();
+    }
+    set_observable_int(OBSERVABLE_MUSIC_PAUSED, 0);
     printf("Background music resumed\n");
 }
 
@@ -126,7 +534,13 @@ void set_background_music_volume(int volume) {
     if (volume > 128) volume = 128;
     
     background.music_volume = volume;
-    Mix_VolumeMusic(background.music_volume);
+    set_observable_int(OBSERVABLE_MUSIC_VOLUME, volume);
+    if (background.streaming) {
+        // The mixer ramps to the new volume instead of jumping
+        set_music_stream_volume(volume);
+    } else {
+        Mix_VolumeMusic(background.music_volume);
+    }
     printf("Background music volume set to: %d/128 (%d%%)\n", volume, (volume * 100) / 128);
 }
 
@@ -137,10 +551,23 @@ int get_background_music_volume(void) {
 
 // Check if music is currently playing
 int is_music_playing(void) {
+    if (background.streaming) return is_music_stream_playing();
     return Mix_PlayingMusic();
 }
 
 // Check if music is paused
 int is_music_paused(void) {
+    if (background.streaming) return is_music_stream_paused();
     return Mix_PausedMusic();
 }
+
+// Switch to another track, crossfading over fade_ms when streaming
+int change_background_music(const char* music_path, int fade_ms) {
+    if (!background.streaming || !can_stream_music(music_path)) {
+        printf("Error: Cannot crossfade to '%s' (streaming unavailable)\n", music_path);
+        return -1;
+    }
+    strncpy(background.music_path, music_path, sizeof(background.music_path) - 1);
+    background.music_path[sizeof(background.music_path) - 1] = '\0';
+    return play_music_stream(background.music_path, 1, fade_ms);
+}
@@ -0,0 +1,478 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "header.h"
+
+// =============================================================================
+// BENCHMARKS - repeatable workloads run with --bench [name]
+// =============================================================================
+//
+// Each benchmark drives one subsystem through the real renderer with vsync
+// off and prints its frame time distribution. "--bench" alone runs them all.
+// Once the warm-up frames of a pass are over, frames must not allocate
+// through SDL's allocator: a benchmark whose steady state does fails (libc
+// malloc from FreeType or the driver is not counted, see arena.c).
+
+#define BENCH_MAX_FRAMES 4096
+#define BENCH_WARMUP_FRAMES 120    // Caches fill up before allocations are counted
+
+typedef struct {
+    const char* name;
+    const char* description;
+    int (*run)(SDL_Renderer* renderer);
+} Benchmark;
+
+// Frame times of the pass being measured
+static double bench_times[BENCH_MAX_FRAMES];
+static int bench_frame_count = 0;
+static Uint64 bench_frame_start = 0;
+
+// SDL heap allocations of the steady-state frames of the current benchmark
+static int bench_warm_allocations = 0;
+static int bench_steady_allocations = 0;
+
+static void bench_begin_pass(void) {
+    bench_frame_count = 0;
+    bench_warm_allocations = get_memory_stats().allocations;
+}
+
+static void bench_begin_frame(void) {
+    bench_frame_start = SDL_GetPerformanceCounter();
+}
+
+static void bench_end_frame(void) {
+    if (bench_frame_count >= BENCH_MAX_FRAMES) return;
+    bench_times[bench_frame_count++] = (double)(SDL_GetPerformanceCounter() - bench_frame_start) *
+                                       1000.0 / (double)SDL_GetPerformanceFrequency();
+    if (bench_frame_count == BENCH_WARMUP_FRAMES) {
+        bench_warm_allocations = get_memory_stats().allocations;
+    }
+}
+
+static int compare_times(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Print the distribution of the pass and return its average frame time
+static double bench_report_pass(const char* label) {
+    if (bench_frame_count == 0) return 0.0;
+
+    double sum = 0.0;
+    for (int i = 0; i < bench_frame_count; i++) sum += bench_times[i];
+    qsort(bench_times, bench_frame_count, sizeof(double), compare_times);
+
+    int allocations = 0;
+    if (bench_frame_count > BENCH_WARMUP_FRAMES) {
+        allocations = get_memory_stats().allocations - bench_warm_allocations;
+        bench_steady_allocations += allocations;
+    }
+
+    double avg = sum / bench_frame_count;
+    printf("  %-22s avg %7.3f ms | p50 %7.3f ms | p95 %7.3f ms | max %7.3f ms (%d frames, %d SDL allocs)\n",
+           label, avg, bench_times[bench_frame_count / 2],
+           bench_times[(int)(bench_frame_count * 0.95)],
+           bench_times[bench_frame_count - 1], bench_frame_count, allocations);
+    return avg;
+}
+
+// -----------------------------------------------------------------------------
+// Tilemap: scroll a 1000x1000-tile map
+// -----------------------------------------------------------------------------
+
+#define BENCH_MAP_SIZE 1000
+#define BENCH_SCROLL_FRAMES 600
+
+// Camera path shared by both passes: diagonal sweep with a vertical wobble
+static void bench_tilemap_camera(int frame) {
+    float x = frame * 40.0f;
+    float y = frame * 30.0f + sinf(frame * 0.05f) * 400.0f;
+    set_tilemap_camera(x, y < 0.0f ? 0.0f : y);
+}
+
+// Render one frame of the scroll, using the chunk cache or not
+static int bench_tilemap_frame(SDL_Renderer* renderer, int frame, int chunked) {
+    bench_tilemap_camera(frame);
+
+    // An edit every 10 frames exercises dirty chunk re-baking
+    if (frame % 10 == 0) {
+        int tx = (int)(tilemap.camera_x / tilemap.tile_size) + 5;
+        int ty = (int)(tilemap.camera_y / tilemap.tile_size) + 5;
+        set_tilemap_tile(tx, ty, (Uint16)(1 + frame % 16));
+    }
+
+    bench_begin_frame();
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    render_queue_begin(renderer);
+    if (chunked) {
+        draw_tilemap(renderer);
+    } else {
+        draw_tilemap_direct(renderer);
+    }
+    render_queue_end(renderer);
+    SDL_RenderPresent(renderer);
+    reset_frame_arena();
+    bench_end_frame();
+
+    return render_queue_get_stats().commands;
+}
+
+static int bench_tilemap(SDL_Renderer* renderer) {
+    if (init_tilemap(renderer, NULL, 32, BENCH_MAP_SIZE, BENCH_MAP_SIZE) != 0) {
+        return -1;
+    }
+
+    // Deterministic terrain, about one tile in eight left empty
+    Uint32 state = 12345u;
+    for (int y = 0; y < BENCH_MAP_SIZE; y++) {
+        for (int x = 0; x < BENCH_MAP_SIZE; x++) {
+            state = state * 1664525u + 1013904223u;
+            set_tilemap_tile(x, y, (state >> 29) == 0 ? 0 : (Uint16)(1 + (state >> 24) % 16));
+        }
+    }
+
+    long direct_commands = 0, chunk_commands = 0;
+
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_SCROLL_FRAMES; f++) {
+        direct_commands += bench_tilemap_frame(renderer, f, 0);
+    }
+    double direct_ms = bench_report_pass("per-tile copies");
+
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_SCROLL_FRAMES; f++) {
+        chunk_commands += bench_tilemap_frame(renderer, f, 1);
+    }
+    double chunk_ms = bench_report_pass("cached chunks");
+
+    printf("  draw commands per frame: %.1f per-tile vs %.1f chunked, speedup x%.2f\n",
+           (double)direct_commands / BENCH_SCROLL_FRAMES,
+           (double)chunk_commands / BENCH_SCROLL_FRAMES,
+           chunk_ms > 0.0 ? direct_ms / chunk_ms : 0.0);
+    print_tilemap_stats();
+
+    cleanup_tilemap();
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Tweens: thousands of concurrent property tweens
+// -----------------------------------------------------------------------------
+
+#define BENCH_TWEEN_TARGETS 1365     // Three tweens each, just under TWEEN_MAX
+#define BENCH_TWEEN_FRAMES 600
+
+static int bench_tweens(SDL_Renderer* renderer) {
+    (void)renderer;
+
+    // Detached round sequences: tweening them needs no drawing
+    static RoundSequence targets[BENCH_TWEEN_TARGETS];
+    for (int i = 0; i < BENCH_TWEEN_TARGETS; i++) {
+        targets[i] = (RoundSequence){.center_x = i % 1280, .center_y = i % 720, .radius = 10,
+                                     .color = create_color(255, 255, 255, 255)};
+
+        // Three properties each, with mixed curves and durations
+        float pos[4] = {(float)(1280 - i % 1280), (float)(720 - i % 720), 0, 0};
+        float col[4] = {(float)(i % 256), 80, 200, 255};
+        float rad[4] = {(float)(20 + i % 30), 0, 0, 0};
+        float seconds = 0.5f + (i % 7) * 0.25f;
+        int t[3] = {
+            tween_round_sequence(&targets[i], TWEEN_POSITION, pos, seconds, EASE_IN_OUT_QUAD),
+            tween_round_sequence(&targets[i], TWEEN_COLOR, col, seconds, EASE_LINEAR),
+            tween_round_sequence(&targets[i], TWEEN_RADIUS, rad, seconds, EASE_OUT_BACK),
+        };
+        for (int k = 0; k < 3; k++) set_tween_ping_pong(t[k], 1);
+    }
+    printf("  %d active tweens\n", get_active_tween_count());
+
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_TWEEN_FRAMES; f++) {
+        bench_begin_frame();
+        update_tweens(1.0 / 60.0);
+        bench_end_frame();
+    }
+    bench_report_pass("update_tweens");
+
+    clear_tweens();
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Particles: 100k live particles in one emitter
+// -----------------------------------------------------------------------------
+
+#define BENCH_PARTICLES 100000
+#define BENCH_PARTICLE_FRAMES 600
+
+// Keep the emitter full: every frame replaces what died
+static void bench_particle_refill(int emitter, int frame) {
+    int missing = BENCH_PARTICLES - get_live_particle_count();
+    float x = 640.0f + sinf(frame * 0.02f) * 400.0f;
+    emit_particles(emitter, x, 360.0f, missing);
+}
+
+static int bench_particles(SDL_Renderer* renderer) {
+    ParticleEmitterConfig config = {
+        .direction = 0.0f, .spread = 6.2832f, .speed_min = 50.0f, .speed_max = 400.0f,
+        .life_min = 1.0f, .life_max = 3.0f, .gravity = 200.0f, .drag = 0.5f, .size = 3.0f,
+        .blend = SDL_BLENDMODE_ADD,
+        .palette = {{255, 200, 80, 255}, {80, 160, 255, 255}},
+        .palette_size = 2
+    };
+    int emitter = create_particle_emitter("bench", BENCH_PARTICLES, &config);
+    if (emitter < 0) return -1;
+
+    // Update only, SIMD kernels then the scalar loop
+    for (int simd = 1; simd >= 0; simd--) {
+        set_particle_simd(simd);
+        clear_particles(emitter);
+        bench_begin_pass();
+        for (int f = 0; f < BENCH_PARTICLE_FRAMES; f++) {
+            bench_particle_refill(emitter, f);
+            bench_begin_frame();
+            update_particles(1.0 / 60.0);
+            bench_end_frame();
+        }
+        bench_report_pass(simd ? "update (SIMD)" : "update (scalar)");
+    }
+    set_particle_simd(1);
+
+    // Full frames: update, build the mesh, one geometry call
+    clear_particles(emitter);
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_PARTICLE_FRAMES; f++) {
+        bench_particle_refill(emitter, f);
+        bench_begin_frame();
+        update_particles(1.0 / 60.0);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        render_queue_begin(renderer);
+        draw_particles();
+        render_queue_end(renderer);
+        SDL_RenderPresent(renderer);
+        reset_frame_arena();
+        bench_end_frame();
+    }
+    double frame_ms = bench_report_pass("update + draw");
+    printf("  %d live particles, %d draw call(s) per frame, %s 60 FPS budget\n",
+           get_live_particle_count(), render_queue_get_stats().submissions,
+           frame_ms <= 1000.0 / 60.0 ? "within" : "over");
+
+    destroy_particle_emitter(emitter);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Collisions: thousands of moving boxes and circles
+// -----------------------------------------------------------------------------
+
+#define BENCH_COLLIDERS 4000
+#define BENCH_COLLISION_FRAMES 600
+
+typedef struct {
+    float x, y, vx, vy, size;
+    int circle;
+} BenchBody;
+
+// Brute-force contact count (every pair), used to check the broadphase
+static int bench_count_contacts_brute(const BenchBody* bodies, int count) {
+    int contacts = 0;
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count; j++) {
+            const BenchBody* a = &bodies[i];
+            const BenchBody* b = &bodies[j];
+            if (a->circle && b->circle) {
+                float dx = a->x - b->x, dy = a->y - b->y, r = a->size + b->size;
+                contacts += dx * dx + dy * dy <= r * r;
+            } else if (!a->circle && !b->circle) {
+                contacts += a->x <= b->x + b->size && b->x <= a->x + a->size &&
+                            a->y <= b->y + b->size && b->y <= a->y + a->size;
+            } else {
+                const BenchBody* c = a->circle ? a : b;
+                const BenchBody* r = a->circle ? b : a;
+                float px = c->x < r->x ? r->x : (c->x > r->x + r->size ? r->x + r->size : c->x);
+                float py = c->y < r->y ? r->y : (c->y > r->y + r->size ? r->y + r->size : c->y);
+                contacts += (c->x - px) * (c->x - px) + (c->y - py) * (c->y - py) <= c->size * c->size;
+            }
+        }
+    }
+    return contacts;
+}
+
+static int bench_collisions(SDL_Renderer* renderer) {
+    (void)renderer;
+
+    static BenchBody bodies[BENCH_COLLIDERS];
+    static int ids[BENCH_COLLIDERS];
+    Uint32 state = 777u;
+    for (int i = 0; i < BENCH_COLLIDERS; i++) {
+        BenchBody* b = &bodies[i];
+        state = state * 1664525u + 1013904223u;
+        b->x = (float)(state % 1280);
+        state = state * 1664525u + 1013904223u;
+        b->y = (float)(state % 720);
+        b->vx = (float)((int)(state >> 8) % 200 - 100);
+        b->vy = (float)((int)(state >> 16) % 200 - 100);
+        b->size = 3.0f + (float)(state >> 28);
+        b->circle = i % 3 == 0;
+        ids[i] = b->circle ? add_circle_collider(b->x, b->y, b->size)
+                           : add_box_collider(b->x, b->y, b->size, b->size);
+        if (ids[i] < 0) return -1;
+    }
+
+    // Correctness check against the O(n^2) answer
+    update_collisions();
+    Uint64 start = SDL_GetPerformanceCounter();
+    int expected = bench_count_contacts_brute(bodies, BENCH_COLLIDERS);
+    double brute_ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 /
+                      (double)SDL_GetPerformanceFrequency();
+    int found = get_collision_stats().contacts;
+    printf("  contacts: %d found, %d expected (brute force %.3f ms)\n", found, expected, brute_ms);
+
+    long events = 0;
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_COLLISION_FRAMES; f++) {
+        for (int i = 0; i < BENCH_COLLIDERS; i++) {
+            BenchBody* b = &bodies[i];
+            b->x += b->vx / 60.0f;
+            b->y += b->vy / 60.0f;
+            if (b->x < 0.0f || b->x > 1280.0f) b->vx = -b->vx;
+            if (b->y < 0.0f || b->y > 720.0f) b->vy = -b->vy;
+            if (b->circle) set_circle_collider(ids[i], b->x, b->y, b->size);
+            else set_box_collider(ids[i], b->x, b->y, b->size, b->size);
+        }
+        bench_begin_frame();
+        update_collisions();
+        bench_end_frame();
+        events += get_collision_stats().events;
+    }
+    bench_report_pass("update_collisions");
+    printf("  %.1f contact events per frame\n", (double)events / BENCH_COLLISION_FRAMES);
+    print_collision_stats();
+
+    cleanup_collisions();
+    return found == expected ? 0 : -1;
+}
+
+// -----------------------------------------------------------------------------
+// Bindings: a dashboard of bound values, few of which change per frame
+// -----------------------------------------------------------------------------
+
+#define BENCH_BOUND_VALUES 500
+#define BENCH_BINDING_FRAMES 600
+#define BENCH_CHANGES_PER_FRAME 8
+
+static int bench_bindings(SDL_Renderer* renderer) {
+    (void)renderer;
+
+    // Detached round sequences stand in for the dashboard widgets
+    static RoundSequence widgets[BENCH_BOUND_VALUES];
+    static int values[BENCH_BOUND_VALUES];
+    static int ids[BENCH_BOUND_VALUES];
+    cleanup_bindings();
+    memset(widgets, 0, sizeof(widgets));
+    memset(values, 0, sizeof(values));
+    for (int i = 0; i < BENCH_BOUND_VALUES; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "bench_%d", i);
+        ids[i] = create_observable(name, 0);
+        if (ids[i] < 0 || bind_round_sequence_text(ids[i], &widgets[i], NULL) < 0) return -1;
+    }
+    flush_bindings();
+
+    // Polling: every widget formats its value every frame
+    Uint32 state = 99u;
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_BINDING_FRAMES; f++) {
+        for (int c = 0; c < BENCH_CHANGES_PER_FRAME; c++) {
+            state = state * 1664525u + 1013904223u;
+            values[(state >> 8) % BENCH_BOUND_VALUES]++;
+        }
+        bench_begin_frame();
+        for (int i = 0; i < BENCH_BOUND_VALUES; i++) {
+            char text[16];
+            snprintf(text, sizeof(text), "%d", values[i]);
+            update_round_sequence_text(&widgets[i], text);
+        }
+        bench_end_frame();
+    }
+    bench_report_pass("polling");
+
+    // Bindings: only the changed values reach their widgets
+    state = 99u;
+    bench_begin_pass();
+    for (int f = 0; f < BENCH_BINDING_FRAMES; f++) {
+        bench_begin_frame();
+        for (int c = 0; c < BENCH_CHANGES_PER_FRAME; c++) {
+            state = state * 1664525u + 1013904223u;
+            int i = (state >> 8) % BENCH_BOUND_VALUES;
+            values[i]++;
+            set_observable_int(ids[i], values[i]);
+        }
+        flush_bindings();
+        bench_end_frame();
+    }
+    bench_report_pass("bindings");
+
+    // Both passes must leave the widgets showing the final values
+    int wrong = 0;
+    for (int i = 0; i < BENCH_BOUND_VALUES; i++) {
+        char text[16];
+        snprintf(text, sizeof(text), "%d", values[i]);
+        wrong += strcmp(widgets[i].text_content, text) != 0;
+    }
+    BindingStats stats = get_binding_stats();
+    printf("  %d bound values, %d changes, %d propagated, %d stale widgets\n",
+           BENCH_BOUND_VALUES, stats.changes, stats.flushes, wrong);
+
+    cleanup_bindings();
+    return wrong == 0 ? 0 : -1;
+}
+
+// -----------------------------------------------------------------------------
+// Driver
+// -----------------------------------------------------------------------------
+
+static const Benchmark benchmarks[] = {
+    {"tilemap", "Scroll a 1000x1000-tile map (chunk cache vs per-tile)", bench_tilemap},
+    {"collisions", "Sweep-and-prune over 4000 moving boxes and circles", bench_collisions},
+    {"particles", "Simulate and draw 100k particles (SIMD vs scalar update)", bench_particles},
+    {"tweens", "Update ~4000 ping-pong tweens on round sequences", bench_tweens},
+    {"bindings", "500 bound values, a few changing per frame (polling vs bindings)", bench_bindings},
+};
+
+#define BENCHMARK_COUNT (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+// Run one benchmark by name, or all of them for "all". Returns 0 on success.
+int run_benchmarks(SDL_Renderer* renderer, const char* name) {
+    SDL_RenderSetVSync(renderer, 0);
+
+    int ran = 0, failed = 0;
+    for (int i = 0; i < BENCHMARK_COUNT; i++) {
+        if (strcmp(name, "all") != 0 && strcmp(name, benchmarks[i].name) != 0) continue;
+
+        printf("\n=== BENCHMARK: %s - %s ===\n", benchmarks[i].name, benchmarks[i].description);
+        bench_steady_allocations = 0;
+        int result = benchmarks[i].run(renderer);
+        if (bench_steady_allocations > 0) {
+            printf("Error: %d SDL heap allocations in steady-state frames\n", bench_steady_allocations);
+            result = -1;
+        }
+        if (result != 0) {
+            printf("Benchmark '%s' failed\n", benchmarks[i].name);
+            failed++;
+        }
+        ran++;
+    }
+
+    if (ran == 0) {
+        printf("Unknown benchmark '%s'. Available:", name);
+        for (int i = 0; i < BENCHMARK_COUNT; i++) printf(" %s", benchmarks[i].name);
+        printf("\n");
+        return -1;
+    }
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// BINDING - observable values and widgets bound to them
+// =============================================================================
+//
+// State that the UI shows (music volume, pause state, input text, focus) is
+// published as observables. Widgets subscribe once, with a formatter that
+// turns the value into their text, instead of reading the state every frame.
+//
+// Writing an observable only records the change: the value is compared with
+// the current one and, if it differs, the observable is queued. Once per
+// frame flush_bindings() walks the queue and updates the subscribers, so
+// several writes in the same frame cost a single update with the latest
+// value, and a frame where nothing changed costs nothing at all, however many
+// values are bound. Main thread only.
+
+static Observable observables[BINDING_MAX_OBSERVABLES];
+static int observable_count = 0;
+static Binding bindings[BINDING_MAX_BINDINGS];
+
+// Observables changed since the last flush. Subscribers may change values
+// while a flush runs (those go out next frame), hence the double size.
+static int pending[BINDING_MAX_OBSERVABLES * 2];
+static int pending_count = 0;
+
+static BindingStats stats;
+
+static Observable* get_observable(int obs) {
+    if (obs < 0 || obs >= observable_count || !observables[obs].active) return NULL;
+    return &observables[obs];
+}
+
+static void queue_observable(int obs) {
+    stats.changes++;
+    if (observables[obs].pending) return;
+    observables[obs].pending = 1;
+    pending[pending_count++] = obs;
+}
+
+// Create the built-in observables (OBSERVABLE_* indices)
+void init_bindings(void) {
+    cleanup_bindings();
+    create_observable("music_volume", 0);
+    create_observable("music_paused", 0);
+    create_observable("input_text", 1);
+    create_observable("focused_input", 0);
+    observables[OBSERVABLE_FOCUS].value = -1;
+}
+
+// Create an integer or text observable. Returns its index, or -1.
+int create_observable(const char* name, int is_text) {
+    if (observable_count >= BINDING_MAX_OBSERVABLES) {
+        printf("Error: Maximum observables limit reached (%d)\n", BINDING_MAX_OBSERVABLES);
+        return -1;
+    }
+    Observable* obs = &observables[observable_count];
+    memset(obs, 0, sizeof(*obs));
+    strncpy(obs->name, name, sizeof(obs->name) - 1);
+    obs->active = 1;
+    obs->is_text = is_text;
+    obs->first_binding = -1;
+    return observable_count++;
+}
+
+// Find an observable by name (-1 if missing)
+int find_observable(const char* name) {
+    for (int i = 0; i < observable_count; i++) {
+        if (observables[i].active && strcmp(observables[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// Change an integer observable (no-op if the value is the same)
+void set_observable_int(int obs, int value) {
+    Observable* o = get_observable(obs);
+    if (!o || o->is_text || o->value == value) return;
+    o->value = value;
+    queue_observable(obs);
+}
+
+// Change a text observable (no-op if the text is the same)
+void set_observable_text(int obs, const char* text) {
+    Observable* o = get_observable(obs);
+    if (!o || !o->is_text) return;
+    if (strncmp(o->text, text, sizeof(o->text) - 1) == 0) return;
+    strncpy(o->text, text, sizeof(o->text) - 1);
+    o->text[sizeof(o->text) - 1] = '\0';
+    queue_observable(obs);
+}
+
+int get_observable_int(int obs) {
+    Observable* o = get_observable(obs);
+    return o ? o->value : 0;
+}
+
+const char* get_observable_text(int obs) {
+    Observable* o = get_observable(obs);
+    return o ? o->text : "";
+}
+
+// -----------------------------------------------------------------------------
+// Subscriptions
+// -----------------------------------------------------------------------------
+
+// Add a subscriber. It receives the current value at the next flush.
+static int add_binding(int obs, const Binding* binding) {
+    if (!get_observable(obs)) {
+        printf("Error: Cannot bind to unknown observable %d\n", obs);
+        return -1;
+    }
+    for (int i = 0; i < BINDING_MAX_BINDINGS; i++) {
+        if (bindings[i].active) continue;
+        bindings[i] = *binding;
+        bindings[i].active = 1;
+        bindings[i].observable = obs;
+        bindings[i].next = observables[obs].first_binding;
+        observables[obs].first_binding = i;
+        if (!observables[obs].pending) {
+            observables[obs].pending = 1;
+            pending[pending_count++] = obs;
+        }
+        return i;
+    }
+    printf("Error: Maximum bindings limit reached (%d)\n", BINDING_MAX_BINDINGS);
+    return -1;
+}
+
+// Show an observable as the text of a sequence. Returns the binding index.
+int bind_sequence_text(int obs, Sequence* seq, BindingFormatter formatter) {
+    if (!seq) return -1;
+    Binding binding = {0};
+    binding.sequence = seq;
+    binding.formatter = formatter;
+    return add_binding(obs, &binding);
+}
+
+// Show an observable as the text of a round sequence
+int bind_round_sequence_text(int obs, RoundSequence* seq, BindingFormatter formatter) {
+    if (!seq) return -1;
+    Binding binding = {0};
+    binding.round = seq;
+    binding.formatter = formatter;
+    return add_binding(obs, &binding);
+}
+
+// Call a function whenever an observable changes
+int subscribe_observable(int obs, BindingCallback callback, void* data) {
+    if (!callback) return -1;
+    Binding binding = {0};
+    binding.callback = callback;
+    binding.data = data;
+    return add_binding(obs, &binding);
+}
+
+// Remove a subscription
+void unbind(int binding) {
+    if (binding < 0 || binding >= BINDING_MAX_BINDINGS || !bindings[binding].active) return;
+
+    int* link = &observables[bindings[binding].observable].first_binding;
+    while (*link >= 0 && *link != binding) link = &bindings[*link].next;
+    if (*link == binding) *link = bindings[binding].next;
+    bindings[binding].active = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Propagation
+// -----------------------------------------------------------------------------
+
+static void format_value(const Binding* binding, const Observable* obs, char* text, size_t size) {
+    if (binding->formatter) {
+        binding->formatter(obs, text, size);
+    } else if (obs->is_text) {
+        snprintf(text, size, "%s", obs->text);
+    } else {
+        snprintf(text, size, "%d", obs->value);
+    }
+}
+
+// Update the subscribers of every observable changed since the last call.
+// Run once per frame, after events and before drawing.
+void flush_bindings(void) {
+    int count = pending_count;
+    for (int i = 0; i < count; i++) {
+        Observable* obs = &observables[pending[i]];
+        obs->pending = 0;
+        stats.flushes++;
+
+        for (int b = obs->first_binding; b >= 0; b = bindings[b].next) {
+            const Binding* binding = &bindings[b];
+            char text[OBSERVABLE_TEXT_SIZE];
+            if (binding->sequence) {
+                format_value(binding, obs, text, sizeof(text));
+                update_sequence_text(binding->sequence, text);
+            } else if (binding->round) {
+                format_value(binding, obs, text, sizeof(text));
+                update_round_sequence_text(binding->round, text);
+            } else {
+                binding->callback(obs, binding->data);
+            }
+            stats.notifications++;
+        }
+    }
+
+    // Changes made by subscribers wait for the next frame
+    memmove(pending, pending + count, (size_t)(pending_count - count) * sizeof(int));
+    pending_count -= count;
+}
+
+BindingStats get_binding_stats(void) {
+    return stats;
+}
+
+void print_binding_stats(void) {
+    printf("\n=== BINDING STATS ===\n");
+    printf("Observables: %d | changes: %d | propagated: %d | subscribers updated: %d\n",
+           observable_count, stats.changes, stats.flushes, stats.notifications);
+    printf("=====================\n");
+}
+
+// Drop every observable and subscription
+void cleanup_bindings(void) {
+    memset(observables, 0, sizeof(observables));
+    memset(bindings, 0, sizeof(bindings));
+    memset(&stats, 0, sizeof(stats));
+    observable_count = 0;
+    pending_count = 0;
+}
@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// COLLISION - sweep-and-prune broadphase with box / circle narrowphase
+// =============================================================================
+//
+// Colliders are boxes (usually taken from a sequence rect) or circles (from a
+// round sequence). Their bounds are kept in arrays sorted by left edge; the
+// order barely changes between frames, so an insertion sort restores it in
+// close to linear time. The sweep then only pairs colliders whose x ranges
+// overlap, and those candidates go through the exact shape test.
+//
+// Contacts are kept as a sorted set of pair keys. Comparing this frame's set
+// with the previous one yields COLLISION_BEGIN / COLLISION_END events, so
+// callers only hear about changes.
+
+#define COLLISION_PARALLEL_BATCH 512   // Smallest slice of the sweep handed to another worker
+
+static Collider colliders[COLLISION_MAX_COLLIDERS];
+
+// Bounds of each collider slot
+static float min_x[COLLISION_MAX_COLLIDERS];
+static float min_y[COLLISION_MAX_COLLIDERS];
+static float max_x[COLLISION_MAX_COLLIDERS];
+static float max_y[COLLISION_MAX_COLLIDERS];
+
+// Active colliders sorted by min_x
+static int sweep_order[COLLISION_MAX_COLLIDERS];
+static int sweep_count = 0;
+
+// Contact pair sets (key = low id << 16 | high id), current and previous frame
+static Uint32 pair_sets[2][COLLISION_MAX_CONTACTS];
+static int pair_counts[2] = {0, 0};
+static int current_set = 0;
+
+// Contacts found by the sweep. Each carries its slot in the low bits, so
+// sorting by pair key keeps the contact point attached to its pair.
+static Uint64 found[COLLISION_MAX_CONTACTS];
+static float found_x[COLLISION_MAX_CONTACTS];
+static float found_y[COLLISION_MAX_CONTACTS];
+static SDL_atomic_t found_count;
+static SDL_atomic_t narrow_tests;
+
+static CollisionEvent events[COLLISION_MAX_CONTACTS * 2];
+static int event_count = 0;
+
+static CollisionStats stats;
+static CollisionStats total_stats;
+static int total_updates = 0;
+static int overflow_reported = 0;
+
+static int new_collider(ColliderShape shape) {
+    int id = -1;
+    for (int i = 0; i < COLLISION_MAX_COLLIDERS; i++) {
+        if (!colliders[i].active) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0) {
+        printf("Error: Maximum colliders limit reached (%d)\n", COLLISION_MAX_COLLIDERS);
+        return -1;
+    }
+
+    memset(&colliders[id], 0, sizeof(colliders[id]));
+    colliders[id].active = 1;
+    colliders[id].shape = shape;
+
+    // Appended at the end; the next insertion sort moves it into place
+    sweep_order[sweep_count++] = id;
+    return id;
+}
+
+// Recompute the bounds of a collider from its shape
+static void update_bounds(int id) {
+    const Collider* c = &colliders[id];
+    if (c->shape == COLLIDER_CIRCLE) {
+        min_x[id] = c->x - c->radius;
+        min_y[id] = c->y - c->radius;
+        max_x[id] = c->x + c->radius;
+        max_y[id] = c->y + c->radius;
+    } else {
+        min_x[id] = c->x;
+        min_y[id] = c->y;
+        max_x[id] = c->x + c->w;
+        max_y[id] = c->y + c->h;
+    }
+}
+
+// Add a box collider at (x, y) of size w x h. Returns its id, or -1.
+int add_box_collider(float x, float y, float w, float h) {
+    int id = new_collider(COLLIDER_BOX);
+    if (id >= 0) set_box_collider(id, x, y, w, h);
+    return id;
+}
+
+// Add a circle collider centered on (cx, cy). Returns its id, or -1.
+int add_circle_collider(float cx, float cy, float radius) {
+    int id = new_collider(COLLIDER_CIRCLE);
+    if (id >= 0) set_circle_collider(id, cx, cy, radius);
+    return id;
+}
+
+// Add a box collider that follows a sequence's world rect
+int add_sequence_collider(Sequence* seq) {
+    if (!seq) return -1;
+    int id = new_collider(COLLIDER_BOX);
+    if (id >= 0) {
+        colliders[id].sequence = seq;
+        colliders[id].generation = seq->generation;
+        set_box_collider(id, (float)seq->x, (float)seq->y, (float)seq->w, (float)seq->h);
+    }
+    return id;
+}
+
+// Add a circle collider that follows a round sequence
+int add_round_sequence_collider(RoundSequence* seq) {
+    if (!seq) return -1;
+    int id = new_collider(COLLIDER_CIRCLE);
+    if (id >= 0) {
+        colliders[id].round = seq;
+        colliders[id].generation = seq->generation;
+        set_circle_collider(id, (float)seq->center_x, (float)seq->center_y, (float)seq->radius);
+    }
+    return id;
+}
+
+void set_box_collider(int id, float x, float y, float w, float h) {
+    if (id < 0 || id >= COLLISION_MAX_COLLIDERS || !colliders[id].active) return;
+    Collider* c = &colliders[id];
+    c->x = x;
+    c->y = y;
+    c->w = w;
+    c->h = h;
+    update_bounds(id);
+}
+
+void set_circle_collider(int id, float cx, float cy, float radius) {
+    if (id < 0 || id >= COLLISION_MAX_COLLIDERS || !colliders[id].active) return;
+    Collider* c = &colliders[id];
+    c->x = cx;
+    c->y = cy;
+    c->radius = radius;
+    update_bounds(id);
+}
+
+// Remove a collider. Its contacts end on the next update.
+void remove_collider(int id) {
+    if (id < 0 || id >= COLLISION_MAX_COLLIDERS || !colliders[id].active) return;
+    colliders[id].active = 0;
+
+    for (int i = 0; i < sweep_count; i++) {
+        if (sweep_order[i] == id) {
+            memmove(&sweep_order[i], &sweep_order[i + 1], sizeof(int) * (sweep_count - i - 1));
+            sweep_count--;
+            break;
+        }
+    }
+}
+
+const Collider* get_collider(int id) {
+    if (id < 0 || id >= COLLISION_MAX_COLLIDERS || !colliders[id].active) return NULL;
+    return &colliders[id];
+}
+
+// -----------------------------------------------------------------------------
+// Narrowphase
+// -----------------------------------------------------------------------------
+
+// Exact overlap test. On contact, writes a representative contact point.
+static int shapes_overlap(int a, int b, float* px, float* py) {
+    const Collider* ca = &colliders[a];
+    const Collider* cb = &colliders[b];
+
+    if (ca->shape == COLLIDER_BOX && cb->shape == COLLIDER_BOX) {
+        // The broadphase already checked both axes
+        *px = ((min_x[a] > min_x[b] ? min_x[a] : min_x[b]) + (max_x[a] < max_x[b] ? max_x[a] : max_x[b])) * 0.5f;
+        *py = ((min_y[a] > min_y[b] ? min_y[a] : min_y[b]) + (max_y[a] < max_y[b] ? max_y[a] : max_y[b])) * 0.5f;
+        return 1;
+    }
+
+    if (ca->shape == COLLIDER_CIRCLE && cb->shape == COLLIDER_CIRCLE) {
+        float dx = cb->x - ca->x;
+        float dy = cb->y - ca->y;
+        float r = ca->radius + cb->radius;
+        float dist_sq = dx * dx + dy * dy;
+        if (dist_sq > r * r) return 0;
+        float t = r > 0.0f ? ca->radius / r : 0.5f;
+        *px = ca->x + dx * t;
+        *py = ca->y + dy * t;
+        return 1;
+    }
+
+    // Box against circle: closest point of the box to the circle center
+    const Collider* circle = ca->shape == COLLIDER_CIRCLE ? ca : cb;
+    int box = ca->shape == COLLIDER_BOX ? a : b;
+    float cx = circle->x < min_x[box] ? min_x[box] : (circle->x > max_x[box] ? max_x[box] : circle->x);
+    float cy = circle->y < min_y[box] ? min_y[box] : (circle->y > max_y[box] ? max_y[box] : circle->y);
+    float dx = circle->x - cx;
+    float dy = circle->y - cy;
+    if (dx * dx + dy * dy > circle->radius * circle->radius) return 0;
+    *px = cx;
+    *py = cy;
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// Update
+// -----------------------------------------------------------------------------
+
+static int compare_keys(const void* pa, const void* pb) {
+    Uint32 a = *(const Uint32*)pa;
+    Uint32 b = *(const Uint32*)pb;
+    return (a > b) - (a < b);
+}
+
+static int compare_found(const void* pa, const void* pb) {
+    Uint64 a = *(const Uint64*)pa;
+    Uint64 b = *(const Uint64*)pb;
+    return (a > b) - (a < b);
+}
+
+// Sort the sweep order by min_x. Nearly sorted input makes this ~O(n).
+static void sort_sweep_order(void) {
+    for (int i = 1; i < sweep_count; i++) {
+        int id = sweep_order[i];
+        float key = min_x[id];
+        int j = i - 1;
+        while (j >= 0 && min_x[sweep_order[j]] > key) {
+            sweep_order[j + 1] = sweep_order[j];
+            j--;
+            stats.sort_moves++;
+        }
+        sweep_order[j + 1] = id;
+    }
+}
+
+// Pair up colliders [begin, end) of the sweep order with the colliders
+// after them whose x range overlaps (parallel_for body)
+static void sweep_range(int begin, int end, void* data) {
+    (void)data;
+    int tests = 0;
+
+    for (int i = begin; i < end; i++) {
+        int a = sweep_order[i];
+        float right = max_x[a];
+
+        for (int j = i + 1; j < sweep_count; j++) {
+            int b = sweep_order[j];
+            if (min_x[b] > right) break;
+            if (min_y[b] > max_y[a] || min_y[a] > max_y[b]) continue;
+
+            tests++;
+            float px, py;
+            if (!shapes_overlap(a, b, &px, &py)) continue;
+
+            int slot = SDL_AtomicAdd(&found_count, 1);
+            if (slot >= COLLISION_MAX_CONTACTS) continue;
+            Uint64 key = a < b ? ((Uint64)a << 16) | (Uint64)b : ((Uint64)b << 16) | (Uint64)a;
+            found_x[slot] = px;
+            found_y[slot] = py;
+            found[slot] = (key << 32) | (Uint64)slot;
+        }
+    }
+    SDL_AtomicAdd(&narrow_tests, tests);
+}
+
+static void push_event(CollisionEventType type, Uint32 key, float x, float y) {
+    CollisionEvent* e = &events[event_count++];
+    e->type = type;
+    e->a = (int)(key >> 16);
+    e->b = (int)(key & 0xFFFF);
+    e->x = x;
+    e->y = y;
+}
+
+// Find contacts and produce begin / end events for this frame
+void update_collisions(void) {
+    memset(&stats, 0, sizeof(stats));
+
+    // Colliders attached to (round) sequences follow them, but only resync
+    // when the followed sequence's generation moved since the last frame
+    for (int i = 0; i < sweep_count; i++) {
+        int id = sweep_order[i];
+        Collider* c = &colliders[id];
+        if (c->sequence) {
+            if (c->sequence->generation == c->generation) continue;
+            c->generation = c->sequence->generation;
+            c->x = (float)c->sequence->x;
+            c->y = (float)c->sequence->y;
+            c->w = (float)c->sequence->w;
+            c->h = (float)c->sequence->h;
+            update_bounds(id);
+        } else if (c->round) {
+            if (c->round->generation == c->generation) continue;
+            c->generation = c->round->generation;
+            c->x = (float)c->round->center_x;
+            c->y = (float)c->round->center_y;
+            c->radius = (float)c->round->radius;
+            update_bounds(id);
+        }
+    }
+
+    sort_sweep_order();
+
+    int previous_set = current_set;
+    current_set ^= 1;
+    Uint32* pairs = pair_sets[current_set];
+
+    // Ranges of the sweep are independent, so they run on the job workers
+    SDL_AtomicSet(&found_count, 0);
+    SDL_AtomicSet(&narrow_tests, 0);
+    parallel_for(sweep_count, COLLISION_PARALLEL_BATCH, sweep_range, NULL);
+
+    int pair_count = SDL_AtomicGet(&found_count);
+    if (pair_count > COLLISION_MAX_CONTACTS) {
+        if (!overflow_reported) {
+            printf("Warning: More than %d contacts, extra contacts ignored\n",
+                   COLLISION_MAX_CONTACTS);
+            overflow_reported = 1;
+        }
+        pair_count = COLLISION_MAX_CONTACTS;
+    }
+    stats.narrow_tests = SDL_AtomicGet(&narrow_tests);
+
+    qsort(found, pair_count, sizeof(Uint64), compare_found);
+    static float contact_x[COLLISION_MAX_CONTACTS];
+    static float contact_y[COLLISION_MAX_CONTACTS];
+    for (int i = 0; i < pair_count; i++) {
+        int index = (int)(found[i] & 0xFFFFFFFFu);
+        pairs[i] = (Uint32)(found[i] >> 32);
+        contact_x[i] = found_x[index];
+        contact_y[i] = found_y[index];
+    }
+    pair_counts[current_set] = pair_count;
+
+    // Merge with the previous set: new keys begin, missing keys end
+    const Uint32* old_pairs = pair_sets[previous_set];
+    int old_count = pair_counts[previous_set];
+    int i = 0, j = 0;
+    event_count = 0;
+    while (i < pair_count || j < old_count) {
+        if (j >= old_count || (i < pair_count && pairs[i] < old_pairs[j])) {
+            push_event(COLLISION_BEGIN, pairs[i], contact_x[i], contact_y[i]);
+            i++;
+        } else if (i >= pair_count || old_pairs[j] < pairs[i]) {
+            push_event(COLLISION_END, old_pairs[j], 0.0f, 0.0f);
+            j++;
+        } else {
+            i++;
+            j++;
+        }
+    }
+
+    stats.colliders = sweep_count;
+    stats.contacts = pair_count;
+    stats.events = event_count;
+    total_stats.narrow_tests += stats.narrow_tests;
+    total_stats.sort_moves += stats.sort_moves;
+    total_stats.contacts += stats.contacts;
+    total_stats.events += stats.events;
+    total_updates++;
+}
+
+// Events produced by the last update_collisions()
+const CollisionEvent* get_collision_events(int* count) {
+    *count = event_count;
+    return events;
+}
+
+// Whether two colliders were in contact at the last update
+int are_colliding(int a, int b) {
+    if (a == b || a < 0 || b < 0) return 0;
+    Uint32 key = a < b ? ((Uint32)a << 16) | (Uint32)b : ((Uint32)b << 16) | (Uint32)a;
+    return bsearch(&key, pair_sets[current_set], pair_counts[current_set],
+                   sizeof(Uint32), compare_keys) != NULL;
+}
+
+CollisionStats get_collision_stats(void) {
+    return stats;
+}
+
+void print_collision_stats(void) {
+    if (total_updates == 0) return;
+    printf("\n=== COLLISION STATS (%d updates) ===\n", total_updates);
+    printf("Colliders:                %d\n", stats.colliders);
+    printf("Narrowphase tests/update: %.1f\n", (double)total_stats.narrow_tests / total_updates);
+    printf("Sort moves/update:        %.1f\n", (double)total_stats.sort_moves / total_updates);
+    printf("Contacts/update:          %.1f\n", (double)total_stats.contacts / total_updates);
+    printf("Events total:             %d\n", total_stats.events);
+    printf("=====================================\n");
+}
+
+// Remove every collider and forget all contacts
+void cleanup_collisions(void) {
+    memset(colliders, 0, sizeof(colliders));
+    sweep_count = 0;
+    pair_counts[0] = pair_counts[1] = 0;
+    event_count = 0;
+    memset(&total_stats, 0, sizeof(total_stats));
+    total_updates = 0;
+    overflow_reported = 0;
+}
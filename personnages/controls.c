@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// CONTROLS - key bindings, per-frame input snapshot and player controls
+// =============================================================================
+//
+// Key presses are routed through a hash table keyed on (keycode, modifiers,
+// focus context) instead of if/else chains. A press is looked up in the
+// context it happens in (text while an input field has the focus, game
+// otherwise) and then in the "any" context; a binding without modifiers
+// also answers a press with modifiers held. That is at most four probes,
+// however many bindings and widgets exist.
+//
+// The keyboard array is copied once per frame into a snapshot, together with
+// the modifiers and the pointer, so everything that reads input during the
+// frame sees the same state (and replays only have to provide the keys).
+//
+// Player movement keys are rebindable. They are stored as keycodes so the
+// letter printed on the key caps is what moves the player whatever the
+// keyboard layout; the scancodes read from the snapshot are resolved again
+// when the keymap changes.
+
+static KeyBinding table[CONTROL_TABLE_SIZE];
+static int binding_count = 0;
+static InputSnapshot snapshot;
+
+// Player movement keys and the key caps showing them
+static SDL_Keycode player_keys[2][PLAYER_ACTION_COUNT];
+static SDL_Scancode player_scancodes[2][PLAYER_ACTION_COUNT];
+static Sequence* player_caps[2][PLAYER_ACTION_COUNT];
+static const char* action_names[PLAYER_ACTION_COUNT] = {"left", "up", "right", "down"};
+
+// Collapse SDL modifiers to CONTROL_MOD_* (left / right merged, locks ignored)
+static Uint8 control_mods(Uint16 mod) {
+    Uint8 mods = 0;
+    if (mod & KMOD_SHIFT) mods |= CONTROL_MOD_SHIFT;
+    if (mod & KMOD_CTRL) mods |= CONTROL_MOD_CTRL;
+    if (mod & KMOD_ALT) mods |= CONTROL_MOD_ALT;
+    if (mod & KMOD_GUI) mods |= CONTROL_MOD_GUI;
+    return mods;
+}
+
+static Uint32 hash_binding(SDL_Keycode key, int mods, int context) {
+    Uint32 h = (Uint32)key * 2654435761u;
+    h ^= (Uint32)(mods << 2 | context) * 40503u;
+    return h ^ (h >> 16);
+}
+
+// Slot holding (key, mods, context), or -1
+static int find_slot(SDL_Keycode key, int mods, int context) {
+    Uint32 mask = CONTROL_TABLE_SIZE - 1;
+    Uint32 i = hash_binding(key, mods, context) & mask;
+    for (int probe = 0; probe < CONTROL_TABLE_SIZE; probe++, i = (i + 1) & mask) {
+        const KeyBinding* b = &table[i];
+        if (!b->used && !b->deleted) return -1;
+        if (b->used && b->key == key && b->mods == mods && b->context == context) return (int)i;
+    }
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+// Key bindings
+// -----------------------------------------------------------------------------
+
+// Call 'handler' when 'key' is pressed with the CONTROL_MOD_* flags 'mods'
+// in 'context'. Rebinding the same combination replaces the handler.
+// Returns 0 on success, -1 if the table is full.
+int bind_key(SDL_Keycode key, int mods, int context, ControlHandler handler, void* data) {
+    int slot = find_slot(key, mods, context);
+    if (slot < 0) {
+        if (binding_count >= CONTROL_MAX_BINDINGS) {
+            printf("Error: Maximum key bindings limit reached (%d)\n", CONTROL_MAX_BINDINGS);
+            return -1;
+        }
+        Uint32 mask = CONTROL_TABLE_SIZE - 1;
+        Uint32 i = hash_binding(key, mods, context) & mask;
+        while (table[i].used) i = (i + 1) & mask;
+        slot = (int)i;
+        binding_count++;
+    }
+
+    KeyBinding* b = &table[slot];
+    b->used = 1;
+    b->deleted = 0;
+    b->key = key;
+    b->mods = (Uint8)mods;
+    b->context = (Uint8)context;
+    b->handler = handler;
+    b->data = data;
+    return 0;
+}
+
+void unbind_key(SDL_Keycode key, int mods, int context) {
+    int slot = find_slot(key, mods, context);
+    if (slot < 0) return;
+    table[slot].used = 0;
+    table[slot].deleted = 1;
+    binding_count--;
+}
+
+// Handler for a key press in a focus context (exact modifiers first)
+static const KeyBinding* lookup(SDL_Keycode key, Uint8 mods, int context) {
+    int slot = find_slot(key, mods, context);
+    if (slot < 0 && mods) slot = find_slot(key, 0, context);
+    return slot >= 0 ? &table[slot] : NULL;
+}
+
+// Route an event: pointer state goes to the snapshot, key presses to their
+// binding. Returns 1 if a key binding handled the event.
+int dispatch_control_event(const SDL_Event* event) {
+    switch (event->type) {
+        case SDL_MOUSEMOTION:
+            snapshot.mouse_x = event->motion.x;
+            snapshot.mouse_y = event->motion.y;
+            return 0;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            snapshot.mouse_x = event->button.x;
+            snapshot.mouse_y = event->button.y;
+            if (event->type == SDL_MOUSEBUTTONDOWN) {
+                snapshot.mouse_buttons |= SDL_BUTTON(event->button.button);
+            } else {
+                snapshot.mouse_buttons &= ~SDL_BUTTON(event->button.button);
+            }
+            return 0;
+        case SDL_KEYMAPCHANGED:
+            refresh_player_controls();
+            return 0;
+        case SDL_KEYDOWN:
+            break;
+        default:
+            return 0;
+    }
+
+    SDL_Keycode key = event->key.keysym.sym;
+    Uint8 mods = control_mods(event->key.keysym.mod);
+    int context = get_focused_input() ? CONTROL_CONTEXT_TEXT : CONTROL_CONTEXT_GAME;
+
+    const KeyBinding* b = lookup(key, mods, context);
+    if (!b) b = lookup(key, mods, CONTROL_CONTEXT_ANY);
+    if (!b) return 0;
+    b->handler(event, b->data);
+    return 1;
+}
+
+void clear_key_bindings(void) {
+    memset(table, 0, sizeof(table));
+    binding_count = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Snapshot
+// -----------------------------------------------------------------------------
+
+// Take this frame's keyboard state (SDL's array, or the replay's).
+// Call once per frame after the events have been handled.
+void update_input_snapshot(const Uint8* keys) {
+    if (keys) {
+        memcpy(snapshot.keys, keys, sizeof(snapshot.keys));
+    } else {
+        memset(snapshot.keys, 0, sizeof(snapshot.keys));
+    }
+
+    // Modifiers from the same array, so replays see the recorded ones
+    Uint8 mods = 0;
+    const Uint8* k = snapshot.keys;
+    if (k[SDL_SCANCODE_LSHIFT] || k[SDL_SCANCODE_RSHIFT]) mods |= CONTROL_MOD_SHIFT;
+    if (k[SDL_SCANCODE_LCTRL] || k[SDL_SCANCODE_RCTRL]) mods |= CONTROL_MOD_CTRL;
+    if (k[SDL_SCANCODE_LALT] || k[SDL_SCANCODE_RALT]) mods |= CONTROL_MOD_ALT;
+    if (k[SDL_SCANCODE_LGUI] || k[SDL_SCANCODE_RGUI]) mods |= CONTROL_MOD_GUI;
+    snapshot.mods = mods;
+}
+
+const InputSnapshot* get_input_snapshot(void) {
+    return &snapshot;
+}
+
+// -----------------------------------------------------------------------------
+// Player controls
+// -----------------------------------------------------------------------------
+
+// Text shown on a key cap: arrows as arrows, other keys by their name
+static const char* key_cap_text(SDL_Keycode key) {
+    switch (key) {
+        case SDLK_LEFT:  return "←";
+        case SDLK_UP:    return "↑";
+        case SDLK_RIGHT: return "→";
+        case SDLK_DOWN:  return "↓";
+        default:         return SDL_GetKeyName(key);
+    }
+}
+
+// Default layout: player 1 on Q/Z/D/S, player 2 on the arrow keys
+void init_player_controls(void) {
+    static const SDL_Keycode defaults[2][PLAYER_ACTION_COUNT] = {
+        {SDLK_q, SDLK_z, SDLK_d, SDLK_s},
+        {SDLK_LEFT, SDLK_UP, SDLK_RIGHT, SDLK_DOWN},
+    };
+    memcpy(player_keys, defaults, sizeof(player_keys));
+    memset(player_caps, 0, sizeof(player_caps));
+    refresh_player_controls();
+}
+
+// Move a player action to another key (its key cap follows)
+void set_player_control(int player, PlayerAction action, SDL_Keycode key) {
+    if (player < 0 || player > 1 || action < 0 || action >= PLAYER_ACTION_COUNT) return;
+    player_keys[player][action] = key;
+    player_scancodes[player][action] = SDL_GetScancodeFromKey(key);
+    update_sequence_text(player_caps[player][action], key_cap_text(key));
+    printf("Player %d %s bound to %s\n", player + 1, action_names[action], SDL_GetKeyName(key));
+}
+
+SDL_Keycode get_player_control(int player, PlayerAction action) {
+    if (player < 0 || player > 1 || action < 0 || action >= PLAYER_ACTION_COUNT) return SDLK_UNKNOWN;
+    return player_keys[player][action];
+}
+
+// Scancode to read from the keyboard state for a player action
+SDL_Scancode get_player_scancode(int player, PlayerAction action) {
+    if (player < 0 || player > 1 || action < 0 || action >= PLAYER_ACTION_COUNT) {
+        return SDL_SCANCODE_UNKNOWN;
+    }
+    return player_scancodes[player][action];
+}
+
+// Show the key of a player action on a sequence (kept up to date on rebinds)
+void set_player_key_cap(int player, PlayerAction action, Sequence* cap) {
+    if (player < 0 || player > 1 || action < 0 || action >= PLAYER_ACTION_COUNT) return;
+    player_caps[player][action] = cap;
+    update_sequence_text(cap, key_cap_text(player_keys[player][action]));
+}
+
+// Resolve the scancodes of every player key again (keyboard layout changed)
+void refresh_player_controls(void) {
+    for (int p = 0; p < 2; p++) {
+        for (int a = 0; a < PLAYER_ACTION_COUNT; a++) {
+            player_scancodes[p][a] = SDL_GetScancodeFromKey(player_keys[p][a]);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// CULLING - decide what actually needs to be drawn this frame
+// =============================================================================
+//
+// Runs after the scene graph update and before any draw command is queued:
+//   1. subtrees that are hidden, fully transparent or off-screen are skipped
+//      without visiting their children (scene graph bounds)
+//   2. sequences whose own rect is off-screen are dropped (children may still
+//      be visible)
+//   3. sequences fully covered by an opaque rect drawn above them are dropped
+//   4. fills with zero alpha are dropped, the rest of the sequence is kept
+// Dropped sequences never reach draw_sequence(), so their text is not
+// rasterized either.
+
+#define MAX_OCCLUDERS 64
+
+static Sequence* draw_list[MAX_SEQUENCES];
+static int draw_list_count = 0;
+
+static CullStats frame_stats;
+static CullStats total_stats;
+static int total_frames = 0;
+
+// Check whether a rect lies completely outside the viewport
+static int rect_off_screen(int x, int y, int w, int h) {
+    return x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT || x + w <= 0 || y + h <= 0;
+}
+
+// A sequence hides what is below it if its fill is a fully opaque rect
+static int is_opaque_occluder(const Sequence* seq) {
+    return seq->color.a == 255 && seq->world_opacity == 255 &&
+           strcmp(seq->name, "volume_indicator") != 0;
+}
+
+// Collect the sequences of a subtree in draw order
+static void collect_subtree(Sequence* seq) {
+    frame_stats.tested++;
+    if (is_sequence_subtree_culled(seq)) {
+        frame_stats.subtrees_culled++;
+        return;
+    }
+
+    seq->cull_flags = 0;
+    draw_list[draw_list_count++] = seq;
+
+    for (int c = seq->first_child; c >= 0; c = sequences[c].next_sibling) {
+        collect_subtree(&sequences[c]);
+    }
+}
+
+// Build the list of sequences to draw this frame
+void cull_sequences(void) {
+    memset(&frame_stats, 0, sizeof(frame_stats));
+    draw_list_count = 0;
+
+    for (int i = 0; i < sequence_count; i++) {
+        if (sequences[i].parent < 0) {
+            collect_subtree(&sequences[i]);
+        }
+    }
+
+    // Walk from the top of the z-order down, remembering opaque rects
+    SDL_Rect occluders[MAX_OCCLUDERS];
+    int occluder_count = 0;
+
+    for (int i = draw_list_count - 1; i >= 0; i--) {
+        Sequence* seq = draw_list[i];
+
+        if (rect_off_screen(seq->x, seq->y, seq->w, seq->h)) {
+            seq->cull_flags |= CULL_SELF;
+            frame_stats.offscreen++;
+            continue;
+        }
+
+        for (int o = 0; o < occluder_count; o++) {
+            const SDL_Rect* occ = &occluders[o];
+            if (seq->x >= occ->x && seq->y >= occ->y &&
+                seq->x + seq->w <= occ->x + occ->w &&
+                seq->y + seq->h <= occ->y + occ->h) {
+                seq->cull_flags |= CULL_SELF;
+                frame_stats.occluded++;
+                break;
+            }
+        }
+        if (seq->cull_flags & CULL_SELF) continue;
+
+        if (seq->color.a == 0 || seq->world_opacity == 0) {
+            seq->cull_flags |= CULL_FILL;
+            frame_stats.fills_dropped++;
+        }
+
+        if (is_opaque_occluder(seq) && occluder_count < MAX_OCCLUDERS) {
+            occluders[occluder_count++] = (SDL_Rect){seq->x, seq->y, seq->w, seq->h};
+        }
+        frame_stats.drawn++;
+    }
+
+    total_stats.tested += frame_stats.tested;
+    total_stats.subtrees_culled += frame_stats.subtrees_culled;
+    total_stats.offscreen += frame_stats.offscreen;
+    total_stats.occluded += frame_stats.occluded;
+    total_stats.fills_dropped += frame_stats.fills_dropped;
+    total_stats.drawn += frame_stats.drawn;
+    total_frames++;
+}
+
+// Sequences that survived culling, in draw order
+Sequence** get_draw_list(int* count) {
+    if (count) *count = draw_list_count;
+    return draw_list;
+}
+
+// A round sequence is skipped when hidden, fully transparent or off-screen
+int is_round_sequence_culled(const RoundSequence* seq) {
+    if (!seq->visible) return 1;
+    if (seq->color.a == 0 && (strlen(seq->text_content) == 0 || !seq->font)) return 1;
+    return rect_off_screen(seq->center_x - seq->radius, seq->center_y - seq->radius,
+                           seq->radius * 2 + 1, seq->radius * 2 + 1);
+}
+
+// Statistics of the last culling pass
+CullStats get_cull_stats(void) {
+    return frame_stats;
+}
+
+// Print average culling statistics over all frames so far
+void print_cull_stats(void) {
+    if (total_frames == 0) return;
+    printf("Culling: avg %.1f tested, %.1f subtrees skipped, %.1f off-screen, "
+           "%.1f occluded, %.1f fills dropped, %.1f drawn per frame\n",
+           (double)total_stats.tested / total_frames,
+           (double)total_stats.subtrees_culled / total_frames,
+           (double)total_stats.offscreen / total_frames,
+           (double)total_stats.occluded / total_frames,
+           (double)total_stats.fills_dropped / total_frames,
+           (double)total_stats.drawn / total_frames);
+}
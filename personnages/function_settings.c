@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// SETTINGS - render quality knobs and the settings file
+// =============================================================================
+//
+// The knobs that depend on the machine (vsync, frame rate, cache budgets,
+// particle count, audio buffer) live in one Settings value. They are read
+// from a small binary file at startup; when it is missing or invalid the
+// auto-tune (main_settings.c) measures the machine and writes a new one.
+//
+// File layout (little-endian, 28 bytes):
+//   "PSET"  magic
+//   u8      format version
+//   u8      flags (bit 0: values picked by the auto-tune)
+//   u8      vsync mode
+//   u8      reserved
+//   u16     target FPS (0 = unlimited)
+//   u16     audio buffer in sample frames (0 = audio engine default)
+//   u32     text cache budget (KiB)
+//   u32     texture budget (KiB)
+//   u32     particle limit
+//   u32     FNV-1a checksum of the 24 bytes above
+
+#define SETTINGS_MAGIC "PSET"
+#define SETTINGS_VERSION 1
+#define SETTINGS_BODY_SIZE 24
+#define SETTINGS_FLAG_TUNED 0x01
+
+static Settings settings;
+
+// Values used before anything is measured (what the game used to hard-code)
+static const Settings default_settings = {
+    .vsync = SETTINGS_VSYNC_ON,
+    .target_fps = 60,
+    .text_cache_kb = 8 * 1024,
+    .texture_budget_kb = 64 * 1024,
+    .particle_limit = 6144,
+    .audio_buffer_samples = 0,
+    .tuned = 0
+};
+
+static int clamp_int(int value, int lo, int hi) {
+    return value < lo ? lo : (value > hi ? hi : value);
+}
+
+// Keep every knob in a range the rest of the game can cope with
+static void validate_settings(Settings* s) {
+    s->vsync = s->vsync ? SETTINGS_VSYNC_ON : SETTINGS_VSYNC_OFF;
+    s->target_fps = s->target_fps <= 0 ? 0 : clamp_int(s->target_fps, 20, 360);
+    s->text_cache_kb = clamp_int(s->text_cache_kb, 1024, 256 * 1024);
+    s->texture_budget_kb = clamp_int(s->texture_budget_kb, 8 * 1024, 1024 * 1024);
+    s->particle_limit = clamp_int(s->particle_limit, 512, 65536);
+    if (s->audio_buffer_samples != 0) {
+        int samples = 256;
+        while (samples < s->audio_buffer_samples && samples < 4096) samples <<= 1;
+        s->audio_buffer_samples = samples;
+    }
+    s->tuned = s->tuned ? 1 : 0;
+}
+
+void reset_settings(void) {
+    settings = default_settings;
+}
+
+const Settings* get_settings(void) {
+    return &settings;
+}
+
+// Replace the settings (values are clamped to their valid range)
+void set_settings(const Settings* new_settings) {
+    settings = *new_settings;
+    validate_settings(&settings);
+}
+
+// -----------------------------------------------------------------------------
+// File
+// -----------------------------------------------------------------------------
+
+static Uint32 fnv1a(const Uint8* bytes, int size) {
+    Uint32 hash = 2166136261u;
+    for (int i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void put_le16(Uint8* p, Uint16 value) {
+    p[0] = (Uint8)value;
+    p[1] = (Uint8)(value >> 8);
+}
+
+static void put_le32(Uint8* p, Uint32 value) {
+    put_le16(p, (Uint16)value);
+    put_le16(p + 2, (Uint16)(value >> 16));
+}
+
+static Uint16 get_le16(const Uint8* p) {
+    return (Uint16)(p[0] | p[1] << 8);
+}
+
+static Uint32 get_le32(const Uint8* p) {
+    return (Uint32)get_le16(p) | (Uint32)get_le16(p + 2) << 16;
+}
+
+// Read the settings file. Returns 0 on success; otherwise the defaults are
+// in place and -1 is returned (missing, damaged or older file).
+int load_settings(const char* path) {
+    reset_settings();
+
+    SDL_RWops* rw = SDL_RWFromFile(path, "rb");
+    if (!rw) {
+        printf("No settings file '%s', using defaults\n", path);
+        return -1;
+    }
+    Uint8 body[SETTINGS_BODY_SIZE];
+    size_t bytes_read = SDL_RWread(rw, body, 1, sizeof(body));
+    Uint32 checksum = SDL_ReadLE32(rw);
+    SDL_RWclose(rw);
+
+    if (bytes_read != sizeof(body) || memcmp(body, SETTINGS_MAGIC, 4) != 0) {
+        printf("Error: '%s' is not a settings file\n", path);
+        return -1;
+    }
+    if (body[4] != SETTINGS_VERSION) {
+        printf("Error: Unsupported settings version %d\n", body[4]);
+        return -1;
+    }
+    if (checksum != fnv1a(body, sizeof(body))) {
+        printf("Error: Settings file '%s' is damaged\n", path);
+        return -1;
+    }
+
+    Settings loaded;
+    loaded.tuned = (body[5] & SETTINGS_FLAG_TUNED) != 0;
+    loaded.vsync = body[6];
+    loaded.target_fps = get_le16(body + 8);
+    loaded.audio_buffer_samples = get_le16(body + 10);
+    loaded.text_cache_kb = (int)get_le32(body + 12);
+    loaded.texture_budget_kb = (int)get_le32(body + 16);
+    loaded.particle_limit = (int)get_le32(body + 20);
+    set_settings(&loaded);
+    printf("Settings loaded from '%s'\n", path);
+    return 0;
+}
+
+// Write the current settings. Returns 0 on success.
+int save_settings(const char* path) {
+    Uint8 body[SETTINGS_BODY_SIZE] = {0};
+    memcpy(body, SETTINGS_MAGIC, 4);
+    body[4] = SETTINGS_VERSION;
+    body[5] = settings.tuned ? SETTINGS_FLAG_TUNED : 0;
+    body[6] = (Uint8)settings.vsync;
+    put_le16(body + 8, (Uint16)settings.target_fps);
+    put_le16(body + 10, (Uint16)settings.audio_buffer_samples);
+    put_le32(body + 12, (Uint32)settings.text_cache_kb);
+    put_le32(body + 16, (Uint32)settings.texture_budget_kb);
+    put_le32(body + 20, (Uint32)settings.particle_limit);
+
+    SDL_RWops* rw = SDL_RWFromFile(path, "wb");
+    if (!rw) {
+        printf("Failed to open settings file '%s': %s\n", path, SDL_GetError());
+        return -1;
+    }
+    int ok = SDL_RWwrite(rw, body, 1, sizeof(body)) == sizeof(body) &&
+             SDL_WriteLE32(rw, fnv1a(body, sizeof(body))) == 1;
+    SDL_RWclose(rw);
+    if (!ok) {
+        printf("Failed to write settings file '%s': %s\n", path, SDL_GetError());
+        return -1;
+    }
+    printf("Settings saved to '%s'\n", path);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Applying
+// -----------------------------------------------------------------------------
+
+// Switch vsync to the setting. The renderer is created with it already; this
+// is for a change made afterwards (the auto-tune).
+void apply_vsync_setting(SDL_Renderer* renderer) {
+    if (SDL_RenderSetVSync(renderer, settings.vsync) != 0) {
+        printf("Warning: Could not change vsync: %s\n", SDL_GetError());
+    }
+}
+
+// Hand the budgets to the caches they belong to (the scene manager must
+// exist). The audio buffer and the particle limit are read when the audio
+// engine and the emitters are created.
+void apply_settings(void) {
+    set_texture_pool_budget((size_t)settings.text_cache_kb * 1024);
+    set_scene_texture_budget((size_t)settings.texture_budget_kb * 1024);
+}
+
+void print_settings(void) {
+    printf("\n=== SETTINGS (%s) ===\n", settings.tuned ? "auto-tuned" : "defaults");
+    printf("Vsync: %s | target FPS: ", settings.vsync ? "on" : "off");
+    if (settings.target_fps > 0) {
+        printf("%d\n", settings.target_fps);
+    } else {
+        printf("unlimited\n");
+    }
+    printf("Text cache: %d KB | texture budget: %d KB | particles: %d\n",
+           settings.text_cache_kb, settings.texture_budget_kb, settings.particle_limit);
+    if (settings.audio_buffer_samples > 0) {
+        printf("Audio buffer: %d frames\n", settings.audio_buffer_samples);
+    } else {
+        printf("Audio buffer: engine default\n");
+    }
+    printf("=====================\n");
+}
+
+// Sleep what is left of the frame at the target frame rate ('frame_start'
+// is the performance counter at the start of the frame)
+void limit_frame_rate(Uint64 frame_start) {
+    if (settings.target_fps <= 0) return;
+
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    double elapsed_ms = (double)(SDL_GetPerformanceCounter() - frame_start) * 1000.0 / (double)freq;
+    double remaining_ms = 1000.0 / settings.target_fps - elapsed_ms;
+    if (remaining_ms >= 1.0) {
+        SDL_Delay((Uint32)remaining_ms);
+    }
+}
@@ -0,0 +1,90 @@
+#include <string.h>
+#include "header.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GAIN_USE_SSE2 1
+#endif
+
+// =============================================================================
+// GAIN RAMPS - click-free volume changes on interleaved stereo S16 audio
+// =============================================================================
+//
+// A gain change is spread linearly over a number of sample frames instead of
+// being applied at once, which removes the "zipper" clicks of stepped volume.
+// Used on the audio thread only.
+
+// Start at a fixed gain with no ramp in progress
+void init_gain_ramp(GainRamp* ramp, float gain) {
+    ramp->current = gain;
+    ramp->target = gain;
+    ramp->step = 0.0f;
+    ramp->remaining = 0;
+}
+
+// Move towards 'target' over 'frames' sample frames (0 = immediately)
+void start_gain_ramp(GainRamp* ramp, float target, int frames) {
+    ramp->target = target;
+    if (frames <= 0) {
+        ramp->current = target;
+        ramp->step = 0.0f;
+        ramp->remaining = 0;
+        return;
+    }
+    ramp->step = (target - ramp->current) / (float)frames;
+    ramp->remaining = frames;
+}
+
+// Multiply frames by gain, gain + step, gain + 2 * step, ...
+static void scale_stereo(Sint16* samples, int frames, float gain, float step) {
+    int i = 0;
+
+#ifdef GAIN_USE_SSE2
+    // Four frames (eight samples) per iteration, saturated back to 16 bits
+    __m128 g_lo = _mm_set_ps(gain + step, gain + step, gain, gain);
+    __m128 g_hi = _mm_add_ps(g_lo, _mm_set1_ps(2.0f * step));
+    __m128 inc = _mm_set1_ps(4.0f * step);
+    for (; i + 4 <= frames; i += 4) {
+        __m128i* p = (__m128i*)(samples + 2 * i);
+        __m128i v = _mm_loadu_si128(p);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        __m128 f_lo = _mm_mul_ps(_mm_cvtepi32_ps(lo), g_lo);
+        __m128 f_hi = _mm_mul_ps(_mm_cvtepi32_ps(hi), g_hi);
+        _mm_storeu_si128(p, _mm_packs_epi32(_mm_cvtps_epi32(f_lo), _mm_cvtps_epi32(f_hi)));
+        g_lo = _mm_add_ps(g_lo, inc);
+        g_hi = _mm_add_ps(g_hi, inc);
+    }
+#endif
+
+    for (; i < frames; i++) {
+        float g = gain + step * i;
+        for (int c = 0; c < 2; c++) {
+            float v = samples[2 * i + c] * g;
+            if (v > 32767.0f) v = 32767.0f;
+            if (v < -32768.0f) v = -32768.0f;
+            samples[2 * i + c] = (Sint16)v;
+        }
+    }
+}
+
+// Apply the ramp to 'frames' stereo frames in place and advance it
+void apply_gain_ramp(GainRamp* ramp, Sint16* samples, int frames) {
+    if (ramp->remaining > 0) {
+        int n = frames < ramp->remaining ? frames : ramp->remaining;
+        scale_stereo(samples, n, ramp->current, ramp->step);
+        ramp->remaining -= n;
+        ramp->current = ramp->remaining > 0 ? ramp->current + ramp->step * n : ramp->target;
+        samples += n * 2;
+        frames -= n;
+    }
+    if (frames <= 0) return;
+
+    // Steady gain
+    if (ramp->current >= 0.9999f && ramp->current <= 1.0001f) return;
+    if (ramp->current <= 0.0f) {
+        memset(samples, 0, (size_t)frames * 2 * sizeof(Sint16));
+        return;
+    }
+    scale_stereo(samples, frames, ramp->current, 0.0f);
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// GAME SIMULATION - fixed-timestep update of the two player characters
+// =============================================================================
+//
+// The simulation advances in fixed ticks of GAME_TICK_DT seconds, no matter how
+// fast frames are rendered. A frame runs as many ticks as the elapsed time
+// allows and rendering interpolates between the last two tick states.
+// game_step() only depends on the previous state and the inputs, so a
+// headless run with the same inputs always produces the same result.
+
+#define PLAYER_SPEED 420.0f         // Top speed in pixels per second
+#define PLAYER_ACCEL 12.0f          // How fast velocity reaches the target (1/s)
+#define MAX_TICKS_PER_FRAME 8       // Avoid a spiral of death after a long stall
+
+// Global game instance
+GameSimulation game;
+
+// Initialize the simulation with an arena and two player rects
+void init_game(int arena_w, int arena_h,
+               int p1_x, int p1_y, int p2_x, int p2_y, int player_w, int player_h) {
+    memset(&game, 0, sizeof(game));
+    game.arena_w = arena_w;
+    game.arena_h = arena_h;
+
+    game.players[0].x = (float)p1_x;
+    game.players[0].y = (float)p1_y;
+    game.players[1].x = (float)p2_x;
+    game.players[1].y = (float)p2_y;
+    for (int i = 0; i < 2; i++) {
+        game.players[i].w = player_w;
+        game.players[i].h = player_h;
+        game.previous[i] = game.players[i];
+    }
+
+    game.sequences[0] = NULL;
+    game.sequences[1] = NULL;
+    printf("Game simulation initialized (%d Hz, arena %dx%d)\n",
+           GAME_TICK_RATE, arena_w, arena_h);
+}
+
+// Attach a sequence that mirrors a player's interpolated position
+void bind_player_sequence(int player, Sequence* seq) {
+    if (player < 0 || player > 1) return;
+    game.sequences[player] = seq;
+}
+
+// Sample the controls of both players from a keyboard state array.
+// Keys come from the rebindable player controls (controls.c): by default
+// player 1 uses Q/Z/D/S, player 2 the arrow keys.
+void read_player_inputs(const Uint8* keys, PlayerInput inputs[2]) {
+    memset(inputs, 0, sizeof(PlayerInput) * 2);
+    if (!keys) return;
+
+    for (int i = 0; i < 2; i++) {
+        inputs[i].left  = keys[get_player_scancode(i, PLAYER_ACTION_LEFT)];
+        inputs[i].up    = keys[get_player_scancode(i, PLAYER_ACTION_UP)];
+        inputs[i].right = keys[get_player_scancode(i, PLAYER_ACTION_RIGHT)];
+        inputs[i].down  = keys[get_player_scancode(i, PLAYER_ACTION_DOWN)];
+    }
+}
+
+// Advance one player by one tick
+static void step_player(PlayerState* p, const PlayerInput* in, int arena_w, int arena_h) {
+    float dir_x = (float)((in->right ? 1 : 0) - (in->left ? 1 : 0));
+    float dir_y = (float)((in->down ? 1 : 0) - (in->up ? 1 : 0));
+
+    // Ease velocity towards the target speed
+    float blend = PLAYER_ACCEL * GAME_TICK_DT;
+    p->vx += (dir_x * PLAYER_SPEED - p->vx) * blend;
+    p->vy += (dir_y * PLAYER_SPEED - p->vy) * blend;
+
+    p->x += p->vx * GAME_TICK_DT;
+    p->y += p->vy * GAME_TICK_DT;
+
+    // Stay inside the arena
+    float max_x = (float)(arena_w - p->w);
+    float max_y = (float)(arena_h - p->h);
+    if (p->x < 0.0f)  { p->x = 0.0f;  p->vx = 0.0f; }
+    if (p->y < 0.0f)  { p->y = 0.0f;  p->vy = 0.0f; }
+    if (p->x > max_x) { p->x = max_x; p->vx = 0.0f; }
+    if (p->y > max_y) { p->y = max_y; p->vy = 0.0f; }
+}
+
+// Run exactly one simulation tick
+void game_step(GameSimulation* sim, const PlayerInput inputs[2]) {
+    for (int i = 0; i < 2; i++) {
+        sim->previous[i] = sim->players[i];
+        step_player(&sim->players[i], &inputs[i], sim->arena_w, sim->arena_h);
+    }
+    sim->tick++;
+}
+
+// Advance the simulation by the real time elapsed since the last frame.
+// Returns the number of ticks that were run.
+int game_update(GameSimulation* sim, double frame_seconds, const Uint8* keys) {
+    PlayerInput inputs[2];
+    read_player_inputs(keys, inputs);
+
+    sim->accumulator += frame_seconds;
+
+    int ticks = 0;
+    while (sim->accumulator >= GAME_TICK_DT && ticks < MAX_TICKS_PER_FRAME) {
+        game_step(sim, inputs);
+        sim->accumulator -= GAME_TICK_DT;
+        ticks++;
+    }
+
+    // Drop time we could not catch up with instead of accumulating it
+    if (sim->accumulator >= GAME_TICK_DT) {
+        sim->accumulator = 0.0;
+    }
+    return ticks;
+}
+
+// Fraction of a tick elapsed since the last simulated state (0..1)
+float game_interpolation_alpha(const GameSimulation* sim) {
+    return (float)(sim->accumulator / GAME_TICK_DT);
+}
+
+// Move bound sequences to the interpolated player positions
+void apply_game_to_sequences(const GameSimulation* sim) {
+    float alpha = game_interpolation_alpha(sim);
+
+    for (int i = 0; i < 2; i++) {
+        if (!sim->sequences[i]) continue;
+
+        const PlayerState* prev = &sim->previous[i];
+        const PlayerState* cur = &sim->players[i];
+        float x = prev->x + (cur->x - prev->x) * alpha;
+        float y = prev->y + (cur->y - prev->y) * alpha;
+
+        // Scene graph: a single O(1) mutation per player
+        update_sequence_position(sim->sequences[i], (int)(x + 0.5f), (int)(y + 0.5f));
+    }
+}
+
+// FNV-1a hash of the simulation state, used to check determinism
+Uint32 game_state_checksum(const GameSimulation* sim) {
+    Uint32 hash = 2166136261u;
+    const Uint8* bytes = (const Uint8*)sim->players;
+    for (size_t i = 0; i < sizeof(sim->players); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Run the simulation without a window, driven by pseudo-random inputs.
+// The same seed always produces the same checksum.
+Uint32 run_game_headless(int ticks, Uint32 seed) {
+    GameSimulation sim;
+    memset(&sim, 0, sizeof(sim));
+    sim.arena_w = 1180;
+    sim.arena_h = 620;
+    sim.players[0] = (PlayerState){250.0f, 10.0f, 0.0f, 0.0f, 200, 300};
+    sim.players[1] = (PlayerState){800.0f, 10.0f, 0.0f, 0.0f, 200, 300};
+
+    PlayerInput inputs[2];
+    Uint32 state = seed ? seed : 1u;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int t = 0; t < ticks; t++) {
+        // Change the held keys every 30 ticks (~250ms)
+        if (t % 30 == 0) {
+            for (int i = 0; i < 2; i++) {
+                state = state * 1664525u + 1013904223u;
+                inputs[i].left  = (state >> 28) & 1;
+                inputs[i].right = (state >> 29) & 1;
+                inputs[i].up    = (state >> 30) & 1;
+                inputs[i].down  = (state >> 31) & 1;
+            }
+        }
+        game_step(&sim, inputs);
+    }
+    Uint64 end = SDL_GetPerformanceCounter();
+
+    double ms = (double)(end - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    Uint32 checksum = game_state_checksum(&sim);
+    printf("Headless simulation: %d ticks in %.3f ms (%.1f ns/tick), checksum %08X\n",
+           ticks, ms, ticks > 0 ? ms * 1e6 / ticks : 0.0, checksum);
+    return checksum;
+}
@@ -6,6 +6,14 @@
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
 
+// Screen dimensions (adjust as needed)
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+
+// Capacity of the global sequence array
+#define MAX_SEQUENCES 100
+#define MAX_ROUND_SEQUENCES 50
+
 // Color structure for RGBA
 typedef struct {
     Uint8 r;
@@ -18,7 +26,7 @@ typedef struct {
 typedef struct {
     int id;                    // Unique identifier
     char name[64];             // Name of the sequence
-    int x, y;                  // Position on screen
+    int x, y;                  // Position on screen (world, cached by the scene graph)
     int w, h;                  // Size (width, height)
     Color color;               // Background color (RGBA)
     char text_content[256];    // Text to display
@@ -31,8 +39,11 @@ typedef struct {
     Color text_color;          // Text color
     int visible;               // Visibility flag (1 = visible, 0 = hidden)
     SDL_Texture* image;        // Image texture to display
+    int image_shared;          // 1 = image belongs to the scene texture cache (not destroyed here)
     int image_width;           // Original image width
     int image_height;          // Original image height
+    int animation;             // Animation instance drawn instead of the image (-1 = none)
+    int text_label;            // Rasterized text_content / input text (-1 = none, see text.c)
     // Input field fields
     int is_input;              // 1 = this sequence is an input field
     int is_focused;            // 1 = currently active / receiving input
@@ -41,8 +52,48 @@ typedef struct {
     int cursor_pos;            // Cursor position in input_buffer
     int cursor_visible;        // Cursor blink state (1 = shown)
     Uint32 cursor_timer;       // Timer for cursor blinking
+    // Spectrum widget fields
+    int is_spectrum;           // 1 = this sequence shows the audio spectrum
+    Color bar_color;           // Color of the spectrum bars
+    // Scene graph fields
+    int parent;                // Index of parent sequence (-1 = root)
+    int first_child;           // Index of first child (-1 = none)
+    int next_sibling;          // Index of next sibling (-1 = none)
+    int local_x, local_y;      // Position relative to parent (or screen for roots)
+    Uint8 opacity;             // Group opacity applied to the whole subtree (255 = opaque)
+    Uint8 world_opacity;       // Cached opacity combined with all ancestors
+    int world_visible;         // Cached: visible and all ancestors visible
+    SDL_Rect subtree_bounds;   // Cached world bounds of this sequence and its children
+    int dirty;                 // Own transform changed since last scene graph update
+    int subtree_dirty;         // This sequence or a descendant needs an update
+    int cull_flags;            // CULL_* flags set by the culling pass each frame
+    Uint32 generation;         // Bumped on every real change (setters, world transform)
 } Sequence;
 
+// Audio analysis published by the post-mix callback (spectrum.c)
+#define SPECTRUM_BANDS 16
+typedef struct {
+    float level;                    // Smoothed loudness (0..1 over -60..0 dBFS)
+    float rms;                      // RMS of the last mixed buffer (0..1)
+    float peak;                     // Peak sample of the last mixed buffer (0..1)
+    float bands[SPECTRUM_BANDS];    // Smoothed band levels, low to high (0..1)
+    Uint32 sequence;                // Number of buffers analysed
+} AudioAnalysis;
+
+// Culling flags (Sequence.cull_flags)
+#define CULL_SELF 0x1          // Sequence itself is not drawn (children may be)
+#define CULL_FILL 0x2          // Background fill is skipped (zero alpha)
+
+// Per-frame culling statistics
+typedef struct {
+    int tested;                // Sequences visited by the culling pass
+    int subtrees_culled;       // Hidden / transparent / off-screen subtrees skipped
+    int offscreen;             // Sequences whose own rect is off-screen
+    int occluded;              // Sequences fully covered by an opaque rect above
+    int fills_dropped;         // Zero-alpha fills skipped
+    int drawn;                 // Sequences drawn
+} CullStats;
+
 // Round Sequence structure - circular/round screen element
 typedef struct {
     int id;                    // Unique identifier
@@ -57,30 +108,765 @@ typedef struct {
     int visible;               // Visibility flag (1 = visible, 0 = hidden)
     int filled;                // 1 = filled circle, 0 = outline only
     int outline_thickness;     // Thickness of outline (if not filled)
+    Uint32 generation;         // Bumped on every real change made through the setters
 } RoundSequence;
 
-// Background structure
+// Fonts opened for sequences, shared by every sequence using the same file
+// and size. Unused fonts stay open so a scene built again finds them.
+#define SEQUENCE_MAX_FONTS 16
+
+typedef struct {
+    char path[256];
+    int size;
+    TTF_Font* font;
+    int refcount;              // Sequences using the font
+} SequenceFont;
+
+// Parallax background limits
+#define BACKGROUND_MAX_LAYERS 8
+#define BACKGROUND_TILE_SIZE 256       // Tile edge in pixels
+#define BACKGROUND_TILE_CACHE 48       // Resident tiles per layer (a 1280x720 view needs 35)
+#define BACKGROUND_TILE_LOADS 8        // Tile files decoding on the job workers at once
+
+// A tile uploaded to the GPU with a 1px border (from its neighbours when the
+// layer is one image, from its own edge when tiles are separate files)
 typedef struct {
     SDL_Texture* texture;
-    SDL_Rect dest_rect;
-    int width;
+    int col, row;              // Tile coordinates in the layer (-1 = free)
+    Uint32 last_used;          // Frame the tile was last drawn (oldest is evicted first)
+} BackgroundTile;
+
+// A tile file being decoded on a job worker
+typedef struct {
+    int active;                // Slot in use
+    int layer;                 // Layer index
+    int col, row;
+    char path[300];
+    SDL_Surface* surface;      // Decoded tile (NULL if the file could not be read)
+    SDL_atomic_t done;         // Set by the worker once 'surface' is written
+    int failed;                // Kept so a missing file is not read again every frame
+    Uint32 requested;          // Frame the tile was last wanted
+} BackgroundTileLoad;
+
+// One parallax layer
+typedef struct {
+    SDL_Surface* source;       // Whole layer image (NULL when tiles are separate files)
+    char tile_pattern[256];    // printf pattern taking (col, row) for tiled layers
+    int width, height;         // Layer size in pixels
+    int cols, rows;            // Layer size in tiles
+    float speed_x, speed_y;    // Parallax factor (0 = fixed, 1 = moves with the camera)
+    float scroll_x, scroll_y;  // Automatic scroll in pixels per second
+    float offset_x, offset_y;  // Accumulated automatic scroll (sub-pixel)
+    int wrap_x, wrap_y;        // 1 = layer repeats along this axis
+    Color placeholder;         // Drawn where a tile is still loading (average of the last one)
+    BackgroundTile tiles[BACKGROUND_TILE_CACHE];
+} BackgroundLayer;
+
+// Background structure
+typedef struct {
+    BackgroundLayer layers[BACKGROUND_MAX_LAYERS];  // Drawn back to front
+    int layer_count;
+    float camera_x, camera_y;  // Camera position the layers scroll against
+    Uint32 frame;              // Frames drawn (tile cache clock)
+    int tiles_drawn;           // Statistics
+    int tile_uploads;
+    int tile_evictions;
+    int tiles_pending;         // Tiles drawn as a placeholder while their file decodes
+    int width;                 // Size of the first layer
     int height;
     Mix_Music* music;      // Background music
     int music_volume;       // Volume (0-128)
+    int streaming;          // 1 = music is decoded incrementally (music_stream.c)
+    char music_path[256];   // Track being streamed
 } Background;
 
+// Job system limits
+#define JOB_MAX_WORKERS 16             // Including the main thread
+#define JOB_DEQUE_SIZE 1024            // Jobs per worker deque (power of two)
+#define JOB_MAX_CONTINUATIONS 16       // Jobs waiting on one counter
+#define JOB_MAX_PRELOAD 32             // Images decoded ahead of time
+
+typedef struct JobCounter JobCounter;
+
+// A unit of work run on any worker
+typedef struct {
+    void (*function)(void* data);
+    void* data;
+    JobCounter* counter;       // Decremented when the job finishes (set by run_jobs)
+} Job;
+
+// Number of unfinished jobs, plus the jobs waiting for it to reach zero
+struct JobCounter {
+    SDL_atomic_t pending;
+    SDL_SpinLock lock;
+    int continuation_count;
+    Job continuations[JOB_MAX_CONTINUATIONS];
+};
+
+typedef void (*ParallelForFunction)(int begin, int end, void* data);
+
+// Text pipeline limits
+#define TEXT_MAX_FONTS 16              // Distinct (path, size) pairs
+#define TEXT_MAX_LABELS 192            // Labels with a cached rasterization
+#define TEXT_UPLOADS_PER_FRAME 8       // Finished rasterizations uploaded per frame
+
+// A font opened once per job worker (SDL_ttf fonts are not thread-safe)
+typedef struct {
+    char path[256];
+    int size;
+    int instance_count;
+    TTF_Font* instances[JOB_MAX_WORKERS];
+} TextFont;
+
+// Rasterized text owned by a widget. The texture is rendered white and
+// tinted when drawn, so color and opacity changes never re-rasterize.
+typedef struct {
+    int active;
+    int font;                  // TextFont index
+    char text[256];            // Latest requested text
+    Uint32 generation;         // Bumped each time the text changes
+    Uint32 shown_generation;   // Generation of the text in 'texture' (on screen)
+    SDL_Texture* texture;      // Pooled texture holding the last uploaded text, shown
+                               // until the next one is ready
+    int w, h;                  // Text size (top-left corner of the texture)
+    // Job state, owned by the worker while in_flight is set
+    int in_flight;
+    int released;              // Freed by its owner while a job was running
+    char job_text[256];
+    Uint32 job_generation;
+    SDL_Surface* job_surface;
+} TextLabel;
+
+// Texture pool limits (size classes are powers of two from the minimum)
+#define TEXTURE_POOL_MAX 256           // Pooled textures, free or in use
+#define TEXTURE_POOL_MIN_WIDTH 32
+#define TEXTURE_POOL_MIN_HEIGHT 16
+
+// A streaming texture owned by the pool
+typedef struct {
+    SDL_Texture* texture;      // NULL = empty slot
+    int w, h;                  // Size class
+    int in_use;                // Borrowed by a label
+    int released_at;           // Release order (oldest free texture is recycled first)
+} PooledTexture;
+
+// Texture pool counters
+typedef struct {
+    int hits;                  // Requests served without creating a texture (kept or free)
+    int misses;                // Requests that created a texture
+    int evictions;             // Free textures destroyed for another class or the budget
+    int uploads;               // Texture updates through SDL_LockTexture
+    int releases;              // Textures given back
+    int in_use;                // Textures currently borrowed
+    size_t bytes;              // Memory of all pooled textures
+    size_t peak_bytes;         // Highest value of bytes
+} TexturePoolStats;
+
+// Frame arena and scratch surface limits
+#define FRAME_ARENA_SIZE (16 * 1024 * 1024)   // Transient bytes per frame (100k particle quads fit)
+#define SCRATCH_SURFACE_POOL 8                // Reusable ARGB8888 surfaces
+
+// Heap and frame arena counters
+typedef struct {
+    int allocations;           // SDL_malloc / calloc / realloc calls so far
+    int frees;                 // SDL_free calls so far
+    size_t arena_used;         // Frame arena bytes used this frame
+    size_t arena_peak;         // Highest frame arena use
+    int arena_overflows;       // Requests the arena could not satisfy
+    int scratch_hits;          // Scratch surfaces reused from the pool
+    int scratch_misses;        // Scratch surfaces that had to be created
+} MemoryStats;
+
+// Reactive binding limits
+#define BINDING_MAX_OBSERVABLES 512    // Observable values
+#define BINDING_MAX_BINDINGS 1024      // Subscriptions across all observables
+#define OBSERVABLE_TEXT_SIZE 256       // Longest text value (with terminator)
+
+// Observables created by init_bindings()
+#define OBSERVABLE_MUSIC_VOLUME 0      // Background music volume (0..128)
+#define OBSERVABLE_MUSIC_PAUSED 1      // 1 while the background music is paused
+#define OBSERVABLE_INPUT_TEXT 2        // Buffer of the input field edited last
+#define OBSERVABLE_FOCUS 3             // Index of the focused input field (-1 = none)
+
+// A value that notifies its subscribers when it changes
+typedef struct {
+    int active;
+    char name[64];
+    int is_text;               // Text value instead of an integer
+    int value;                 // Integer value
+    char text[OBSERVABLE_TEXT_SIZE]; // Text value
+    int pending;               // Changed since the last flush
+    int first_binding;         // Head of the subscriber list (-1 = none)
+} Observable;
+
+// Turn an observable into the text a widget shows
+typedef void (*BindingFormatter)(const Observable* obs, char* text, size_t size);
+// Called with the observable's new value
+typedef void (*BindingCallback)(const Observable* obs, void* data);
+
+// One subscription: a (round) sequence text with a formatter, or a callback
+typedef struct {
+    int active;
+    int observable;
+    Sequence* sequence;        // Text target (may be NULL)
+    RoundSequence* round;      // Text target (may be NULL)
+    BindingFormatter formatter; // NULL = plain value
+    BindingCallback callback;  // Used when there is no text target
+    void* data;                // Passed to the callback
+    int next;                  // Next subscriber of the same observable (-1 = none)
+} Binding;
+
+// Binding counters
+typedef struct {
+    int changes;               // Observable writes that changed the value
+    int flushes;               // Observables propagated (once per frame at most)
+    int notifications;         // Subscribers updated
+} BindingStats;
+
+// Key binding table (open addressing, size must be a power of two)
+#define CONTROL_TABLE_SIZE 256
+#define CONTROL_MAX_BINDINGS 192       // Keeps the table at most 75% full
+
+// Focus context a key binding applies in
+#define CONTROL_CONTEXT_ANY 0          // Always
+#define CONTROL_CONTEXT_GAME 1         // No input field focused
+#define CONTROL_CONTEXT_TEXT 2         // An input field has the focus
+
+// Modifier flags of a key binding (left and right keys are not told apart)
+#define CONTROL_MOD_SHIFT 0x1
+#define CONTROL_MOD_CTRL 0x2
+#define CONTROL_MOD_ALT 0x4
+#define CONTROL_MOD_GUI 0x8
+
+// Called for a key press that matches a binding
+typedef void (*ControlHandler)(const SDL_Event* event, void* data);
+
+// One slot of the key binding table
+typedef struct {
+    int used;                  // Holds a binding
+    int deleted;               // Tombstone left by unbind_key (probing continues)
+    SDL_Keycode key;
+    Uint8 mods;                // CONTROL_MOD_* flags that must be held (0 = any)
+    Uint8 context;             // CONTROL_CONTEXT_*
+    ControlHandler handler;
+    void* data;
+} KeyBinding;
+
+// Keyboard / mouse state sampled once per frame
+typedef struct {
+    Uint8 keys[SDL_NUM_SCANCODES];  // 1 = held (live keyboard or replay)
+    Uint8 mods;                // CONTROL_MOD_* flags held
+    int mouse_x, mouse_y;      // Last known pointer position
+    Uint32 mouse_buttons;      // SDL_BUTTON() mask of held buttons
+} InputSnapshot;
+
+// Player actions that can be rebound
+typedef enum {
+    PLAYER_ACTION_LEFT,
+    PLAYER_ACTION_UP,
+    PLAYER_ACTION_RIGHT,
+    PLAYER_ACTION_DOWN,
+    PLAYER_ACTION_COUNT
+} PlayerAction;
+
+// Collision limits
+#define COLLISION_MAX_COLLIDERS 4096   // Ids must fit in 16 bits (pair keys)
+#define COLLISION_MAX_CONTACTS 16384   // Contact pairs tracked per update
+
+typedef enum {
+    COLLIDER_BOX,
+    COLLIDER_CIRCLE
+} ColliderShape;
+
+// A box or circle collider, optionally following a (round) sequence
+typedef struct {
+    int active;
+    ColliderShape shape;
+    float x, y;                // Box: top-left corner, circle: center
+    float w, h;                // Box size
+    float radius;              // Circle radius
+    Sequence* sequence;        // Box follows this sequence's world rect (may be NULL)
+    RoundSequence* round;      // Circle follows this round sequence (may be NULL)
+    Uint32 generation;         // Generation of the followed sequence at the last sync
+} Collider;
+
+typedef enum {
+    COLLISION_BEGIN,           // The pair started touching this update
+    COLLISION_END              // The pair stopped touching (or a collider was removed)
+} CollisionEventType;
+
+// A change in contact between colliders a < b
+typedef struct {
+    CollisionEventType type;
+    int a, b;
+    float x, y;                // Contact point (COLLISION_BEGIN only)
+} CollisionEvent;
+
+// Per-update collision statistics
+typedef struct {
+    int colliders;
+    int narrow_tests;          // Candidate pairs that reached the exact test
+    int sort_moves;            // Insertion sort moves needed to restore the sweep order
+    int contacts;
+    int events;
+} CollisionStats;
+
+// Particle limits
+#define PARTICLE_MAX_EMITTERS 16
+#define PARTICLE_PALETTE_SIZE 8
+#define PARTICLE_FLOAT_ARRAYS 7        // x, y, vx, vy, age, inv_life, fade
+
+// How an emitter spawns and moves its particles
+typedef struct {
+    float direction;           // Mean launch angle in radians (0 = right, pi/2 = down)
+    float spread;              // Launch cone width in radians (2 pi = all directions)
+    float speed_min, speed_max;    // Launch speed in pixels per second
+    float life_min, life_max;      // Lifetime in seconds
+    float gravity;             // Downward acceleration in pixels per second^2
+    float drag;                // Fraction of velocity kept after one second
+    float size;                // Quad edge in pixels at spawn
+    SDL_BlendMode blend;
+    Color palette[PARTICLE_PALETTE_SIZE];  // Spawn colors, picked at random
+    int palette_size;
+} ParticleEmitterConfig;
+
+// An emitter and its live particles (structure of arrays, packed)
+typedef struct {
+    int active;
+    char name[32];
+    ParticleEmitterConfig config;
+    int capacity;
+    int count;                 // Live particles (indices 0 .. count - 1)
+    float* storage;            // Block holding the float arrays below
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* age;
+    float* inv_life;
+    float* fade;               // 1 at spawn, 0 when dead
+    SDL_Color* colors;
+    int* indices;              // Six per particle, built once (vertices come from the frame arena)
+} ParticleEmitter;
+
+// Tween limits and options
+#define TWEEN_MAX 4096
+
+typedef enum {
+    EASE_LINEAR,
+    EASE_IN_QUAD,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_QUAD,
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_SINE,
+    EASE_OUT_BACK
+} EaseType;
+
+// Property driven by a tween (channels used: position 2, size 2, color 4, alpha 1, radius 1)
+typedef enum {
+    TWEEN_POSITION,            // Local position (round sequences: center)
+    TWEEN_SIZE,                // Width / height (round sequences: diameter)
+    TWEEN_COLOR,               // Fill color RGBA
+    TWEEN_ALPHA,               // Group opacity (round sequences: fill alpha)
+    TWEEN_RADIUS               // Round sequences only
+} TweenProperty;
+
+// Animation pools
+#define ANIM_MAX_SHEETS 16
+#define ANIM_MAX_CLIPS 64
+#define ANIM_MAX_FRAMES 512
+#define ANIM_MAX_INSTANCES 256
+
+// One frame of a clip: a region of the sheet texture shown for a duration
+typedef struct {
+    SDL_Rect region;
+    int duration_ms;
+} AnimationFrame;
+
+// A named run of frames of a sheet
+typedef struct {
+    char name[32];
+    int sheet;                 // Owning sheet
+    int first_frame;           // Index of the first frame in the frame pool
+    int frame_count;
+    int total_ms;              // Duration of one cycle
+    int loop;                  // 1 = loop, 0 = stop on the last frame
+} AnimationClip;
+
+// A texture atlas and its clips, shared by every instance using it
+typedef struct {
+    char path[256];            // Description file (used to share loaded sheets)
+    char image[256];           // Atlas image (its texture comes from the scene texture cache)
+    SDL_Texture* texture;      // Held while the sheet is referenced (NULL when unused)
+    int first_clip;            // Index of the first clip in the clip pool
+    int clip_count;
+    int refcount;              // Sequences animated with this sheet, plus the loader
+} SpriteSheet;
+
+// Playback state of one animated sequence
+typedef struct {
+    int active;
+    int clip;                  // Clip being played
+    int frame;                 // Frame within the clip
+    float time_ms;             // Time spent on the current frame
+    float speed;               // Playback rate
+    int finished;              // Non-looping clip reached its last frame
+} AnimationInstance;
+
+// Tilemap chunking
+#define TILEMAP_CHUNK_TILES 16         // Chunk edge in tiles
+#define TILEMAP_CHUNK_CACHE 32         // Baked chunks kept (a 1280x720 view needs 12 at 32px tiles)
+
+// A chunk of tiles baked into a render-target texture
+typedef struct {
+    SDL_Texture* texture;
+    int chunk_x, chunk_y;      // Chunk coordinates (-1 = free slot)
+    Uint32 version;            // Chunk version baked into the texture (0 = none)
+    Uint32 last_used;          // Frame the chunk was last drawn (oldest is evicted first)
+} TilemapChunk;
+
+// Tile map structure
+typedef struct {
+    SDL_Texture* tileset;      // Tiles laid out in a grid
+    int tileset_cols;          // Tiles per tileset row
+    int tile_size;             // Tile edge in pixels
+    int width, height;         // Map size in tiles
+    Uint16* tiles;             // width * height tiles (0 = empty, n = tileset tile n - 1)
+    int chunk_cols, chunk_rows;
+    Uint32* chunk_versions;    // Bumped when a tile of the chunk changes
+    TilemapChunk cache[TILEMAP_CHUNK_CACHE];
+    float camera_x, camera_y;  // Top-left of the view in map pixels
+    Uint32 frame;              // Frames drawn (chunk cache clock)
+    int chunks_drawn;          // Statistics
+    int chunk_bakes;
+    int chunk_evictions;
+} Tilemap;
+
+// Audio engine limits
+#define AUDIO_VOICES 16            // Mixer channels shared by all sound effects
+#define AUDIO_MAX_SOUNDS 64        // Capacity of the sound effect bank
+#define AUDIO_QUEUE_SIZE 256       // Command queue slots (power of two)
+
+// A decoded sound effect in the bank
+typedef struct {
+    char name[64];             // Name used by play_sound()
+    Mix_Chunk* chunk;          // Decoded samples
+    int priority;              // Default priority (higher = more important)
+} SoundEffect;
+
+// Bookkeeping for one mixer channel
+typedef struct {
+    int sound;                 // Sound id playing on this voice (-1 = none)
+    int priority;              // Priority it was started with
+    Uint32 start_tick;         // When it started (older voices are stolen first)
+} Voice;
+
+// Commands sent from game code to the audio control thread
+typedef enum {
+    AUDIO_CMD_PLAY,
+    AUDIO_CMD_STOP_ALL
+} AudioCommandType;
+
+typedef struct {
+    AudioCommandType type;
+    int sound;                 // Sound id (AUDIO_CMD_PLAY)
+    int priority;              // Voice stealing priority
+    int volume;                // 0-128
+} AudioCommand;
+
+// Slot of the lock-free command queue
+typedef struct {
+    SDL_atomic_t sequence;     // Slot state for the bounded MPSC queue
+    AudioCommand command;
+} AudioQueueSlot;
+
+// Audio engine state
+typedef struct {
+    int opened;                // 1 = device is open
+    int frequency;             // Actual output rate
+    Uint16 format;             // Actual sample format
+    int channels;              // Actual channel count
+    int buffer_samples;        // Mixer buffer size in sample frames
+    SoundEffect sounds[AUDIO_MAX_SOUNDS];
+    int sound_count;
+    Voice voices[AUDIO_VOICES];
+    AudioQueueSlot queue[AUDIO_QUEUE_SIZE];
+    SDL_atomic_t queue_head;   // Next slot producers claim
+    int queue_tail;            // Next slot the control thread reads
+    SDL_sem* wake;             // Signals the control thread
+    SDL_Thread* thread;        // Audio control thread
+    SDL_atomic_t quit;
+    int played;                // Statistics
+    int stolen;
+    int dropped;
+    SDL_atomic_t queue_overflows;
+    SDL_atomic_t active_voices;  // Effect voices playing (drives music ducking)
+} AudioEngine;
+
+// Linear gain ramp applied per sample frame (gain.c)
+typedef struct {
+    float current;             // Gain of the next frame
+    float target;              // Gain at the end of the ramp
+    float step;                // Change per frame
+    int remaining;             // Frames left in the ramp (0 = steady)
+} GainRamp;
+
+// Fixed simulation rate for the game
+#define GAME_TICK_RATE 120
+#define GAME_TICK_DT (1.0f / GAME_TICK_RATE)
+
+// State of one player character (position relative to the arena)
+typedef struct {
+    float x, y;                // Top-left position
+    float vx, vy;              // Velocity in pixels per second
+    int w, h;                  // Size
+} PlayerState;
+
+// Directional controls held by one player during a tick
+typedef struct {
+    Uint8 left, right, up, down;
+} PlayerInput;
+
+// Fixed-timestep game simulation
+typedef struct {
+    PlayerState players[2];    // State after the last tick
+    PlayerState previous[2];   // State before the last tick (for interpolation)
+    Uint64 tick;               // Number of ticks simulated
+    double accumulator;        // Real time not yet simulated (seconds)
+    int arena_w, arena_h;      // Area the players are confined to
+    Sequence* sequences[2];    // Sequences that display the players (may be NULL)
+} GameSimulation;
+
+// Render layers (drawn from lowest to highest)
+enum {
+    RENDER_LAYER_BACKGROUND = 0,
+    RENDER_LAYER_SEQUENCES  = 1,
+    RENDER_LAYER_ROUND      = 2,
+    RENDER_LAYER_OVERLAY    = 3
+};
+
+// Draw command types understood by the render queue
+typedef enum {
+    RQ_FILL_RECT,
+    RQ_OUTLINE_RECT,
+    RQ_TEXTURE,
+    RQ_TEXTURE_F,
+    RQ_GLYPH_RUN,
+    RQ_CIRCLE,
+    RQ_GEOMETRY
+} RenderCommandType;
+
+// A single queued draw command
+typedef struct {
+    RenderCommandType type;
+    int layer;                 // Render layer (see RENDER_LAYER_*)
+    int order;                 // Submission index within the frame
+    int slot;                  // Overlap depth used to keep overlapping commands ordered
+    SDL_BlendMode blend;       // Blend mode for shape commands
+    Color color;               // Draw color, or alpha modulation for textures
+    SDL_Texture* texture;      // Texture for textured quads / glyph runs
+    SDL_Rect src;              // Source rect (if has_src)
+    int has_src;
+    SDL_Rect bounds;           // Destination rect / bounding box
+    SDL_FRect dest_f;          // Sub-pixel destination (RQ_TEXTURE_F)
+    int filled;                // Circles: 1 = filled, 0 = outline
+    int thickness;             // Circles: outline thickness
+    int owns_texture;          // 1 = destroy texture after drawing
+    const SDL_Vertex* vertices;    // Triangle mesh (RQ_GEOMETRY), owned by the caller
+    const int* indices;
+    int vertex_count;
+    int index_count;
+} RenderCommand;
+
+// Per-frame render queue statistics
+typedef struct {
+    int commands;              // Commands queued
+    int state_changes;         // Blend / color / texture state changes issued
+    int submissions;           // Draw calls issued to SDL
+} RenderQueueStats;
+
+// Phases of a frame measured by the profiler
+typedef enum {
+    PROFILE_EVENTS,
+    PROFILE_UPDATE,
+    PROFILE_RENDER,
+    PROFILE_PRESENT
+} ProfilePhase;
+
+// Timing and counters of one frame
+typedef struct {
+    double total_ms;           // Whole frame
+    double events_ms;          // Event polling / replay
+    double update_ms;          // Simulation and UI updates
+    double render_ms;          // Culling, command building and submission
+    double present_ms;         // SDL_RenderPresent (includes vsync wait)
+    int draw_commands;         // Render queue commands
+    int state_changes;         // Render state changes
+    int submissions;           // Draw calls
+    int sequences_drawn;       // Sequences that survived culling
+    float worker_utilization;  // Busy share of all job workers during the frame (0..1)
+    int jobs_run;              // Jobs completed during the frame
+    int allocations;           // SDL heap allocations during the frame
+} FrameProfile;
+
+// Input latency instrumentation limits
+#define LATENCY_MAX_SAMPLES 16384      // Input events measured per session
+#define LATENCY_MAX_PENDING 256        // Events waiting for the frame that draws them
+
+// One input event, from its arrival to the present of the frame that drew it
+typedef struct {
+    Uint64 arrival;            // Performance counter at arrival (from the event timestamp)
+    Uint64 polled;             // Performance counter when the loop received it
+    Uint32 type;               // SDL event type
+    Uint32 frame;              // Frame that drew its effect
+    int late;                  // Received by the late latch and drawn in the same frame
+    int deferred;              // Waits one more present (its update had already run)
+    int label;                 // Text label it edited (-1 = none)
+    Uint32 text_generation;    // Label text it produced: drawn once that text is uploaded
+    double queue_ms;           // Arrival to poll
+    double total_ms;           // Arrival to SDL_RenderPresent returning
+} LatencySample;
+
+// Scene manager limits
+#define SCENE_MAX_SCENES 8
+#define SCENE_MAX_IMAGES 8             // Images declared by one scene
+#define SCENE_TEXTURE_CACHE 32         // Scene images kept on the GPU (unused ones are evicted oldest first)
+#define SCENE_UPLOADS_PER_FRAME 2      // Decoded scene images uploaded per frame
+#define SCENE_MAX_CACHED 2             // Built scenes kept besides the active one (the next one and the last left)
+
+typedef enum {
+    SCENE_UNLOADED,            // Nothing loaded
+    SCENE_LOADING,             // Images decoding in the background
+    SCENE_READY,               // Built, can be entered without loading anything
+    SCENE_ACTIVE               // Its pools are the ones drawn and updated
+} SceneState;
+
+typedef void (*SceneFunction)(int scene, SDL_Renderer* renderer);
+typedef void (*SceneUpdateFunction)(int scene, double frame_seconds);
+
+// What a scene declares: its assets, the scene to preload while it runs and
+// its callbacks (all optional)
+typedef struct {
+    const char* next;                      // Scene preloaded while this one is active
+    const char* images[SCENE_MAX_IMAGES];  // Decoded and uploaded before the build
+    int image_count;
+    SceneFunction build;       // Create the sequences (runs with the scene's pools swapped in)
+    SceneFunction enter;       // The scene became the active one
+    SceneFunction leave;       // The scene stops being the active one (it stays built)
+    SceneFunction unload;      // Undo what the build registered outside the pools (colliders, ...)
+    SceneUpdateFunction update;            // Once per frame while active
+} SceneConfig;
+
+// An image shared by every scene declaring it
+typedef struct {
+    char path[256];
+    SDL_Texture* texture;      // NULL until decoded and uploaded
+    int w, h;
+    SDL_Surface* surface;      // Decoded by a worker, waiting for its upload
+    SDL_atomic_t decoded;      // Set by the worker once 'surface' is written
+    int decoding;              // A decode job owns the entry
+    int failed;                // The image could not be loaded
+    int refcount;              // Loaded scenes declaring the image, plus sprite sheets drawing from it
+    Uint32 released_at;        // Frame it last became unused
+} SceneTexture;
+
+// A scene owns its sequence pools; entering it swaps them in
+typedef struct {
+    char name[32];
+    SceneConfig config;
+    SceneState state;
+    int textures[SCENE_MAX_IMAGES];        // SceneTexture index of each declared image
+    Sequence sequences[MAX_SEQUENCES];
+    int sequence_count;
+    RoundSequence round_sequences[MAX_ROUND_SEQUENCES];
+    int round_sequence_count;
+    Uint32 left_at;            // Frame it was last active (least recent is unloaded first)
+} Scene;
+
+typedef struct {
+    int switches;              // Scenes entered
+    int preloaded;             // ... that were ready when entered
+    int loaded_on_demand;      // ... that had to finish loading first (a hitch)
+    int builds;                // Scenes built
+    int unloads;               // Scenes released to stay within SCENE_MAX_CACHED
+    int uploads;               // Images uploaded
+    int texture_hits;          // Declared images already in the texture cache
+    int images_evicted;        // Unused images destroyed to stay within the budget
+} SceneStats;
+
+// Settings (function_settings.c) and their auto-tune (main_settings.c)
+#define SETTINGS_DEFAULT_PATH "settings.bin"
+#define SETTINGS_VSYNC_OFF 0
+#define SETTINGS_VSYNC_ON 1
+
+// Render quality knobs, picked for the machine and kept in the settings file
+typedef struct {
+    int vsync;                 // SETTINGS_VSYNC_*
+    int target_fps;            // Frame limiter (0 = unlimited)
+    int text_cache_kb;         // Pooled text textures kept allocated (texture_pool.c)
+    int texture_budget_kb;     // Unused scene images kept on the GPU (scene_manager.c)
+    int particle_limit;        // Live particles over all emitters
+    int audio_buffer_samples;  // Mixer buffer in sample frames (0 = audio engine default)
+    int tuned;                 // 1 = values picked by the auto-tune benchmark
+} Settings;
+
+// What the auto-tune measured
+typedef struct {
+    double fill_mpixels;       // Blended fill rate (megapixels per second, 0 = not measured)
+    double text_us;            // Rasterization of one label (microseconds, 0 = no font)
+    double audio_us[5];        // Post-mix processing per buffer of 256 .. 4096 frames
+    int refresh_rate;          // Display refresh rate (Hz)
+} SettingsBenchmark;
+
 // Global variables
 extern Background background;
-extern Sequence sequences[100];  // Array to hold sequences
+extern Tilemap tilemap;
+extern AudioEngine audio;
+extern GameSimulation game;
+extern Sequence* sequences;      // Sequence pool of the active scene
 extern int sequence_count;       // Current number of sequences
-extern RoundSequence round_sequences[50];  // Array to hold round sequences
+extern RoundSequence* round_sequences;     // Round sequence pool of the active scene
 extern int round_sequence_count;           // Current number of round sequences
 
 // Background-related function declarations
 int init_background(SDL_Renderer* renderer, const char* image_path);
 void draw_background(SDL_Renderer* renderer);
-void update_background(void);
+void update_background(double frame_seconds);
 void cleanup_background(void);
+int add_background_layer(const char* image_path, float speed_x, float speed_y, int wrap_x, int wrap_y);
+int add_background_tiled_layer(const char* tile_pattern, int width, int height,
+                               float speed_x, float speed_y, int wrap_x, int wrap_y);
+void set_background_layer_scroll(int layer, float pixels_per_second_x, float pixels_per_second_y);
+void set_background_camera(float x, float y);
+void print_background_stats(void);
+
+// Tilemap functions
+int init_tilemap(SDL_Renderer* renderer, const char* tileset_path, int tile_size,
+                 int width, int height);
+void set_tilemap_tile(int x, int y, Uint16 tile);
+Uint16 get_tilemap_tile(int x, int y);
+void set_tilemap_camera(float x, float y);
+void draw_tilemap(SDL_Renderer* renderer);
+void draw_tilemap_direct(SDL_Renderer* renderer);
+void invalidate_tilemap_cache(void);
+void print_tilemap_stats(void);
+void cleanup_tilemap(void);
+
+// Animation functions
+int load_sprite_sheet(const char* path);
+int find_animation_clip(int sheet, const char* name);
+void release_sprite_sheet(int sheet);
+int play_sequence_animation(Sequence* seq, int sheet, const char* clip_name);
+void set_animation_clip(int instance, const char* clip_name);
+void set_animation_speed(int instance, float speed);
+void stop_sequence_animation(Sequence* seq);
+void update_animations(double frame_seconds);
+int get_sequence_animation_frame(const Sequence* seq, SDL_Texture** texture, SDL_Rect* region);
+void animate_players(const GameSimulation* sim);
+void cleanup_animations(void);
+
+// Benchmark functions
+int run_benchmarks(SDL_Renderer* renderer, const char* name);
 
 // Background music functions
 int init_background_music(const char* music_path, int volume);
@@ -92,6 +878,45 @@ void set_background_music_volume(int volume);
 int get_background_music_volume(void);
 int is_music_playing(void);
 int is_music_paused(void);
+int change_background_music(const char* music_path, int fade_ms);
+
+// Music streaming functions
+int can_stream_music(const char* path);
+int start_music_stream(void);
+int play_music_stream(const char* path, int loop, int crossfade_ms);
+void stop_music_stream(void);
+void set_music_stream_paused(int paused);
+int is_music_stream_paused(void);
+int is_music_stream_playing(void);
+void set_music_stream_volume(int volume);
+void set_music_ramp_time(int ms);
+void set_music_pause_fade(int ms);
+void set_music_ducking(int level, int attack_ms, int release_ms);
+void shutdown_music_stream(void);
+
+// Audio engine functions
+int init_audio_engine(int frequency, int buffer_samples);
+int choose_audio_buffer_size(int frequency);
+void shutdown_audio_engine(void);
+int load_sound(const char* name, const char* path, int priority, int volume);
+int find_sound(const char* name);
+int play_sound_id(int sound, int priority, int volume);
+int play_sound(const char* name);
+void stop_all_sounds(void);
+int get_active_voice_count(void);
+
+// Gain ramp functions (audio thread)
+void init_gain_ramp(GainRamp* ramp, float gain);
+void start_gain_ramp(GainRamp* ramp, float target, int frames);
+void apply_gain_ramp(GainRamp* ramp, Sint16* samples, int frames);
+
+// Audio analysis / spectrum widget functions
+int start_audio_analysis(void);
+const AudioAnalysis* get_audio_analysis(void);
+void stop_audio_analysis(void);
+double time_audio_analysis(Sint16* samples, int frames, int runs);
+void set_sequence_spectrum(Sequence* seq, Color bar_color);
+void draw_spectrum_sequence(SDL_Renderer* renderer, Sequence* seq);
 
 // Sequence-related function declarations
 void init_sequences(void);
@@ -101,14 +926,142 @@ void draw_sequence(SDL_Renderer* renderer, Sequence* seq);
 void draw_all_sequences(SDL_Renderer* renderer);
 Sequence* get_sequence_by_id(int id);
 Sequence* get_sequence_by_name(const char* name);
+int is_active_sequence(const Sequence* seq);
 void update_sequence_text(Sequence* seq, const char* new_text);
 void update_sequence_position(Sequence* seq, int x, int y);
 void update_sequence_color(Sequence* seq, Color new_color);
+void update_sequence_size(Sequence* seq, int w, int h);
 void set_sequence_visibility(Sequence* seq, int visible);
 int load_sequence_image(SDL_Renderer* renderer, Sequence* seq, const char* image_path);
 int load_sequence_font(Sequence* seq, const char* font_path, int font_size);
 int load_font_all_sequences(const char* font_path);
+void refresh_sequence_text(Sequence* seq);
 void cleanup_sequences(void);
+void cleanup_sequence_fonts(void);
+
+// Job system functions
+int init_job_system(int threads);
+void shutdown_job_system(void);
+int get_job_worker_count(void);
+void run_jobs(const Job* jobs, int count, JobCounter* counter);
+void run_jobs_after(JobCounter* dependency, const Job* jobs, int count, JobCounter* counter);
+void wait_for_counter(JobCounter* counter);
+void parallel_for(int count, int min_batch, ParallelForFunction function, void* data);
+void get_job_worker_stats(int worker, double* busy_ms, int* jobs_run);
+void print_job_stats(void);
+void preload_images(const char* const* paths, int count);
+SDL_Surface* load_image_surface(const char* path);
+void release_preloaded_images(void);
+int get_job_worker_index(void);
+
+// Text pipeline functions
+int create_text_label(const char* font_path, int font_size);
+void set_text_label(int label, const char* text);
+SDL_Texture* get_text_label_texture(int label, int* w, int* h);
+void release_text_label(int label);
+Uint32 get_text_label_generation(int label);
+int is_text_label_shown(int label, Uint32 generation);
+void update_text_labels(SDL_Renderer* renderer);
+void get_text_stats(int* in_flight, int* uploads, int* stale);
+void cleanup_text(void);
+
+// Texture pool functions
+SDL_Texture* acquire_pooled_texture(SDL_Renderer* renderer, int w, int h);
+void release_pooled_texture(SDL_Texture* texture);
+SDL_Texture* upload_pooled_texture(SDL_Renderer* renderer, SDL_Texture* current,
+                                   const SDL_Surface* surface);
+TexturePoolStats get_texture_pool_stats(void);
+void print_texture_pool_stats(void);
+void set_texture_pool_budget(size_t bytes);
+void cleanup_texture_pool(void);
+
+// Frame arena functions
+int install_allocation_counters(void);
+void* frame_alloc(size_t size);
+void reset_frame_arena(void);
+SDL_Surface* acquire_scratch_surface(int w, int h);
+void release_scratch_surface(SDL_Surface* surface);
+MemoryStats get_memory_stats(void);
+void print_memory_stats(void);
+void cleanup_scratch_surfaces(void);
+
+// Binding functions
+void init_bindings(void);
+int create_observable(const char* name, int is_text);
+int find_observable(const char* name);
+void set_observable_int(int obs, int value);
+void set_observable_text(int obs, const char* text);
+int get_observable_int(int obs);
+const char* get_observable_text(int obs);
+int bind_sequence_text(int obs, Sequence* seq, BindingFormatter formatter);
+int bind_round_sequence_text(int obs, RoundSequence* seq, BindingFormatter formatter);
+int subscribe_observable(int obs, BindingCallback callback, void* data);
+void unbind(int binding);
+void flush_bindings(void);
+BindingStats get_binding_stats(void);
+void print_binding_stats(void);
+void cleanup_bindings(void);
+
+// Collision functions
+int add_box_collider(float x, float y, float w, float h);
+int add_circle_collider(float cx, float cy, float radius);
+int add_sequence_collider(Sequence* seq);
+int add_round_sequence_collider(RoundSequence* seq);
+void set_box_collider(int id, float x, float y, float w, float h);
+void set_circle_collider(int id, float cx, float cy, float radius);
+void remove_collider(int id);
+const Collider* get_collider(int id);
+void update_collisions(void);
+const CollisionEvent* get_collision_events(int* count);
+int are_colliding(int a, int b);
+CollisionStats get_collision_stats(void);
+void print_collision_stats(void);
+void cleanup_collisions(void);
+
+// Particle functions
+int create_particle_emitter(const char* name, int capacity, const ParticleEmitterConfig* config);
+int find_particle_emitter(const char* name);
+int emit_particles(int emitter, float x, float y, int count);
+void update_particles(double frame_seconds);
+void draw_particles(void);
+int get_live_particle_count(void);
+void set_particle_simd(int enabled);
+void clear_particles(int emitter);
+void destroy_particle_emitter(int emitter);
+void cleanup_particles(void);
+
+// Tween functions
+int tween_sequence(Sequence* seq, TweenProperty property, const float to[4],
+                   float seconds, EaseType easing);
+int tween_round_sequence(RoundSequence* seq, TweenProperty property, const float to[4],
+                         float seconds, EaseType easing);
+int tween_sequence_position(Sequence* seq, int x, int y, float seconds, EaseType easing);
+int tween_sequence_size(Sequence* seq, int w, int h, float seconds, EaseType easing);
+int tween_sequence_color(Sequence* seq, Color color, float seconds, EaseType easing);
+int tween_sequence_alpha(Sequence* seq, Uint8 opacity, float seconds, EaseType easing);
+void set_tween_ping_pong(int tween, int ping_pong);
+int is_tween_active(int tween);
+void cancel_tween(int tween);
+void cancel_sequence_tweens(const Sequence* seq);
+void update_tweens(double frame_seconds);
+int get_active_tween_count(void);
+void clear_tweens(void);
+
+// Scene graph functions
+int set_sequence_parent(Sequence* child, Sequence* parent, int keep_world_position);
+void set_sequence_opacity(Sequence* seq, Uint8 opacity);
+void mark_sequence_dirty(Sequence* seq);
+void update_scene_graph(void);
+void invalidate_scene_graph(void);
+int is_sequence_subtree_culled(const Sequence* seq);
+Sequence* pick_sequence_at(int x, int y, int inputs_only);
+
+// Culling functions
+void cull_sequences(void);
+Sequence** get_draw_list(int* count);
+int is_round_sequence_culled(const RoundSequence* seq);
+CullStats get_cull_stats(void);
+void print_cull_stats(void);
 
 // Input field functions
 void set_sequence_input(Sequence* seq, const char* placeholder);
@@ -118,6 +1071,21 @@ void handle_input_event(SDL_Event* event);
 void update_input_cursors(void);
 void draw_input_sequence(SDL_Renderer* renderer, Sequence* seq);
 Sequence* get_focused_input(void);
+void register_input_field_controls(void);
+
+// Controls functions
+int bind_key(SDL_Keycode key, int mods, int context, ControlHandler handler, void* data);
+void unbind_key(SDL_Keycode key, int mods, int context);
+int dispatch_control_event(const SDL_Event* event);
+void update_input_snapshot(const Uint8* keys);
+const InputSnapshot* get_input_snapshot(void);
+void init_player_controls(void);
+void set_player_control(int player, PlayerAction action, SDL_Keycode key);
+SDL_Keycode get_player_control(int player, PlayerAction action);
+SDL_Scancode get_player_scancode(int player, PlayerAction action);
+void set_player_key_cap(int player, PlayerAction action, Sequence* cap);
+void refresh_player_controls(void);
+void clear_key_bindings(void);
 
 // Round Sequence-related function declarations
 void init_round_sequences(void);
@@ -131,9 +1099,99 @@ RoundSequence* get_round_sequence_by_name(const char* name);
 void update_round_sequence_text(RoundSequence* seq, const char* new_text);
 void update_round_sequence_position(RoundSequence* seq, int center_x, int center_y);
 void update_round_sequence_color(RoundSequence* seq, Color new_color);
+void update_round_sequence_radius(RoundSequence* seq, int radius);
 void set_round_sequence_visibility(RoundSequence* seq, int visible);
 void cleanup_round_sequences(void);
 
+// Scene manager functions
+void init_scene_manager(SDL_Renderer* renderer);
+int register_scene(const char* name, const SceneConfig* config);
+int find_scene(const char* name);
+const char* get_scene_name(int scene);
+int get_active_scene(void);
+int get_next_scene(int scene);
+void preload_scene(int scene);
+int switch_scene(int scene);
+void request_scene(int scene);
+void update_scenes(double frame_seconds);
+int set_sequence_scene_image(Sequence* seq, const char* path);
+SDL_Texture* acquire_scene_image(const char* path);
+void release_scene_image(SDL_Texture* texture);
+SceneStats get_scene_stats(void);
+void print_scene_stats(void);
+void set_scene_texture_budget(size_t bytes);
+void cleanup_scenes(void);
+
+// Game simulation functions
+void init_game(int arena_w, int arena_h,
+               int p1_x, int p1_y, int p2_x, int p2_y, int player_w, int player_h);
+void bind_player_sequence(int player, Sequence* seq);
+void read_player_inputs(const Uint8* keys, PlayerInput inputs[2]);
+void game_step(GameSimulation* sim, const PlayerInput inputs[2]);
+int game_update(GameSimulation* sim, double frame_seconds, const Uint8* keys);
+float game_interpolation_alpha(const GameSimulation* sim);
+void apply_game_to_sequences(const GameSimulation* sim);
+Uint32 game_state_checksum(const GameSimulation* sim);
+Uint32 run_game_headless(int ticks, Uint32 seed);
+
+// Input recording / replay functions
+int start_input_recording(const char* path);
+void record_input_event(const SDL_Event* event);
+void record_input_frame(double frame_seconds);
+void stop_input_recording(void);
+int start_input_replay(const char* path, int fast);
+int is_replay_active(void);
+int replay_begin_frame(double* frame_seconds);
+int replay_poll_event(SDL_Event* event);
+const Uint8* replay_keyboard_state(void);
+void stop_input_replay(void);
+
+// Profiler functions
+void profiler_begin_frame(void);
+void profiler_end_phase(ProfilePhase phase);
+void profiler_end_frame(void);
+void profiler_print_report(void);
+int profiler_write_csv(const char* path);
+
+// Settings functions
+void reset_settings(void);
+const Settings* get_settings(void);
+void set_settings(const Settings* settings);
+int load_settings(const char* path);
+int save_settings(const char* path);
+void apply_vsync_setting(SDL_Renderer* renderer);
+void apply_settings(void);
+void print_settings(void);
+void limit_frame_rate(Uint64 frame_start);
+int autotune_settings(SDL_Renderer* renderer, SDL_Window* window, const char* font_path);
+
+// Input latency functions
+void start_latency_tracking(int late_latch);
+int is_latency_tracking(void);
+int is_late_latch_enabled(void);
+void latency_event_received(const SDL_Event* event, int late);
+void latency_defer_event(void);
+void latency_wait_for_label(int label);
+void latency_frame_presented(void);
+void print_latency_report(void);
+
+// Render queue functions
+void render_queue_begin(SDL_Renderer* renderer);
+void render_queue_set_layer(int layer);
+void queue_fill_rect(const SDL_Rect* rect, Color color);
+void queue_outline_rect(const SDL_Rect* rect, Color color);
+void queue_texture(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest, Uint8 alpha);
+void queue_texture_f(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect* dest, Uint8 alpha);
+void queue_glyph_run(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest, int owns_texture);
+void queue_text(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest, Color tint);
+void queue_circle(int center_x, int center_y, int radius, Color color, int filled, int thickness);
+void queue_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertex_count,
+                    const int* indices, int index_count, const SDL_Rect* bounds, SDL_BlendMode blend);
+void render_queue_flush(SDL_Renderer* renderer);
+void render_queue_end(SDL_Renderer* renderer);
+RenderQueueStats render_queue_get_stats(void);
+void render_queue_print_stats(void);
+
 // Helper function to create colors easily
 Color create_color(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
@@ -4,10 +4,30 @@
 
 #define CURSOR_BLINK_MS 500  // Blink every 500ms
 
+// The buffer of an input field changed: redraw it and publish the new text
+static void input_buffer_changed(Sequence* seq) {
+    refresh_sequence_text(seq);
+    set_observable_text(OBSERVABLE_INPUT_TEXT, seq->input_buffer);
+}
+
+// Input fields in creation order (Tab cycles through them) and the one that
+// has the focus, so lookups never scan the whole sequence array
+static Sequence* input_fields[MAX_SEQUENCES];
+static int input_field_count = 0;
+static Sequence* focused_input = NULL;
+
 // Enable a sequence as an input field
 void set_sequence_input(Sequence* seq, const char* placeholder) {
     if (!seq) return;
 
+    // A scene built again reuses its sequences: keep one entry per field
+    int listed = 0;
+    for (int i = 0; i < input_field_count; i++) {
+        if (input_fields[i] == seq) listed = 1;
+    }
+    if (!listed && input_field_count < MAX_SEQUENCES) {
+        input_fields[input_field_count++] = seq;
+    }
     seq->is_input        = 1;
     seq->is_focused     = 0;
     seq->input_buffer[0] = '\0';
@@ -17,6 +37,7 @@ void set_sequence_input(Sequence* seq, const char* placeholder) {
 
     strncpy(seq->placeholder, placeholder, sizeof(seq->placeholder) - 1);
     seq->placeholder[sizeof(seq->placeholder) - 1] = '\0';
+    refresh_sequence_text(seq);
 
     printf("Input field enabled on sequence '%s' (placeholder: \"%s\")\n",
            seq->name, placeholder);
@@ -30,71 +51,67 @@ void focus_input(Sequence* seq) {
     unfocus_all_inputs();
 
     seq->is_focused     = 1;
+    focused_input       = seq;
+    set_observable_int(OBSERVABLE_FOCUS, (int)(seq - sequences));
     seq->cursor_visible = 1;
     seq->cursor_timer   = SDL_GetTicks();
 
+    // Gentle pulse while focused
+    int pulse = tween_sequence_alpha(seq, 170, 0.7f, EASE_IN_OUT_SINE);
+    set_tween_ping_pong(pulse, 1);
+
     // Tell SDL to start capturing text input
     SDL_StartTextInput();
 
     printf("Input focused: '%s'\n", seq->name);
 }
 
-// Remove focus from every input field
+// Remove focus from every input field (only one can have it)
 void unfocus_all_inputs(void) {
-    for (int i = 0; i < sequence_count; i++) {
-        if (sequences[i].is_input && sequences[i].is_focused) {
-            sequences[i].is_focused = 0;
-            printf("Input unfocused: '%s' | content: \"%s\"\n",
-                   sequences[i].name, sequences[i].input_buffer);
-        }
+    Sequence* seq = get_focused_input();
+    if (seq) {
+        seq->is_focused = 0;
+        tween_sequence_alpha(seq, 255, 0.15f, EASE_OUT_QUAD);
+        printf("Input unfocused: '%s' | content: \"%s\"\n",
+               seq->name, seq->input_buffer);
     }
+    focused_input = NULL;
+    set_observable_int(OBSERVABLE_FOCUS, -1);
     SDL_StopTextInput();
 }
 
 // Return the currently focused input, or NULL
 Sequence* get_focused_input(void) {
-    for (int i = 0; i < sequence_count; i++) {
-        if (sequences[i].is_input && sequences[i].is_focused)
-            return &sequences[i];
+    // The sequence array may have been reset since the focus was given
+    if (focused_input && focused_input->is_input && focused_input->is_focused) {
+        return focused_input;
     }
     return NULL;
 }
 
-// Update cursor blink timer for all inputs
+// Update cursor blink timer of the focused input
 void update_input_cursors(void) {
-    Uint32 now = SDL_GetTicks();
-    for (int i = 0; i < sequence_count; i++) {
-        Sequence* seq = &sequences[i];
-        if (!seq->is_input || !seq->is_focused) continue;
+    Sequence* seq = get_focused_input();
+    if (!seq) return;
 
-        if (now - seq->cursor_timer >= CURSOR_BLINK_MS) {
-            seq->cursor_visible = !seq->cursor_visible;
-            seq->cursor_timer   = now;
-        }
+    Uint32 now = SDL_GetTicks();
+    if (now - seq->cursor_timer >= CURSOR_BLINK_MS) {
+        seq->cursor_visible = !seq->cursor_visible;
+        seq->cursor_timer   = now;
     }
 }
 
-// Handle SDL events for input fields
+// Handle SDL events for input fields (editing keys go through the key
+// bindings, see register_input_field_controls)
 void handle_input_event(SDL_Event* event) {
 
     // ── Mouse click: focus / unfocus ──────────────────────────────────────────
     if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
-        int mx = event->button.x;
-        int my = event->button.y;
-        int hit = 0;
-
-        for (int i = 0; i < sequence_count; i++) {
-            Sequence* seq = &sequences[i];
-            if (!seq->is_input || !seq->visible) continue;
-
-            if (mx >= seq->x && mx <= seq->x + seq->w &&
-                my >= seq->y && my <= seq->y + seq->h) {
-                focus_input(seq);
-                hit = 1;
-                break;
-            }
-        }
-        if (!hit) unfocus_all_inputs();
+        // Scene graph hit test skips hidden / transparent / off-screen subtrees
+        Sequence* seq = pick_sequence_at(event->button.x, event->button.y, 1);
+
+        if (seq) focus_input(seq);
+        else unfocus_all_inputs();
         return;
     }
 
@@ -114,120 +131,123 @@ void handle_input_event(SDL_Event* event) {
                     buf_len - seq->cursor_pos + 1);
             memcpy(seq->input_buffer + seq->cursor_pos, txt, txt_len);
             seq->cursor_pos += txt_len;
+            input_buffer_changed(seq);
         }
         return;
     }
+}
 
-    // ── Special keys ─────────────────────────────────────────────────────────
-    if (event->type == SDL_KEYDOWN) {
-        Sequence* seq = get_focused_input();
-        if (!seq) return;
+// ── Editing keys (bound in the text context: a field has the focus) ─────────
+
+// Backspace: delete character before cursor
+static void input_backspace(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    Sequence* seq = get_focused_input();
+    int buf_len = (int)strlen(seq->input_buffer);
+    if (seq->cursor_pos > 0) {
+        memmove(seq->input_buffer + seq->cursor_pos - 1,
+                seq->input_buffer + seq->cursor_pos,
+                buf_len - seq->cursor_pos + 1);
+        seq->cursor_pos--;
+        input_buffer_changed(seq);
+    }
+}
 
-        int buf_len = (int)strlen(seq->input_buffer);
+// Delete: delete character after cursor
+static void input_delete(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    Sequence* seq = get_focused_input();
+    int buf_len = (int)strlen(seq->input_buffer);
+    if (seq->cursor_pos < buf_len) {
+        memmove(seq->input_buffer + seq->cursor_pos,
+                seq->input_buffer + seq->cursor_pos + 1,
+                buf_len - seq->cursor_pos);
+        input_buffer_changed(seq);
+    }
+}
+
+// Left / Right / Home / End: move the cursor
+static void input_move_cursor(const SDL_Event* event, void* data) {
+    (void)data;
+    Sequence* seq = get_focused_input();
+    int buf_len = (int)strlen(seq->input_buffer);
+    switch (event->key.keysym.sym) {
+        case SDLK_LEFT:  if (seq->cursor_pos > 0) seq->cursor_pos--; break;
+        case SDLK_RIGHT: if (seq->cursor_pos < buf_len) seq->cursor_pos++; break;
+        case SDLK_HOME:  seq->cursor_pos = 0; break;
+        case SDLK_END:   seq->cursor_pos = buf_len; break;
+        default: break;
+    }
+}
+
+// Enter: confirm and unfocus
+static void input_confirm(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    Sequence* seq = get_focused_input();
+    printf("Input confirmed in '%s': \"%s\"\n",
+           seq->name, seq->input_buffer);
+    play_sound("confirm");
+    emit_particles(find_particle_emitter("confetti"),
+                   seq->x + seq->w * 0.5f, (float)seq->y, 150);
+    unfocus_all_inputs();
+}
 
-        switch (event->key.keysym.sym) {
-
-            // Backspace: delete character before cursor
-            case SDLK_BACKSPACE:
-                if (seq->cursor_pos > 0) {
-                    memmove(seq->input_buffer + seq->cursor_pos - 1,
-                            seq->input_buffer + seq->cursor_pos,
-                            buf_len - seq->cursor_pos + 1);
-                    seq->cursor_pos--;
-                }
-                break;
-
-            // Delete: delete character after cursor
-            case SDLK_DELETE:
-                if (seq->cursor_pos < buf_len) {
-                    memmove(seq->input_buffer + seq->cursor_pos,
-                            seq->input_buffer + seq->cursor_pos + 1,
-                            buf_len - seq->cursor_pos);
-                }
-                break;
-
-            // Left arrow: move cursor left
-            case SDLK_LEFT:
-                if (seq->cursor_pos > 0) seq->cursor_pos--;
-                break;
-
-            // Right arrow: move cursor right
-            case SDLK_RIGHT:
-                if (seq->cursor_pos < buf_len) seq->cursor_pos++;
-                break;
-
-            // Home: jump to start
-            case SDLK_HOME:
-                seq->cursor_pos = 0;
-                break;
-
-            // End: jump to end
-            case SDLK_END:
-                seq->cursor_pos = buf_len;
-                break;
-
-            // Enter: confirm and unfocus
-            case SDLK_RETURN:
-            case SDLK_KP_ENTER:
-                printf("Input confirmed in '%s': \"%s\"\n",
-                       seq->name, seq->input_buffer);
-                unfocus_all_inputs();
-                break;
-
-            // Tab: cycle to next input field
-            case SDLK_TAB: {
-                int current_idx = -1;
-                for (int i = 0; i < sequence_count; i++) {
-                    if (sequences[i].is_input && sequences[i].is_focused) {
-                        current_idx = i;
-                        break;
-                    }
-                }
-                if (current_idx >= 0) {
-                    // Find next input field
-                    for (int i = 1; i <= sequence_count; i++) {
-                        int next = (current_idx + i) % sequence_count;
-                        if (sequences[next].is_input && sequences[next].visible) {
-                            focus_input(&sequences[next]);
-                            break;
-                        }
-                    }
-                }
-                break;
-            }
-
-            default:
-                break;
+// Tab: cycle to the next visible input field of the active scene
+static void input_next_field(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    Sequence* seq = get_focused_input();
+    int current = 0;
+    while (current < input_field_count && input_fields[current] != seq) current++;
+
+    for (int i = 1; i <= input_field_count; i++) {
+        Sequence* next = input_fields[(current + i) % input_field_count];
+        if (next->is_input && is_active_sequence(next) && !is_sequence_subtree_culled(next)) {
+            focus_input(next);
+            break;
         }
     }
 }
 
+// Bind the editing keys of input fields
+void register_input_field_controls(void) {
+    bind_key(SDLK_BACKSPACE, 0, CONTROL_CONTEXT_TEXT, input_backspace, NULL);
+    bind_key(SDLK_DELETE, 0, CONTROL_CONTEXT_TEXT, input_delete, NULL);
+    bind_key(SDLK_LEFT, 0, CONTROL_CONTEXT_TEXT, input_move_cursor, NULL);
+    bind_key(SDLK_RIGHT, 0, CONTROL_CONTEXT_TEXT, input_move_cursor, NULL);
+    bind_key(SDLK_HOME, 0, CONTROL_CONTEXT_TEXT, input_move_cursor, NULL);
+    bind_key(SDLK_END, 0, CONTROL_CONTEXT_TEXT, input_move_cursor, NULL);
+    bind_key(SDLK_RETURN, 0, CONTROL_CONTEXT_TEXT, input_confirm, NULL);
+    bind_key(SDLK_KP_ENTER, 0, CONTROL_CONTEXT_TEXT, input_confirm, NULL);
+    bind_key(SDLK_TAB, 0, CONTROL_CONTEXT_TEXT, input_next_field, NULL);
+}
+
 // Draw an input sequence (called by draw_sequence when is_input == 1)
 void draw_input_sequence(SDL_Renderer* renderer, Sequence* seq) {
+    (void)renderer;
     if (!seq || !seq->visible) return;
 
     SDL_Rect rect = {seq->x, seq->y, seq->w, seq->h};
 
+    // Group opacity inherited from the scene graph
+    int opacity = seq->world_opacity;
+
     // ── Background ───────────────────────────────────────────────────────────
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer,
-                           seq->color.r, seq->color.g,
-                           seq->color.b, seq->color.a);
-    SDL_RenderFillRect(renderer, &rect);
+    if (!(seq->cull_flags & CULL_FILL)) {
+        queue_fill_rect(&rect, create_color(seq->color.r, seq->color.g,
+                                            seq->color.b, seq->color.a * opacity / 255));
+    }
 
     // ── Border: white when focused, dim when not ──────────────────────────────
     if (seq->is_focused) {
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 220);
+        queue_outline_rect(&rect, create_color(255, 255, 255, 220 * opacity / 255));
     } else {
-        SDL_SetRenderDrawColor(renderer, 180, 180, 180, 120);
+        queue_outline_rect(&rect, create_color(180, 180, 180, 120 * opacity / 255));
     }
-    SDL_RenderDrawRect(renderer, &rect);
 
     // Inner border for focused field
     if (seq->is_focused) {
         SDL_Rect inner = {seq->x + 1, seq->y + 1, seq->w - 2, seq->h - 2};
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 80);
-        SDL_RenderDrawRect(renderer, &inner);
+        queue_outline_rect(&inner, create_color(255, 255, 255, 80 * opacity / 255));
     }
 
     if (!seq->font) return;
@@ -238,7 +258,6 @@ void draw_input_sequence(SDL_Renderer* renderer, Sequence* seq) {
 
     // ── Placeholder or typed text ─────────────────────────────────────────────
     int is_empty = (strlen(seq->input_buffer) == 0);
-    const char* display_text = is_empty ? seq->placeholder : seq->input_buffer;
     SDL_Color text_color;
 
     if (is_empty && !seq->is_focused) {
@@ -252,23 +271,23 @@ void draw_input_sequence(SDL_Renderer* renderer, Sequence* seq) {
         text_color = (SDL_Color){seq->text_color.r, seq->text_color.g,
                                   seq->text_color.b, seq->text_color.a};
     }
-
-    SDL_Surface* txt_surf = TTF_RenderUTF8_Blended(seq->font, display_text, text_color);
-    if (txt_surf) {
-        SDL_Texture* txt_tex = SDL_CreateTextureFromSurface(renderer, txt_surf);
-        if (txt_tex) {
-            // Clip text to the input area
-            int max_w = seq->w - pad_x * 2;
-            int draw_w = txt_surf->w > max_w ? max_w : txt_surf->w;
-            SDL_Rect src  = {txt_surf->w - draw_w, 0, draw_w, txt_surf->h};
-            SDL_Rect dest = {seq->x + pad_x,
-                             seq->y + pad_y,
-                             draw_w,
-                             txt_surf->h};
-            SDL_RenderCopy(renderer, txt_tex, &src, &dest);
-            SDL_DestroyTexture(txt_tex);
-        }
-        SDL_FreeSurface(txt_surf);
+    text_color.a = (Uint8)(text_color.a * opacity / 255);
+
+    // Rasterized off-thread when the text changes; until then the previous
+    // text is shown
+    int txt_w, txt_h;
+    SDL_Texture* txt_tex = get_text_label_texture(seq->text_label, &txt_w, &txt_h);
+    if (txt_tex) {
+        // Clip text to the input area
+        int max_w = seq->w - pad_x * 2;
+        int draw_w = txt_w > max_w ? max_w : txt_w;
+        SDL_Rect src  = {txt_w - draw_w, 0, draw_w, txt_h};
+        SDL_Rect dest = {seq->x + pad_x,
+                         seq->y + pad_y,
+                         draw_w,
+                         txt_h};
+        queue_text(txt_tex, &src, &dest, create_color(text_color.r, text_color.g,
+                                                       text_color.b, text_color.a));
     }
 
     // ── Blinking cursor ───────────────────────────────────────────────────────
@@ -288,19 +307,17 @@ void draw_input_sequence(SDL_Renderer* renderer, Sequence* seq) {
         int cursor_y1 = seq->y + pad_y;
         int cursor_y2 = seq->y + seq->h - pad_y;
 
-        // Keep cursor inside the box
+        // Keep cursor inside the box (2px wide bar)
         if (cursor_x <= seq->x + seq->w - pad_x) {
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 220);
-            SDL_RenderDrawLine(renderer, cursor_x, cursor_y1, cursor_x, cursor_y2);
-            SDL_RenderDrawLine(renderer, cursor_x + 1, cursor_y1, cursor_x + 1, cursor_y2);
+            SDL_Rect bar = {cursor_x, cursor_y1, 2, cursor_y2 - cursor_y1 + 1};
+            queue_fill_rect(&bar, create_color(255, 255, 255, 220 * opacity / 255));
         }
     } else if (seq->is_focused && seq->cursor_visible && is_empty) {
         // Cursor when field is empty
         int cursor_x = seq->x + pad_x;
         int cursor_y1 = seq->y + pad_y;
         int cursor_y2 = seq->y + seq->h - pad_y;
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 220);
-        SDL_RenderDrawLine(renderer, cursor_x, cursor_y1, cursor_x, cursor_y2);
-        SDL_RenderDrawLine(renderer, cursor_x + 1, cursor_y1, cursor_x + 1, cursor_y2);
+        SDL_Rect bar = {cursor_x, cursor_y1, 2, cursor_y2 - cursor_y1 + 1};
+        queue_fill_rect(&bar, create_color(255, 255, 255, 220 * opacity / 255));
     }
 }
@@ -0,0 +1,452 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// JOBS - work-stealing thread pool
+// =============================================================================
+//
+// One worker per core: the main thread is worker 0 and the others are
+// background threads. Every worker owns a deque of jobs; it pushes and pops
+// at the bottom, and idle workers steal from the top of the others'
+// deques. The deques are short critical sections behind spinlocks.
+//
+// Jobs report completion through a JobCounter. Waiting on a counter runs
+// other jobs instead of blocking, and jobs queued with run_jobs_after()
+// only start once their dependency counter reaches zero. Workers that find
+// nothing to do sleep on a semaphore.
+//
+// Jobs must not touch the renderer: decode to surfaces on workers, create
+// textures on the main thread.
+
+#define JOB_SPINS_BEFORE_SLEEP 64
+#define JOB_MAX_BATCHES 64
+
+typedef struct {
+    Job ring[JOB_DEQUE_SIZE];
+    int top;                   // Next job to steal
+    int bottom;                // Next free slot (owner side)
+    SDL_SpinLock lock;
+    SDL_Thread* thread;
+    Uint32 rng;                // Victim selection
+    SDL_SpinLock stats_lock;   // Guards the counters below (read by the main thread)
+    Uint64 busy_ticks;         // Time spent running jobs
+    int jobs_run;
+} JobWorker;
+
+static JobWorker workers[JOB_MAX_WORKERS];
+static int worker_count = 0;                  // 0 = not initialized (jobs run inline)
+static SDL_TLSID worker_tls = 0;
+static SDL_sem* wake = NULL;
+static SDL_atomic_t sleeping;
+static SDL_atomic_t quit;
+static Uint64 start_ticks = 0;
+
+// Index of the calling thread's worker (threads outside the pool use 0)
+static int current_worker(void) {
+    int index = (int)(intptr_t)SDL_TLSGet(worker_tls);
+    return index > 0 ? index - 1 : 0;
+}
+
+static int push_job(JobWorker* w, const Job* job) {
+    SDL_AtomicLock(&w->lock);
+    if (w->bottom - w->top >= JOB_DEQUE_SIZE) {
+        SDL_AtomicUnlock(&w->lock);
+        return 0;
+    }
+    w->ring[w->bottom & (JOB_DEQUE_SIZE - 1)] = *job;
+    w->bottom++;
+    SDL_AtomicUnlock(&w->lock);
+    return 1;
+}
+
+static int pop_job(JobWorker* w, Job* job) {
+    SDL_AtomicLock(&w->lock);
+    if (w->bottom == w->top) {
+        SDL_AtomicUnlock(&w->lock);
+        return 0;
+    }
+    w->bottom--;
+    *job = w->ring[w->bottom & (JOB_DEQUE_SIZE - 1)];
+    SDL_AtomicUnlock(&w->lock);
+    return 1;
+}
+
+static int steal_job(JobWorker* w, Job* job) {
+    SDL_AtomicLock(&w->lock);
+    if (w->bottom == w->top) {
+        SDL_AtomicUnlock(&w->lock);
+        return 0;
+    }
+    *job = w->ring[w->top & (JOB_DEQUE_SIZE - 1)];
+    w->top++;
+    SDL_AtomicUnlock(&w->lock);
+    return 1;
+}
+
+// Own deque first, then steal starting from a random victim
+static int find_job(int self, Job* job) {
+    if (pop_job(&workers[self], job)) return 1;
+
+    JobWorker* w = &workers[self];
+    w->rng = w->rng * 1664525u + 1013904223u;
+    int start = (int)((w->rng >> 16) % (Uint32)worker_count);
+    for (int i = 0; i < worker_count; i++) {
+        int victim = (start + i) % worker_count;
+        if (victim != self && steal_job(&workers[victim], job)) return 1;
+    }
+    return 0;
+}
+
+static void execute_job(int self, const Job* job);
+
+// Queue a job on the calling thread's deque (runs it inline if full)
+static void submit_job(const Job* job) {
+    int self = current_worker();
+    if (!push_job(&workers[self], job)) {
+        execute_job(self, job);
+        return;
+    }
+    if (SDL_AtomicGet(&sleeping) > 0) {
+        SDL_SemPost(wake);
+    }
+}
+
+// Count a job as finished. The counter is only touched under its lock, and
+// waiters take the lock once before returning, so a counter living on the
+// waiter's stack is never used after the wait.
+static void finish_job(JobCounter* counter) {
+    Job ready[JOB_MAX_CONTINUATIONS];
+    int count = 0;
+
+    SDL_AtomicLock(&counter->lock);
+    if (SDL_AtomicAdd(&counter->pending, -1) == 1) {
+        count = counter->continuation_count;
+        memcpy(ready, counter->continuations, sizeof(Job) * count);
+        counter->continuation_count = 0;
+    }
+    SDL_AtomicUnlock(&counter->lock);
+
+    // Jobs that were waiting on this counter can run now
+    for (int i = 0; i < count; i++) {
+        submit_job(&ready[i]);
+    }
+}
+
+static void execute_job(int self, const Job* job) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    job->function(job->data);
+    Uint64 busy = SDL_GetPerformanceCounter() - start;
+
+    SDL_AtomicLock(&workers[self].stats_lock);
+    workers[self].busy_ticks += busy;
+    workers[self].jobs_run++;
+    SDL_AtomicUnlock(&workers[self].stats_lock);
+
+    if (job->counter) finish_job(job->counter);
+}
+
+static int worker_main(void* data) {
+    int self = (int)(intptr_t)data;
+    SDL_TLSSet(worker_tls, (void*)(intptr_t)(self + 1), NULL);
+
+    int idle_spins = 0;
+    while (!SDL_AtomicGet(&quit)) {
+        Job job;
+        if (find_job(self, &job)) {
+            execute_job(self, &job);
+            idle_spins = 0;
+            continue;
+        }
+        if (++idle_spins < JOB_SPINS_BEFORE_SLEEP) continue;
+
+        // The timeout covers a post that raced with going to sleep
+        SDL_AtomicAdd(&sleeping, 1);
+        SDL_SemWaitTimeout(wake, 2);
+        SDL_AtomicAdd(&sleeping, -1);
+    }
+    return 0;
+}
+
+// Start the pool with 'threads' background workers (<= 0: one per extra core).
+// Returns 0 on success.
+int init_job_system(int threads) {
+    if (worker_count > 0) return 0;
+
+    if (threads <= 0) threads = SDL_GetCPUCount() - 1;
+    if (threads > JOB_MAX_WORKERS - 1) threads = JOB_MAX_WORKERS - 1;
+    if (threads < 0) threads = 0;
+
+    memset(workers, 0, sizeof(workers));
+    worker_tls = SDL_TLSCreate();
+    wake = SDL_CreateSemaphore(0);
+    if (!worker_tls || !wake) {
+        printf("Failed to create job system: %s\n", SDL_GetError());
+        return -1;
+    }
+    SDL_AtomicSet(&sleeping, 0);
+    SDL_AtomicSet(&quit, 0);
+    SDL_TLSSet(worker_tls, (void*)(intptr_t)1, NULL);
+    start_ticks = SDL_GetPerformanceCounter();
+
+    // Workers read worker_count as soon as they start, so it is set once up
+    // front. A worker that fails to start just leaves an empty deque behind.
+    worker_count = threads + 1;
+    int started = 1;
+    for (int i = 1; i <= threads; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "job_worker_%d", i);
+        workers[i].rng = 0x9E3779B9u * (Uint32)(i + 1);
+        workers[i].thread = SDL_CreateThread(worker_main, name, (void*)(intptr_t)i);
+        if (!workers[i].thread) {
+            printf("Failed to start job worker %d: %s\n", i, SDL_GetError());
+            continue;
+        }
+        started++;
+    }
+
+    printf("Job system started (%d workers including the main thread)\n", started);
+    return 0;
+}
+
+// Stop the workers. Queued jobs that have not started are dropped.
+void shutdown_job_system(void) {
+    if (worker_count == 0) return;
+
+    SDL_AtomicSet(&quit, 1);
+    for (int i = 1; i < worker_count; i++) {
+        SDL_SemPost(wake);
+    }
+    for (int i = 1; i < worker_count; i++) {
+        if (workers[i].thread) SDL_WaitThread(workers[i].thread, NULL);
+        workers[i].thread = NULL;
+    }
+    SDL_DestroySemaphore(wake);
+    wake = NULL;
+    worker_count = 0;
+}
+
+// Workers including the main thread (1 if the pool is not running)
+int get_job_worker_count(void) {
+    return worker_count > 0 ? worker_count : 1;
+}
+
+// Worker the caller is running on (0 = main thread or a thread outside the pool)
+int get_job_worker_index(void) {
+    return current_worker();
+}
+
+// Queue jobs; 'counter' (may be NULL) drops to zero when all have finished
+void run_jobs(const Job* jobs, int count, JobCounter* counter) {
+    if (counter) SDL_AtomicAdd(&counter->pending, count);
+
+    for (int i = 0; i < count; i++) {
+        Job job = jobs[i];
+        job.counter = counter;
+        if (worker_count == 0) {
+            job.function(job.data);
+            if (counter) finish_job(counter);
+        } else {
+            submit_job(&job);
+        }
+    }
+}
+
+// Queue jobs that start once 'dependency' reaches zero
+void run_jobs_after(JobCounter* dependency, const Job* jobs, int count, JobCounter* counter) {
+    if (!dependency) {
+        run_jobs(jobs, count, counter);
+        return;
+    }
+    if (counter) SDL_AtomicAdd(&counter->pending, count);
+
+    for (int i = 0; i < count; i++) {
+        Job job = jobs[i];
+        job.counter = counter;
+
+        SDL_AtomicLock(&dependency->lock);
+        if (SDL_AtomicGet(&dependency->pending) > 0 &&
+            dependency->continuation_count < JOB_MAX_CONTINUATIONS) {
+            dependency->continuations[dependency->continuation_count++] = job;
+            SDL_AtomicUnlock(&dependency->lock);
+            continue;
+        }
+        SDL_AtomicUnlock(&dependency->lock);
+
+        // Already satisfied (or no room left to wait): run as soon as possible
+        wait_for_counter(dependency);
+        if (worker_count == 0) {
+            job.function(job.data);
+            if (counter) finish_job(counter);
+        } else {
+            submit_job(&job);
+        }
+    }
+}
+
+// Wait until a counter reaches zero, running jobs meanwhile
+void wait_for_counter(JobCounter* counter) {
+    if (!counter) return;
+
+    int self = current_worker();
+    while (SDL_AtomicGet(&counter->pending) > 0) {
+        Job job;
+        if (worker_count > 0 && find_job(self, &job)) {
+            execute_job(self, &job);
+        } else {
+            SDL_Delay(0);
+        }
+    }
+
+    // Let the thread that finished the last job leave the counter
+    SDL_AtomicLock(&counter->lock);
+    SDL_AtomicUnlock(&counter->lock);
+}
+
+// -----------------------------------------------------------------------------
+// Parallel for
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    ParallelForFunction function;
+    void* data;
+    int begin, end;
+} ParallelRange;
+
+static void run_range(void* data) {
+    ParallelRange* range = (ParallelRange*)data;
+    range->function(range->begin, range->end, range->data);
+}
+
+// Call function(begin, end, data) over [0, count) in batches of at least
+// 'min_batch' items, spread over the workers. Returns when all are done.
+void parallel_for(int count, int min_batch, ParallelForFunction function, void* data) {
+    if (count <= 0) return;
+
+    int workers_available = get_job_worker_count();
+    int batch = (count + workers_available * 4 - 1) / (workers_available * 4);
+    if (batch < min_batch) batch = min_batch;
+    if (batch < (count + JOB_MAX_BATCHES - 1) / JOB_MAX_BATCHES) {
+        batch = (count + JOB_MAX_BATCHES - 1) / JOB_MAX_BATCHES;
+    }
+    if (worker_count == 0 || batch >= count) {
+        function(0, count, data);
+        return;
+    }
+
+    ParallelRange ranges[JOB_MAX_BATCHES];
+    Job jobs[JOB_MAX_BATCHES];
+    int batches = 0;
+    for (int begin = 0; begin < count; begin += batch) {
+        ranges[batches] = (ParallelRange){function, data, begin,
+                                          begin + batch < count ? begin + batch : count};
+        jobs[batches] = (Job){run_range, &ranges[batches], NULL};
+        batches++;
+    }
+
+    // The caller takes the first batch itself
+    JobCounter counter = {0};
+    run_jobs(jobs + 1, batches - 1, &counter);
+    run_range(&ranges[0]);
+    wait_for_counter(&counter);
+}
+
+// -----------------------------------------------------------------------------
+// Statistics
+// -----------------------------------------------------------------------------
+
+// Time spent running jobs and jobs completed by one worker since start
+void get_job_worker_stats(int worker, double* busy_ms, int* jobs_run) {
+    if (worker < 0 || worker >= worker_count) {
+        *busy_ms = 0.0;
+        *jobs_run = 0;
+        return;
+    }
+    SDL_AtomicLock(&workers[worker].stats_lock);
+    Uint64 busy = workers[worker].busy_ticks;
+    *jobs_run = workers[worker].jobs_run;
+    SDL_AtomicUnlock(&workers[worker].stats_lock);
+    *busy_ms = (double)busy * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+void print_job_stats(void) {
+    if (worker_count == 0) return;
+
+    double elapsed_ms = (double)(SDL_GetPerformanceCounter() - start_ticks) * 1000.0 /
+                        (double)SDL_GetPerformanceFrequency();
+    printf("\n=== JOB WORKERS (%d) ===\n", worker_count);
+    for (int i = 0; i < worker_count; i++) {
+        double busy_ms;
+        int jobs_run;
+        get_job_worker_stats(i, &busy_ms, &jobs_run);
+        printf("%-8s %2d: %8d jobs | busy %9.1f ms | utilization %5.1f%%\n",
+               i == 0 ? "main" : "worker", i, jobs_run, busy_ms,
+               elapsed_ms > 0.0 ? 100.0 * busy_ms / elapsed_ms : 0.0);
+    }
+    printf("========================\n");
+}
+
+// -----------------------------------------------------------------------------
+// Asset decoding
+// -----------------------------------------------------------------------------
+
+// Surfaces decoded ahead of time, handed out once by load_image_surface()
+typedef struct {
+    char path[256];
+    SDL_Surface* surface;
+} DecodedImage;
+
+static DecodedImage decoded_images[JOB_MAX_PRELOAD];
+static int decoded_count = 0;
+static JobCounter preload_counter;
+
+static void decode_image(void* data) {
+    DecodedImage* image = (DecodedImage*)data;
+    image->surface = IMG_Load(image->path);
+}
+
+// Start decoding images on the workers and return immediately; the loaders
+// pick the surfaces up through load_image_surface()
+void preload_images(const char* const* paths, int count) {
+    Job jobs[JOB_MAX_PRELOAD];
+    int job_count = 0;
+
+    for (int i = 0; i < count && decoded_count < JOB_MAX_PRELOAD; i++) {
+        DecodedImage* image = &decoded_images[decoded_count++];
+        strncpy(image->path, paths[i], sizeof(image->path) - 1);
+        image->path[sizeof(image->path) - 1] = '\0';
+        image->surface = NULL;
+        jobs[job_count++] = (Job){decode_image, image, NULL};
+    }
+
+    printf("Decoding %d images on %d workers\n", job_count, get_job_worker_count());
+    run_jobs(jobs, job_count, &preload_counter);
+}
+
+// Load an image as a surface, using a preloaded one when available (waits
+// for the decode if it is still running). The caller frees the surface.
+SDL_Surface* load_image_surface(const char* path) {
+    for (int i = 0; i < decoded_count; i++) {
+        if (strcmp(decoded_images[i].path, path) != 0) continue;
+
+        wait_for_counter(&preload_counter);
+        SDL_Surface* surface = decoded_images[i].surface;
+        if (surface) {
+            decoded_images[i].surface = NULL;
+            return surface;
+        }
+    }
+    return IMG_Load(path);
+}
+
+// Free preloaded images nobody asked for
+void release_preloaded_images(void) {
+    wait_for_counter(&preload_counter);
+    for (int i = 0; i < decoded_count; i++) {
+        if (decoded_images[i].surface) {
+            SDL_FreeSurface(decoded_images[i].surface);
+        }
+    }
+    decoded_count = 0;
+}
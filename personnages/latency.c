@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// LATENCY - input-to-present measurement (--latency, --late-latch)
+// =============================================================================
+//
+// Every input event is stamped when the loop receives it. Its arrival time is
+// recovered from the event timestamp (SDL_GetTicks at the moment SDL queued
+// it), converted to the performance counter. The event then waits for the
+// end of the frame that handled it. When SDL_RenderPresent returns, that
+// frame's events get their event-to-present latency. With vsync this is the
+// moment the frame is handed to the display; scan-out adds a constant on top
+// that cannot be measured from here.
+//
+// Late latch: the loop polls events a second time after the update, right
+// before building the frame. What the latch applies by itself (focus, text
+// editing, bound values, layout) is drawn in this frame instead of waiting
+// for the next one. Game input is only read by the update, which has already
+// run: those events are deferred and counted with the next present, in the
+// frame start group. The report keeps both groups apart so the gain is
+// visible, without crediting the latch for presses it could not apply.
+//
+// Text edits change an input field's label, whose new text is rasterized by
+// a worker and uploaded a present or more later. Their samples stay pending
+// until the label text they produced has been uploaded; a late one drawn
+// after the latched frame moves to the frame start group.
+
+static int tracking = 0;
+static int late_latch = 0;
+static Uint32 frame_number = 0;
+
+static LatencySample pending[LATENCY_MAX_PENDING];
+static int pending_count = 0;
+static int last_pending = -1;          // Sample of the last event stamped, -1 if none
+static LatencySample samples[LATENCY_MAX_SAMPLES];
+static int sample_count = 0;
+static int dropped = 0;
+
+static double counter_to_ms(Uint64 ticks) {
+    return (double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+// Only events a player would see a reaction to are measured
+static int is_input_event(Uint32 type) {
+    return type == SDL_KEYDOWN || type == SDL_TEXTINPUT || type == SDL_MOUSEBUTTONDOWN;
+}
+
+// Enable the measurements (and optionally the late latch poll)
+void start_latency_tracking(int enable_late_latch) {
+    tracking = 1;
+    late_latch = enable_late_latch;
+    frame_number = 0;
+    pending_count = 0;
+    last_pending = -1;
+    sample_count = 0;
+    dropped = 0;
+    printf("Latency tracking enabled%s\n", late_latch ? " (late latch)" : "");
+}
+
+int is_latency_tracking(void) {
+    return tracking;
+}
+
+int is_late_latch_enabled(void) {
+    return tracking && late_latch;
+}
+
+// Stamp an event as it comes out of SDL_PollEvent. 'late' marks events
+// received by the late latch poll.
+void latency_event_received(const SDL_Event* event, int late) {
+    last_pending = -1;
+    if (!tracking || !is_input_event(event->type)) return;
+    if (pending_count >= LATENCY_MAX_PENDING) {
+        dropped++;
+        return;
+    }
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 ticks = SDL_GetTicks();
+    Uint32 waited_ms = ticks - event->common.timestamp;
+    if (waited_ms > 1000) waited_ms = 0;   // Synthetic or stale timestamp
+
+    last_pending = pending_count;
+    LatencySample* s = &pending[pending_count++];
+    memset(s, 0, sizeof(*s));
+    s->polled = now;
+    s->arrival = now - (Uint64)waited_ms * SDL_GetPerformanceFrequency() / 1000;
+    s->type = event->type;
+    s->late = late;
+    s->label = -1;
+}
+
+// The last event stamped was not applied by the late latch (the update that
+// reads it already ran): it is drawn by the next present, not this one
+void latency_defer_event(void) {
+    if (last_pending < 0) return;
+    pending[last_pending].late = 0;
+    pending[last_pending].deferred = 1;
+    last_pending = -1;
+}
+
+// The last event stamped edited the text of 'label' (an input field): it is
+// drawn once the label's current text has been uploaded
+void latency_wait_for_label(int label) {
+    if (last_pending < 0 || label < 0) return;
+    pending[last_pending].label = label;
+    pending[last_pending].text_generation = get_text_label_generation(label);
+}
+
+// Call right after SDL_RenderPresent: the pending events are on screen,
+// except the deferred ones and text edits still being rasterized, which
+// stay for a later present
+void latency_frame_presented(void) {
+    if (!tracking) return;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    int kept = 0;
+    for (int i = 0; i < pending_count; i++) {
+        if (pending[i].deferred) {
+            pending[i].deferred = 0;
+            pending[kept++] = pending[i];
+            continue;
+        }
+        if (!is_text_label_shown(pending[i].label, pending[i].text_generation)) {
+            pending[i].late = 0;
+            pending[kept++] = pending[i];
+            continue;
+        }
+        if (sample_count >= LATENCY_MAX_SAMPLES) {
+            dropped++;
+            continue;
+        }
+        LatencySample* s = &samples[sample_count++];
+        *s = pending[i];
+        s->frame = frame_number;
+        s->queue_ms = counter_to_ms(s->polled - s->arrival);
+        s->total_ms = counter_to_ms(now - s->arrival);
+    }
+    pending_count = kept;
+    last_pending = -1;
+    frame_number++;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Distribution of the samples polled normally (late = 0) or by the latch
+static void print_group(const char* label, int late) {
+    static double totals[LATENCY_MAX_SAMPLES];
+    int count = 0;
+    double sum = 0.0, queue = 0.0;
+    for (int i = 0; i < sample_count; i++) {
+        if (samples[i].late != late) continue;
+        totals[count++] = samples[i].total_ms;
+        sum += samples[i].total_ms;
+        queue += samples[i].queue_ms;
+    }
+    if (count == 0) return;
+    qsort(totals, count, sizeof(double), compare_doubles);
+
+    printf("%-11s %d events | min %.2f ms | avg %.2f ms | p50 %.2f ms | p95 %.2f ms | p99 %.2f ms | max %.2f ms\n",
+           label, count, totals[0], sum / count, totals[count / 2],
+           totals[(int)(count * 0.95)], totals[(int)(count * 0.99)], totals[count - 1]);
+    printf("%-11s avg %.2f ms queued before the poll, %.2f ms from poll to present\n",
+           "", queue / count, (sum - queue) / count);
+}
+
+void print_latency_report(void) {
+    if (!tracking) return;
+
+    printf("\n=== INPUT LATENCY REPORT (event to present, %u frames) ===\n", frame_number);
+    if (sample_count == 0) {
+        printf("No input events measured\n");
+    }
+    print_group("Frame start", 0);
+    print_group("Late latch", 1);
+    printf("Text edits are counted once their rasterized text is uploaded\n");
+    if (dropped > 0) printf("%d events not measured (buffers full)\n", dropped);
+    printf("==========================================================\n");
+}
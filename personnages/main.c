@@ -1,98 +1,186 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "header.h"
 
-// Screen dimensions (adjust as needed)
-#define SCREEN_WIDTH 1280
-#define SCREEN_HEIGHT 720
+// Application-level event handling (after the input fields had their turn).
+// Shared by live input and replays so both exercise the same code path.
+static void handle_app_event(SDL_Event* event, int* running) {
+    // Route event to input system first (clicks, text …)
+    handle_input_event(event);
 
-int main(void) {
-    SDL_Window* window = NULL;
-    SDL_Renderer* renderer = NULL;
-    int running = 1;
-    
-    printf("Initializing SDL2...\n");
-    
-    // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
-        return 1;
+    // Key presses go to their binding (controls.c), pointer state to the snapshot
+    dispatch_control_event(event);
+
+    if (event->type == SDL_QUIT) {
+        *running = 0;
     }
-    
-    // Initialize SDL_image for PNG/JPG support
-    int img_flags = IMG_INIT_PNG | IMG_INIT_JPG;
-    if (!(IMG_Init(img_flags) & img_flags)) {
-        printf("SDL_image could not initialize! IMG_Error: %s\n", IMG_GetError());
-        SDL_Quit();
-        return 1;
+    // Render target contents are lost on device / target resets
+    if (event->type == SDL_RENDER_TARGETS_RESET || event->type == SDL_RENDER_DEVICE_RESET) {
+        invalidate_tilemap_cache();
     }
-    
-    // Initialize SDL_ttf for text rendering
-    if (TTF_Init() == -1) {
-        printf("SDL_ttf could not initialize! TTF_Error: %s\n", TTF_GetError());
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-    
-    // Initialize SDL_mixer for audio
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        printf("SDL_mixer could not initialize! Mix_Error: %s\n", Mix_GetError());
-        TTF_Quit();
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+}
+
+// ESC: unfocus the input field if one has the focus, otherwise quit
+static void on_escape(const SDL_Event* event, void* data) {
+    (void)event;
+    if (get_focused_input()) {
+        unfocus_all_inputs();
+    } else {
+        *(int*)data = 0;
     }
-    
-    printf("SDL_mixer initialized (44.1kHz, stereo)\n");
-    
-    // Create window
-    window = SDL_CreateWindow("Background Display",
-                              SDL_WINDOWPOS_CENTERED,
-                              SDL_WINDOWPOS_CENTERED,
-                              SCREEN_WIDTH,
-                              SCREEN_HEIGHT,
-                              SDL_WINDOW_SHOWN);
-    
-    if (!window) {
-        printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+}
+
+// +/- : music volume by steps of 5 (data holds the step)
+static void on_volume_step(const SDL_Event* event, void* data) {
+    (void)event;
+    set_background_music_volume(background.music_volume + *(const int*)data);
+}
+
+static void on_pause_music(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    pause_background_music();
+}
+
+static void on_resume_music(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    resume_background_music();
+}
+
+// Volume indicator hue: green, yellow or orange depending on the volume
+static void update_volume_hue(const Observable* obs, void* data) {
+    Color* hue = (Color*)data;
+    if (obs->value < 40) {
+        *hue = create_color(50, 100, 50, 255);   // Green for low
+    } else if (obs->value < 80) {
+        *hue = create_color(100, 100, 50, 255);  // Yellow for medium
+    } else {
+        *hue = create_color(100, 50, 50, 255);   // Orange for high
     }
-    
-    // Create renderer
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        printf("Renderer could not be created! SDL_Error: %s\n", SDL_GetError());
-        SDL_DestroyWindow(window);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+}
+
+// Enter (no field focused): go on to the screen that follows this one
+static void on_next_scene(const SDL_Event* event, void* data) {
+    (void)event; (void)data;
+    request_scene(get_next_scene(get_active_scene()));
+}
+
+// F1-F4: jump to a screen (data holds its name)
+static void on_goto_scene(const SDL_Event* event, void* data) {
+    (void)event;
+    request_scene(find_scene((const char*)data));
+}
+
+// =============================================================================
+// SCENES - menu, character select, game and results (see scene_manager.c)
+// =============================================================================
+
+// Font of every scene, picked once at startup (NULL = no text)
+static const char* ui_font = NULL;
+
+// Game scene widgets and what was registered for them outside its pools
+static RoundSequence* vol_indicator = NULL;
+static Color volume_hue = {50, 100, 50, 255};
+static int volume_bindings[2] = {-1, -1};
+static int player_colliders[2] = {-1, -1};
+static int volume_collider = -1;
+static Sequence* name_fields[2] = {NULL, NULL};
+
+// First system font that opens
+static const char* pick_ui_font(void) {
+    static const char* font_paths[] = {
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf",
+        "/usr/share/fonts/truetype/liberation/LiberationSans-Bold.ttf",
+        "/usr/share/fonts/truetype/freefont/FreeSansBold.ttf",
+        "/usr/share/fonts/truetype/ubuntu/Ubuntu-B.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        NULL
+    };
+
+    for (int i = 0; font_paths[i] != NULL; i++) {
+        TTF_Font* font = TTF_OpenFont(font_paths[i], 16);
+        if (font) {
+            TTF_CloseFont(font);
+            printf("Using font: %s\n", font_paths[i]);
+            return font_paths[i];
+        }
     }
-    
-    // Initialize background
-    if (init_background(renderer, "background_main.jpg") != 0) {
-        printf("Failed to initialize background\n");
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        Mix_CloseAudio();
-        TTF_Quit();
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+    printf("Warning: No system font found - text will not be displayed\n");
+    return NULL;
+}
+
+// Panel with a title, a line of text and a hint (sequences 0 to 3)
+static void create_card(const char* title, const char* text, const char* hint) {
+    Color clear = create_color(0, 0, 0, 0);
+    create_sequence(0, "card", 240, 160, 800, 400, create_color(0, 0, 0, 120), "", 16);
+    create_sequence(1, "card_title", 0, 40, 800, 80, clear, title, 40);
+    create_sequence(2, "card_text", 0, 170, 800, 60, clear, text, 22);
+    create_sequence(3, "card_hint", 0, 340, 800, 40, clear, hint, 14);
+
+    Sequence* card = get_sequence_by_id(0);
+    for (int id = 1; id <= 3; id++) {
+        set_sequence_parent(get_sequence_by_id(id), card, 0);
     }
-    
-    // Initialize and play background music
-    // Volume set to 32 (25% of max 128) for subtle background sound
-    if (init_background_music("background_sound.wav", 32) == 0) {
-        play_background_music();
-    } else {
-        printf("Warning: Background music failed to load, continuing without music\n");
+}
+
+// Every scene fades in when entered (its first sequence is the root)
+static void fade_in_scene(int scene, SDL_Renderer* renderer) {
+    (void)scene; (void)renderer;
+    if (sequence_count == 0) return;
+    set_sequence_opacity(&sequences[0], 0);
+    tween_sequence_alpha(&sequences[0], 255, 0.4f, EASE_OUT_QUAD);
+}
+
+static void build_menu_scene(int scene, SDL_Renderer* renderer) {
+    (void)scene; (void)renderer;
+    create_card("Personnages", "Press Enter to start", "F1-F4 - Switch screens | ESC - Quit");
+    if (ui_font) load_font_all_sequences(ui_font);
+}
+
+// Character select: both players side by side under the title
+static void build_select_scene(int scene, SDL_Renderer* renderer) {
+    (void)scene; (void)renderer;
+    create_card("Choose your characters", "", "Enter - Play | F1 - Menu");
+    Sequence* card = get_sequence_by_id(0);
+
+    create_sequence(4, "select_p1", 170, 110, 140, 180, create_color(255, 100, 100, 40), "", 16);
+    create_sequence(5, "select_p2", 490, 110, 140, 180, create_color(100, 255, 100, 40), "", 16);
+    create_sequence(6, "select_p1_name", 170, 295, 140, 30, create_color(0, 0, 0, 0), "Player 1", 16);
+    create_sequence(7, "select_p2_name", 490, 295, 140, 30, create_color(0, 0, 0, 0), "Player 2", 16);
+    set_sequence_scene_image(get_sequence_by_id(4), "first_player.png");
+    set_sequence_scene_image(get_sequence_by_id(5), "second_player.png");
+    for (int id = 4; id <= 7; id++) {
+        set_sequence_parent(get_sequence_by_id(id), card, 0);
     }
-    
-    // Initialize sequences system
-    init_sequences();
-    
+    if (ui_font) load_font_all_sequences(ui_font);
+}
+
+static void build_results_scene(int scene, SDL_Renderer* renderer) {
+    (void)scene; (void)renderer;
+    create_card("Results", "", "Enter - Back to the menu | F3 - Play again");
+    if (ui_font) load_font_all_sequences(ui_font);
+}
+
+// Name typed for a player in the game scene, or a default one
+static const char* player_name(int player) {
+    static const char* defaults[2] = {"Player 1", "Player 2"};
+    Sequence* field = name_fields[player];
+    return field && field->input_buffer[0] ? field->input_buffer : defaults[player];
+}
+
+static void enter_results_scene(int scene, SDL_Renderer* renderer) {
+    char text[256];
+    snprintf(text, sizeof(text), "%s and %s played for %.1f s",
+             player_name(0), player_name(1), (double)game.tick / GAME_TICK_RATE);
+    update_sequence_text(get_sequence_by_id(2), text);
+    fade_in_scene(scene, renderer);
+}
+
+// The game screen: players, their controls and name fields, volume indicator
+static void build_game_scene(int scene, SDL_Renderer* renderer) {
+    (void)scene;
+    (void)renderer;
+
     // ============================================================================
     // MAIN CONTAINER - Transparent background
     // ============================================================================
@@ -125,15 +213,20 @@ int main(void) {
     Sequence* player1 = get_sequence_by_id(1);
     Sequence* player2 = get_sequence_by_id(2);
     
-    if (player1) {
-        if (load_sequence_image(renderer, player1, "first_player.png") != 0) {
-            printf("Warning: Failed to load first_player image\n");
-        }
-    }
-    
-    if (player2) {
-        if (load_sequence_image(renderer, player2, "second_player.png") != 0) {
-            printf("Warning: Failed to load second_player image\n");
+    // Player images come from the scene texture cache (decoded while the
+    // previous scene was running)
+    set_sequence_scene_image(player1, "first_player.png");
+    set_sequence_scene_image(player2, "second_player.png");
+
+    // Idle / walk cycles drawn over the static images when the sheets load
+    // (their atlases are the scene images above)
+    const char* player_sheets[2] = {"first_player.anim", "second_player.anim"};
+    Sequence* players[2] = {player1, player2};
+    for (int i = 0; i < 2; i++) {
+        int sheet = players[i] ? load_sprite_sheet(player_sheets[i]) : -1;
+        if (sheet >= 0) {
+            play_sequence_animation(players[i], sheet, "idle");
+            release_sprite_sheet(sheet);
         }
     }
     
@@ -151,72 +244,82 @@ int main(void) {
                    create_color(255, 255, 100, 40),  // Light yellow, very low opacity
                    "Player 1 Controls", 16);
     
-    // Player 1 keyboard keys (Q, Z, D, S) - centered in cross pattern
-    // Center of section2_left: x=250+157.5=407.5, y=400+77.5=477.5
-    int p1_center_x = 407;
-    int p1_center_y = 477;
+    // Right sequence in section 2 (separated with space)
+    create_sequence(5, "section2_right", 780, 400, 315, 155,
+                   create_color(255, 100, 255,0),  // Light magenta, very low opacity
+                   "Player 2 Controls", 16);
+    
+    Sequence* section2_container = get_sequence_by_id(3);
+    Sequence* section2_left = get_sequence_by_id(4);
+    Sequence* section2_right = get_sequence_by_id(5);
+    set_sequence_parent(section2_left, section2_container, 1);
+    set_sequence_parent(section2_right, section2_container, 1);
+    
+    // Keyboard keys are children of their control panel, so their positions
+    // are relative to the panel and both pads share the same layout.
+    // Center of a 315x155 panel: x=157, y=77
+    int pad_center_x = 157;
+    int pad_center_y = 77;
     int key_size = 50;
     int key_spacing = 60;
     
+    // Player 1 keyboard keys (Q, Z, D, S) - cross pattern inside section2_left
     // Q - LEFT key
-    create_sequence(10, "p1_key_left", p1_center_x - key_spacing-35, p1_center_y - key_size/2 +20, 
+    create_sequence(10, "p1_key_left", pad_center_x - key_spacing-35, pad_center_y - key_size/2 +20, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "Q", 20);
     
     // Z - TOP key
-    create_sequence(11, "p1_key_up", p1_center_x - key_size/2, p1_center_y - key_spacing, 
+    create_sequence(11, "p1_key_up", pad_center_x - key_size/2, pad_center_y - key_spacing, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "Z", 20);
     
     // D - RIGHT key
-    create_sequence(12, "p1_key_right", p1_center_x + key_spacing+35 - key_size, p1_center_y - key_size/2 +20, 
+    create_sequence(12, "p1_key_right", pad_center_x + key_spacing+35 - key_size, pad_center_y - key_size/2 +20, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "D", 20);
     
     // S - DOWN key
-    create_sequence(13, "p1_key_down", p1_center_x - key_size/2 , p1_center_y + key_spacing - key_size +6, 
+    create_sequence(13, "p1_key_down", pad_center_x - key_size/2 , pad_center_y + key_spacing - key_size +6, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "S", 20);
     
-    // Right sequence in section 2 (separated with space)
-    create_sequence(5, "section2_right", 780, 400, 315, 155,
-                   create_color(255, 100, 255,0),  // Light magenta, very low opacity
-                   "Player 2 Controls", 16);
-    
-    // Player 2 arrow keys - centered in cross pattern
-    // Center of section2_right: x=780+157.5=937.5, y=400+77.5=477.5
-    int p2_center_x = 937;
-    int p2_center_y = 477;
-    // key_size and key_spacing already defined above
-    
+    // Player 2 arrow keys - cross pattern inside section2_right
     // LEFT ARROW
-    create_sequence(14, "p2_key_left", p2_center_x - key_spacing -35, p2_center_y - key_size/2 +20, 
+    create_sequence(14, "p2_key_left", pad_center_x - key_spacing -35, pad_center_y - key_size/2 +20, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "←", 24);
     
     // UP ARROW
-    create_sequence(15, "p2_key_up", p2_center_x - key_size/2, p2_center_y - key_spacing, 
+    create_sequence(15, "p2_key_up", pad_center_x - key_size/2, pad_center_y - key_spacing, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "↑", 24);
     
     // RIGHT ARROW
-    create_sequence(16, "p2_key_right", p2_center_x + key_spacing - key_size +35, p2_center_y - key_size/2 +20, 
+    create_sequence(16, "p2_key_right", pad_center_x + key_spacing - key_size +35, pad_center_y - key_size/2 +20, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "→", 24);
     
     // DOWN ARROW
-    create_sequence(17, "p2_key_down", p2_center_x - key_size/2, p2_center_y + key_spacing - key_size, 
+    create_sequence(17, "p2_key_down", pad_center_x - key_size/2, pad_center_y + key_spacing - key_size, 
                    key_size, key_size,
                    create_color(255, 255, 255, 255),  // White, semi-transparent
                    "↓", 24);
     
+    for (int id = 10; id <= 13; id++) {
+        set_sequence_parent(get_sequence_by_id(id), section2_left, 0);
+    }
+    for (int id = 14; id <= 17; id++) {
+        set_sequence_parent(get_sequence_by_id(id), section2_right, 0);
+    }
+    
    // ============================================================================
     // SECTION 3: BOTTOM SECTION - Gets remaining space, contains 2 sequences
     // ============================================================================
@@ -236,6 +339,28 @@ int main(void) {
                    create_color(180, 100, 255, 40),  // Light purple, very low opacity
                    "Section 3 - Right Part", 16);
 
+    Sequence* section3_container = get_sequence_by_id(6);
+    set_sequence_parent(get_sequence_by_id(7), section3_container, 1);
+    set_sequence_parent(get_sequence_by_id(8), section3_container, 1);
+    
+    // Every section hangs off the main container, so moving or hiding it
+    // moves or hides the whole layout in one call
+    Sequence* main_container = get_sequence_by_id(0);
+    set_sequence_parent(player1, main_container, 1);
+    set_sequence_parent(player2, main_container, 1);
+    set_sequence_parent(section2_container, main_container, 1);
+    set_sequence_parent(section3_container, main_container, 1);
+
+    // ============================================================================
+    // GAME SIMULATION - players move inside the main container
+    // ============================================================================
+    init_game(main_container->w, main_container->h,
+              player1->local_x, player1->local_y,
+              player2->local_x, player2->local_y,
+              player1->w, player1->h);
+    bind_player_sequence(0, player1);
+    bind_player_sequence(1, player2);
+
     // ============================================================================
     // INPUT FIELDS - Enable sequences 7 and 8 as text input fields
     // ============================================================================
@@ -244,6 +369,14 @@ int main(void) {
 
     if (input7) set_sequence_input(input7, "Player 1 name...");
     if (input8) set_sequence_input(input8, "Player 2 name...");
+    name_fields[0] = input7;
+    name_fields[1] = input8;
+
+    // Key caps show the current player keys and follow rebinds
+    for (int action = 0; action < PLAYER_ACTION_COUNT; action++) {
+        set_player_key_cap(0, (PlayerAction)action, get_sequence_by_id(10 + action));
+        set_player_key_cap(1, (PlayerAction)action, get_sequence_by_id(14 + action));
+    }
     
     printf("\n=== SEQUENCE LAYOUT CREATED ===\n");
     printf("Main Container: Transparent background\n");
@@ -254,35 +387,12 @@ int main(void) {
     printf("Section 3 (Bottom): Left and Right parts\n");
     printf("================================\n\n");
 
-    // ============================================================================
-    // FONT LOADING - Load font for all sequences so text is visible
-    // ============================================================================
-    const char* font_paths[] = {
-        "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf",
-        "/usr/share/fonts/truetype/liberation/LiberationSans-Bold.ttf",
-        "/usr/share/fonts/truetype/freefont/FreeSansBold.ttf",
-        "/usr/share/fonts/truetype/ubuntu/Ubuntu-B.ttf",
-        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
-        NULL
-    };
-
-    int font_loaded = 0;
-    for (int i = 0; font_paths[i] != NULL; i++) {
-        if (load_font_all_sequences(font_paths[i]) > 0) {
-            printf("Using font: %s\n", font_paths[i]);
-            font_loaded = 1;
-            break;
-        }
-    }
-    if (!font_loaded) {
-        printf("Warning: No system font found - text will not be displayed\n");
-    }
+    // Font for all sequences so text is visible
+    if (ui_font) load_font_all_sequences(ui_font);
 
     // ============================================================================
-    // ROUND SEQUENCES - Initialize and create volume indicator
+    // ROUND SEQUENCES - Volume indicator
     // ============================================================================
-    init_round_sequences();
-    
     // Volume indicator - Round sequence in top-right corner
     // Position: top-right corner with 50px margin
     // Center: x = 1280 - 50 = 1230, y = 50
@@ -291,9 +401,370 @@ int main(void) {
                          create_color(50, 100, 50, 40),  // Green, very low opacity
                          "32", 18, 1);  // filled circle
     
+    // Text and hue follow the volume setting; they only change with it
+    vol_indicator = get_round_sequence_by_name("volume_indicator");
+    volume_bindings[0] = bind_round_sequence_text(OBSERVABLE_MUSIC_VOLUME, vol_indicator, NULL);
+    volume_bindings[1] = subscribe_observable(OBSERVABLE_MUSIC_VOLUME, update_volume_hue, &volume_hue);
+    
+    // Spectrum display just under the volume indicator
+    create_sequence(18, "spectrum", 1190, 100, 80, 40,
+                   create_color(0, 0, 0, 60),  // Dark, low opacity
+                   "", 12);
+    set_sequence_spectrum(get_sequence_by_id(18), create_color(120, 200, 120, 160));
+    
+    // Colliders: the two players, and the volume indicator as a round obstacle
+    player_colliders[0] = add_sequence_collider(player1);
+    player_colliders[1] = add_sequence_collider(player2);
+    volume_collider = add_round_sequence_collider(vol_indicator);
+}
+
+// Drop what the game scene registered outside its pools (the scene manager
+// releases the sequences themselves)
+static void unload_game_scene(int scene, SDL_Renderer* renderer) {
+    (void)scene; (void)renderer;
+    for (int i = 0; i < 2; i++) {
+        remove_collider(player_colliders[i]);
+        unbind(volume_bindings[i]);
+        player_colliders[i] = -1;
+        volume_bindings[i] = -1;
+        bind_player_sequence(i, NULL);
+        for (int action = 0; action < PLAYER_ACTION_COUNT; action++) {
+            set_player_key_cap(i, (PlayerAction)action, NULL);
+        }
+        name_fields[i] = NULL;
+    }
+    remove_collider(volume_collider);
+    volume_collider = -1;
+    vol_indicator = NULL;
+}
+
+// Game screen update: simulation, collisions and the volume indicator
+static void update_game_scene(int scene, double frame_seconds) {
+    (void)scene;
+
+    // Far layers drift with the players, at their own parallax factor
+    set_background_camera((game.players[0].x + game.players[1].x) * 0.5f - game.arena_w * 0.5f, 0.0f);
+
+    // Fixed-timestep game update; players don't move while typing a name
+    game_update(&game, frame_seconds, get_focused_input() ? NULL : get_input_snapshot()->keys);
+    apply_game_to_sequences(&game);
+    animate_players(&game);
+    
+    // Sparks where a player starts touching something (colliders follow
+    // the world positions, hence the layout first)
+    update_scene_graph();
+    update_collisions();
+    int contact_count;
+    const CollisionEvent* contacts = get_collision_events(&contact_count);
+    for (int i = 0; i < contact_count; i++) {
+        const CollisionEvent* contact = &contacts[i];
+        if (contact->type != COLLISION_BEGIN) continue;
+        if (contact->a != player_colliders[0] && contact->a != player_colliders[1] &&
+            contact->b != player_colliders[0] && contact->b != player_colliders[1]) continue;
+        emit_particles(find_particle_emitter("sparks"), contact->x, contact->y, 160);
+        play_sound("collide");
+    }
+    
+    // Brightness and size of the volume indicator follow the measured
+    // loudness of what is actually playing (setters skip unchanged values)
+    if (vol_indicator) {
+        const AudioAnalysis* analysis = get_audio_analysis();
+        Color color = volume_hue;
+        color.a = (Uint8)(40 + analysis->level * 120);
+        update_round_sequence_color(vol_indicator, color);
+        update_round_sequence_radius(vol_indicator, 40 + (int)(analysis->level * 8));
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    SDL_Window* window = NULL;
+    SDL_Renderer* renderer = NULL;
+    int running = 1;
+    
+    // Count SDL heap allocations from here on (must precede any other SDL call)
+    install_allocation_counters();
+    
+    // Command line options
+    //   --simulate [ticks] [seed]  headless simulation run
+    //   --record <file>            record input events
+    //   --replay <file>            replay recorded input
+    //   --fast                     replay at maximum speed (no vsync, no delay)
+    //   --report <file.csv>        write per-frame timings at exit
+    //   --bench [name]             run benchmarks (all by default) and exit
+    //   --latency                  measure input-to-present latency
+    //   --late-latch               same, polling input again before rendering
+    //   --scene <name>             first screen (menu, select, game, results)
+    //   --settings <file>          settings file (settings.bin by default)
+    //   --autotune                 measure the machine again and save the settings
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    const char* report_path = NULL;
+    int replay_fast = 0;
+    const char* bench_name = NULL;
+    int latency_mode = 0;   // 1 = measure, 2 = measure with late latch
+    const char* start_scene = NULL;
+    const char* settings_path = SETTINGS_DEFAULT_PATH;
+    int force_autotune = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--simulate") == 0) {
+            int ticks = i + 1 < argc ? atoi(argv[i + 1]) : GAME_TICK_RATE * 60;
+            Uint32 seed = i + 2 < argc ? (Uint32)strtoul(argv[i + 2], NULL, 10) : 1u;
+            SDL_Init(SDL_INIT_TIMER);
+            run_game_headless(ticks, seed);
+            SDL_Quit();
+            return 0;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            report_path = argv[++i];
+        } else if (strcmp(argv[i], "--fast") == 0) {
+            replay_fast = 1;
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            if (latency_mode == 0) latency_mode = 1;
+        } else if (strcmp(argv[i], "--late-latch") == 0) {
+            latency_mode = 2;
+        } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            start_scene = argv[++i];
+        } else if (strcmp(argv[i], "--settings") == 0 && i + 1 < argc) {
+            settings_path = argv[++i];
+        } else if (strcmp(argv[i], "--autotune") == 0) {
+            force_autotune = 1;
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            bench_name = (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) ? argv[++i] : "all";
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+        }
+    }
+    
+    printf("Initializing SDL2...\n");
+    
+    // Initialize SDL
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
+        return 1;
+    }
+    
+    // Initialize SDL_image for PNG/JPG support
+    int img_flags = IMG_INIT_PNG | IMG_INIT_JPG;
+    if (!(IMG_Init(img_flags) & img_flags)) {
+        printf("SDL_image could not initialize! IMG_Error: %s\n", IMG_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    
+    // Initialize SDL_ttf for text rendering
+    if (TTF_Init() == -1) {
+        printf("SDL_ttf could not initialize! TTF_Error: %s\n", TTF_GetError());
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    
+    // Worker threads for updates and asset decoding; the images decode
+    // while the audio device, window and renderer are being set up (the
+    // scenes load their own images, see scene_manager.c)
+    init_job_system(0);
+    const char* startup_images[] = {"background_main.jpg", "background_clouds.png"};
+    preload_images(startup_images, 2);
+    
+    // Machine-specific settings; without a valid file they are measured once
+    // the renderer exists
+    int settings_loaded = load_settings(settings_path) == 0;
+    
+    // Initialize the audio engine (saved buffer size, or picked for the device)
+    if (init_audio_engine(44100, get_settings()->audio_buffer_samples) != 0) {
+        TTF_Quit();
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    
+    // Create window
+    window = SDL_CreateWindow("Background Display",
+                              SDL_WINDOWPOS_CENTERED,
+                              SDL_WINDOWPOS_CENTERED,
+                              SCREEN_WIDTH,
+                              SCREEN_HEIGHT,
+                              SDL_WINDOW_SHOWN);
+    
+    if (!window) {
+        printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    
+    // Create renderer, with vsync only if the settings ask for it
+    Uint32 renderer_flags = SDL_RENDERER_ACCELERATED;
+    if (get_settings()->vsync) renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+    renderer = SDL_CreateRenderer(window, -1, renderer_flags);
+    if (!renderer) {
+        printf("Renderer could not be created! SDL_Error: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    
+    // Benchmarks only need the renderer; the startup images are finished
+    // (and dropped) first so their decoding stays out of the measurements
+    if (bench_name) {
+        release_preloaded_images();
+        int result = run_benchmarks(renderer, bench_name);
+        print_memory_stats();
+        shutdown_job_system();
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        shutdown_audio_engine();
+        TTF_Quit();
+        IMG_Quit();
+        SDL_Quit();
+        return result == 0 ? 0 : 1;
+    }
+    
+    // First start (or --autotune): short benchmarks pick the settings. The
+    // audio device is reopened if the tuned buffer size differs.
+    ui_font = pick_ui_font();
+    if (!settings_loaded || force_autotune) {
+        if (autotune_settings(renderer, window, ui_font) == 0) {
+            save_settings(settings_path);
+            apply_vsync_setting(renderer);
+        }
+        int buffer = get_settings()->audio_buffer_samples;
+        if (buffer > 0 && buffer != audio.buffer_samples) {
+            shutdown_audio_engine();
+            if (init_audio_engine(44100, buffer) != 0) {
+                printf("Warning: Audio could not be reopened, continuing without sound\n");
+            }
+        }
+    }
+    print_settings();
+    
+    // Initialize background
+    if (init_background(renderer, "background_main.jpg") != 0) {
+        printf("Failed to initialize background\n");
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        shutdown_audio_engine();
+        TTF_Quit();
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    
+    // Optional cloud layer drifting in front of the image (repeats horizontally)
+    int clouds = add_background_layer("background_clouds.png", 0.3f, 0.0f, 1, 0);
+    if (clouds >= 0) {
+        set_background_layer_scroll(clouds, 12.0f, 0.0f);
+    }
+    
+    // UI state is published through observables (binding.c)
+    init_bindings();
+    
+    // Initialize and play background music
+    // Volume set to 32 (25% of max 128) for subtle background sound
+    if (init_background_music("background_sound.wav", 32) == 0) {
+        play_background_music();
+    } else {
+        printf("Warning: Background music failed to load, continuing without music\n");
+    }
+    
+    // Preload short sound effects (optional)
+    load_sound("confirm", "confirm.wav", 5, 96);
+    load_sound("collide", "collide.wav", 3, 96);
+    
+    // Particle effects: sparks when the players collide, confetti on name confirmation
+    ParticleEmitterConfig sparks = {
+        .direction = 0.0f, .spread = 6.2832f, .speed_min = 120.0f, .speed_max = 420.0f,
+        .life_min = 0.25f, .life_max = 0.6f, .gravity = 600.0f, .drag = 0.05f, .size = 5.0f,
+        .blend = SDL_BLENDMODE_ADD,
+        .palette = {{255, 230, 120, 255}, {255, 160, 40, 255}, {255, 255, 255, 255}},
+        .palette_size = 3
+    };
+    ParticleEmitterConfig confetti = {
+        .direction = -1.5708f, .spread = 1.6f, .speed_min = 200.0f, .speed_max = 520.0f,
+        .life_min = 1.2f, .life_max = 2.2f, .gravity = 500.0f, .drag = 0.3f, .size = 8.0f,
+        .blend = SDL_BLENDMODE_BLEND,
+        .palette = {{255, 80, 80, 255}, {80, 200, 255, 255}, {255, 220, 60, 255},
+                    {120, 255, 120, 255}, {230, 120, 255, 255}},
+        .palette_size = 5
+    };
+    // The particle limit is shared a third / two thirds like the original 2048 / 4096
+    int spark_count = get_settings()->particle_limit / 3;
+    create_particle_emitter("sparks", spark_count, &sparks);
+    create_particle_emitter("confetti", get_settings()->particle_limit - spark_count, &confetti);
+    
+    // Analyse the mixed output for the volume indicator and spectrum display
+    start_audio_analysis();
+    
+    // ============================================================================
+    // CONTROLS - key bindings by focus context, rebindable player keys
+    // ============================================================================
+    static const int volume_up = 5, volume_down = -5;
+    register_input_field_controls();
+    bind_key(SDLK_ESCAPE, 0, CONTROL_CONTEXT_ANY, on_escape, &running);
+    // Music controls only when no input field is focused (letters are typed there)
+    bind_key(SDLK_PLUS, 0, CONTROL_CONTEXT_GAME, on_volume_step, (void*)&volume_up);
+    bind_key(SDLK_EQUALS, 0, CONTROL_CONTEXT_GAME, on_volume_step, (void*)&volume_up);
+    bind_key(SDLK_MINUS, 0, CONTROL_CONTEXT_GAME, on_volume_step, (void*)&volume_down);
+    bind_key(SDLK_UNDERSCORE, 0, CONTROL_CONTEXT_GAME, on_volume_step, (void*)&volume_down);
+    bind_key(SDLK_p, 0, CONTROL_CONTEXT_GAME, on_pause_music, NULL);
+    bind_key(SDLK_r, 0, CONTROL_CONTEXT_GAME, on_resume_music, NULL);
+    // Screens: Enter goes on (it confirms the name while a field is focused)
+    bind_key(SDLK_RETURN, 0, CONTROL_CONTEXT_GAME, on_next_scene, NULL);
+    bind_key(SDLK_KP_ENTER, 0, CONTROL_CONTEXT_GAME, on_next_scene, NULL);
+    bind_key(SDLK_F1, 0, CONTROL_CONTEXT_ANY, on_goto_scene, (void*)"menu");
+    bind_key(SDLK_F2, 0, CONTROL_CONTEXT_ANY, on_goto_scene, (void*)"select");
+    bind_key(SDLK_F3, 0, CONTROL_CONTEXT_ANY, on_goto_scene, (void*)"game");
+    bind_key(SDLK_F4, 0, CONTROL_CONTEXT_ANY, on_goto_scene, (void*)"results");
+    init_player_controls();
+
+    // ============================================================================
+    // SCENES - each screen owns its sequences; the one that follows the
+    // active screen is loaded and built in the background
+    // ============================================================================
+    init_scene_manager(renderer);
+    SceneConfig menu_config = {
+        .next = "select", .build = build_menu_scene, .enter = fade_in_scene
+    };
+    SceneConfig select_config = {
+        .next = "game", .images = {"first_player.png", "second_player.png"}, .image_count = 2,
+        .build = build_select_scene, .enter = fade_in_scene
+    };
+    SceneConfig game_config = {
+        .next = "results", .images = {"first_player.png", "second_player.png"}, .image_count = 2,
+        .build = build_game_scene, .enter = fade_in_scene, .unload = unload_game_scene,
+        .update = update_game_scene
+    };
+    SceneConfig results_config = {
+        .next = "menu", .build = build_results_scene, .enter = enter_results_scene
+    };
+    register_scene("menu", &menu_config);
+    register_scene("select", &select_config);
+    register_scene("game", &game_config);
+    register_scene("results", &results_config);
+    
+    // Texture budgets (the scene manager must exist)
+    apply_settings();
+
+    // Recordings start in the game, like the ones made before the screens existed
+    if (!start_scene) start_scene = (replay_path || record_path) ? "game" : "menu";
+    int first_scene = find_scene(start_scene);
+    if (first_scene < 0) {
+        printf("Unknown scene '%s', starting with the menu\n", start_scene);
+        first_scene = find_scene("menu");
+    }
+    switch_scene(first_scene);
+    
     printf("\nSDL2 initialized successfully!\n");
     printf("\n=== CONTROLS ===\n");
     printf("ESC         - Exit (or unfocus input)\n");
+    printf("Enter       - Next screen (when no field is focused)\n");
+    printf("F1-F4       - Menu, character select, game, results\n");
     printf("+           - Increase volume (+5)\n");
     printf("-           - Decrease volume (-5)\n");
     printf("P           - Pause music\n");
@@ -305,76 +776,115 @@ int main(void) {
     printf("Left/Right  - Move cursor\n");
     printf("Home/End    - Jump to start/end\n");
     printf("Tab         - Switch between fields\n");
+    printf("--- Players (when no field is focused) ---\n");
+    printf("Q/Z/D/S     - Move player 1\n");
+    printf("Arrows      - Move player 2\n");
     printf("Enter       - Confirm input\n");
     printf("================\n\n");
     
+    // Events handled after the update would land in another frame of a
+    // recording than the one a replay gives them to
+    if (latency_mode == 2 && (replay_path || record_path)) {
+        printf("Warning: Late latch is disabled while recording or replaying\n");
+        latency_mode = 1;
+    }
+    if (latency_mode) start_latency_tracking(latency_mode == 2);
+    
+    // Recording / replay
+    if (replay_path) {
+        if (start_input_replay(replay_path, replay_fast) != 0) {
+            running = 0;
+        } else if (replay_fast) {
+            SDL_RenderSetVSync(renderer, 0);
+        }
+    } else if (record_path) {
+        start_input_recording(record_path);
+    }
+    
     // Main game loop
     SDL_Event event;
+    Uint64 perf_freq = SDL_GetPerformanceFrequency();
+    Uint64 last_counter = SDL_GetPerformanceCounter();
     while (running) {
-        // Handle events
-        while (SDL_PollEvent(&event)) {
-            // Route event to input system first (clicks, text, backspace …)
-            handle_input_event(&event);
+        profiler_begin_frame();
+        
+        // Real time elapsed since the previous frame
+        Uint64 now_counter = SDL_GetPerformanceCounter();
+        double frame_dt = (double)(now_counter - last_counter) / (double)perf_freq;
+        last_counter = now_counter;
 
-            if (event.type == SDL_QUIT) {
+        // Handle events
+        const Uint8* keys = SDL_GetKeyboardState(NULL);
+        if (is_replay_active()) {
+            // Recorded frame time replaces the measured one
+            if (!replay_begin_frame(&frame_dt)) {
                 running = 0;
             }
-            if (event.type == SDL_KEYDOWN) {
-                if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    // If an input is focused, ESC unfocuses it; otherwise quit
-                    if (get_focused_input()) {
-                        unfocus_all_inputs();
-                    } else {
-                        running = 0;
-                    }
-                }
-                // Volume controls - only when no input field is focused
-                else if (!get_focused_input() &&
-                         (event.key.keysym.sym == SDLK_PLUS ||
-                          event.key.keysym.sym == SDLK_EQUALS)) {
-                    set_background_music_volume(background.music_volume + 5);
-                }
-                else if (!get_focused_input() &&
-                         (event.key.keysym.sym == SDLK_MINUS ||
-                          event.key.keysym.sym == SDLK_UNDERSCORE)) {
-                    set_background_music_volume(background.music_volume - 5);
-                }
-                else if (event.key.keysym.sym == SDLK_p) {
-                    // Pause music
-                    pause_background_music();
-                }
-                else if (event.key.keysym.sym == SDLK_r) {
-                    // Resume music
-                    resume_background_music();
-                }
+            while (replay_poll_event(&event)) {
+                handle_app_event(&event, &running);
+            }
+            keys = replay_keyboard_state();
+            
+            // Live events only matter for closing the window
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT) running = 0;
+            }
+        } else {
+            record_input_frame(frame_dt);
+            while (SDL_PollEvent(&event)) {
+                Sequence* focused = get_focused_input();
+                latency_event_received(&event, 0);
+                record_input_event(&event);
+                handle_app_event(&event, &running);
+                if (focused) latency_wait_for_label(focused->text_label);
             }
         }
+        update_input_snapshot(keys);
+        profiler_end_phase(PROFILE_EVENTS);
         
         // Update
-        update_background();
+        // Pending screen switch, background loading of the next screen and
+        // the active screen's own update (the game runs in the game scene)
+        update_scenes(frame_dt);
+        update_background(frame_dt);
         update_input_cursors();
+        update_animations(frame_dt);
+        update_tweens(frame_dt);
+        update_scene_graph();
+        update_particles(frame_dt);
         
-        // Update volume indicator display (round sequence)
-        RoundSequence* vol_indicator = get_round_sequence_by_name("volume_indicator");
-        if (vol_indicator) {
-            char vol_text[64];
-            snprintf(vol_text, sizeof(vol_text), "%d", background.music_volume);
-            update_round_sequence_text(vol_indicator, vol_text);
-            
-            // Change color based on volume level (very low opacity)
-            if (background.music_volume < 40) {
-                vol_indicator->color = create_color(50, 100, 50, 40); // Green for low
-            } else if (background.music_volume < 80) {
-                vol_indicator->color = create_color(100, 100, 50, 40); // Yellow for medium
-            } else {
-                vol_indicator->color = create_color(100, 50, 50, 40); // Orange for high
+        // State changed this frame reaches its bound widgets, once per value
+        flush_bindings();
+        profiler_end_phase(PROFILE_UPDATE);
+        
+        // Late latch: input that arrived during the update still makes it
+        // into this frame (focus, text, bound values, layout). Game input is
+        // read by the update, which already ran: it takes effect next frame
+        // and is measured against that frame's present.
+        if (is_late_latch_enabled()) {
+            while (SDL_PollEvent(&event)) {
+                Sequence* focused = get_focused_input();
+                latency_event_received(&event, 1);
+                handle_app_event(&event, &running);
+                if (focused) latency_wait_for_label(focused->text_label);
+                else if (!get_focused_input()) latency_defer_event();
             }
+            flush_bindings();
+            update_scene_graph();
+            profiler_end_phase(PROFILE_EVENTS);
         }
         
         // Clear screen
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
         
+        // Text rasterized by the workers since last frame goes to the GPU
+        update_text_labels(renderer);
+        
+        // Widgets queue their draw commands; the queue sorts them by
+        // layer and render state before submitting
+        render_queue_begin(renderer);
+        
         // Draw background
         draw_background(renderer);
         
@@ -384,21 +894,60 @@ int main(void) {
         // Draw all round sequences
         draw_all_round_sequences(renderer);
         
+        // Particles above everything else
+        draw_particles();
+        
+        render_queue_end(renderer);
+        profiler_end_phase(PROFILE_RENDER);
+        
         // Present
         SDL_RenderPresent(renderer);
+        latency_frame_presented();
+        reset_frame_arena();
+        profiler_end_phase(PROFILE_PRESENT);
+        profiler_end_frame();
         
-        // Small delay to prevent high CPU usage
-        SDL_Delay(16); // ~60 FPS
+        // Wait out the rest of the frame at the target rate (not when
+        // replaying flat out)
+        if (!(is_replay_active() && replay_fast)) {
+            limit_frame_rate(now_counter);
+        }
+    }
+    
+    stop_input_recording();
+    stop_input_replay();
+    profiler_print_report();
+    print_latency_report();
+    if (report_path) {
+        profiler_write_csv(report_path);
     }
     
     // Cleanup
     printf("\nCleaning up...\n");
-    cleanup_sequences();
-    cleanup_round_sequences();
+    render_queue_print_stats();
+    print_cull_stats();
+    print_background_stats();
+    print_collision_stats();
+    print_memory_stats();
+    print_texture_pool_stats();
+    print_binding_stats();
+    print_scene_stats();
+    cleanup_scenes();
+    cleanup_sequence_fonts();
+    cleanup_bindings();
+    cleanup_collisions();
+    cleanup_text();
+    cleanup_texture_pool();
+    cleanup_animations();
+    cleanup_particles();
+    stop_audio_analysis();
     cleanup_background();
+    cleanup_scratch_surfaces();
+    release_preloaded_images();
+    shutdown_job_system();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
-    Mix_CloseAudio();
+    shutdown_audio_engine();
     TTF_Quit();
     IMG_Quit();
     SDL_Quit();
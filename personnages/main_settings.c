@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <math.h>
+#include "header.h"
+
+// =============================================================================
+// SETTINGS AUTO-TUNE - micro-benchmarks run on the first start (--autotune)
+// =============================================================================
+//
+// A few short measurements stand in for the machine: how fast the renderer
+// blends full-screen rectangles, how long the font takes to rasterize a
+// label, how long the post-mix processing (spectrum analysis and gain ramp)
+// takes per buffer, and the refresh rate of the display. Each knob of the
+// Settings is then picked from the measurement that limits it. The whole run
+// takes a fraction of a second and its result is saved, so later starts only
+// read the settings file.
+
+#define AUTOTUNE_FILL_PASSES 24
+#define AUTOTUNE_OVERDRAW 8        // Full-screen layers drawn in a typical frame
+#define AUTOTUNE_TEXT_LABELS 64
+#define AUTOTUNE_AUDIO_RUNS 16
+
+static double ticks_to_us(Uint64 ticks) {
+    return (double)ticks * 1e6 / (double)SDL_GetPerformanceFrequency();
+}
+
+// Blended fill rate in megapixels per second (0 if render targets are not
+// available). A 1x1 read back waits for the GPU to finish the passes.
+static double measure_fill_rate(SDL_Renderer* renderer) {
+    SDL_Texture* target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                            SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!target) {
+        printf("Warning: Fill rate not measured: %s\n", SDL_GetError());
+        return 0.0;
+    }
+
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, target);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    SDL_Rect probe = {0, 0, 1, 1};
+    Uint32 pixel;
+
+    // Warm-up pass so the driver has compiled its pipeline
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderReadPixels(renderer, &probe, SDL_PIXELFORMAT_RGBA8888, &pixel, sizeof(pixel));
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < AUTOTUNE_FILL_PASSES; i++) {
+        SDL_SetRenderDrawColor(renderer, (Uint8)(i * 10), 80, 160, 64);
+        SDL_RenderFillRect(renderer, &screen);
+    }
+    SDL_RenderReadPixels(renderer, &probe, SDL_PIXELFORMAT_RGBA8888, &pixel, sizeof(pixel));
+    double us = ticks_to_us(SDL_GetPerformanceCounter() - start);
+
+    SDL_SetRenderTarget(renderer, previous);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_DestroyTexture(target);
+    if (us <= 0.0) return 0.0;
+    return (double)SCREEN_WIDTH * SCREEN_HEIGHT * AUTOTUNE_FILL_PASSES / us;
+}
+
+// Microseconds to rasterize one short label (0 if the font cannot be opened)
+static double measure_text(const char* font_path) {
+    if (!font_path) return 0.0;
+    TTF_Font* font = TTF_OpenFont(font_path, 24);
+    if (!font) {
+        printf("Warning: Text speed not measured: %s\n", TTF_GetError());
+        return 0.0;
+    }
+
+    SDL_Color white = {255, 255, 255, 255};
+    char label[32];
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < AUTOTUNE_TEXT_LABELS; i++) {
+        snprintf(label, sizeof(label), "Score %d - Round %d", i * 37, i);
+        SDL_Surface* surface = TTF_RenderUTF8_Blended(font, label, white);
+        if (surface) SDL_FreeSurface(surface);
+    }
+    double us = ticks_to_us(SDL_GetPerformanceCounter() - start);
+    TTF_CloseFont(font);
+    return us / AUTOTUNE_TEXT_LABELS;
+}
+
+// Post-mix processing per buffer of 256, 512, ... 4096 frames
+static void measure_audio(double audio_us[5]) {
+    Sint16* samples = SDL_malloc(4096 * 2 * sizeof(Sint16));
+    if (!samples) {
+        printf("Error: Failed to allocate the audio benchmark buffer\n");
+        return;
+    }
+    for (int i = 0; i < 4096; i++) {
+        Sint16 v = (Sint16)(8000.0 * sin(i * 0.0627));
+        samples[2 * i] = v;
+        samples[2 * i + 1] = v;
+    }
+
+    for (int k = 0; k < 5; k++) {
+        int frames = 256 << k;
+        double analysis = time_audio_analysis(samples, frames, AUTOTUNE_AUDIO_RUNS);
+
+        GainRamp ramp;
+        init_gain_ramp(&ramp, 0.5f);
+        start_gain_ramp(&ramp, 1.0f, frames * AUTOTUNE_AUDIO_RUNS);
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < AUTOTUNE_AUDIO_RUNS; i++) {
+            apply_gain_ramp(&ramp, samples, frames);
+        }
+        double gain = ticks_to_us(SDL_GetPerformanceCounter() - start) / AUTOTUNE_AUDIO_RUNS;
+
+        audio_us[k] = (analysis > 0.0 ? analysis : 0.0) + gain;
+    }
+    SDL_free(samples);
+}
+
+static int measure_refresh_rate(SDL_Window* window) {
+    SDL_DisplayMode mode;
+    if (window && SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) {
+        return mode.refresh_rate;
+    }
+    return 60;
+}
+
+// -----------------------------------------------------------------------------
+// Picking the settings
+// -----------------------------------------------------------------------------
+
+static void pick_settings(const SettingsBenchmark* bench, Settings* s) {
+    // Frame pacing: vsync at the display rate when a typical frame fits in
+    // the refresh period with a 50% margin, otherwise a capped rate
+    if (bench->fill_mpixels > 0.0) {
+        double frame_us = (double)SCREEN_WIDTH * SCREEN_HEIGHT * AUTOTUNE_OVERDRAW / bench->fill_mpixels;
+        double period_us = 1e6 / bench->refresh_rate;
+        if (frame_us * 1.5 <= period_us) {
+            s->vsync = SETTINGS_VSYNC_ON;
+            s->target_fps = bench->refresh_rate;
+        } else {
+            int fps = (int)(1e6 / (frame_us * 1.5));
+            s->vsync = SETTINGS_VSYNC_OFF;
+            s->target_fps = fps < 30 ? 30 : (fps > 60 ? 60 : fps);
+        }
+    }
+
+    // Slow rasterization is worth keeping more text textures around
+    if (bench->text_us > 0.0) {
+        s->text_cache_kb = bench->text_us < 50.0 ? 4 * 1024 : (bench->text_us < 200.0 ? 8 * 1024 : 16 * 1024);
+    }
+
+    // Texture budget and particle count follow the fill rate; particles get
+    // a tenth of a frame at roughly 64 pixels each
+    if (bench->fill_mpixels > 0.0) {
+        s->texture_budget_kb = bench->fill_mpixels < 500.0 ? 32 * 1024
+                             : (bench->fill_mpixels < 2000.0 ? 64 * 1024 : 128 * 1024);
+        int fps = s->target_fps > 0 ? s->target_fps : bench->refresh_rate;
+        double particles = bench->fill_mpixels * 1e6 / fps * 0.10 / 64.0;
+        s->particle_limit = particles < 1024.0 ? 1024 : (particles > 16384.0 ? 16384 : (int)particles);
+    }
+
+    // Smallest buffer whose processing stays under 10% of its duration, never
+    // below what the device needs for a stable output
+    int frequency = audio.opened ? audio.frequency : 44100;
+    int floor_samples = choose_audio_buffer_size(frequency);
+    s->audio_buffer_samples = 4096;
+    for (int k = 0; k < 5; k++) {
+        int frames = 256 << k;
+        double budget_us = frames * 1e6 / frequency * 0.10;
+        if (frames >= floor_samples && bench->audio_us[k] <= budget_us) {
+            s->audio_buffer_samples = frames;
+            break;
+        }
+    }
+}
+
+// Measure the machine and replace the settings with values picked for it.
+// 'font_path' is the UI font (NULL skips the text measurement).
+int autotune_settings(SDL_Renderer* renderer, SDL_Window* window, const char* font_path) {
+    if (!renderer) {
+        printf("Error: Auto-tune needs a renderer\n");
+        return -1;
+    }
+
+    SettingsBenchmark bench = {0};
+    Uint64 start = SDL_GetPerformanceCounter();
+    bench.refresh_rate = measure_refresh_rate(window);
+    bench.fill_mpixels = measure_fill_rate(renderer);
+    bench.text_us = measure_text(font_path);
+    measure_audio(bench.audio_us);
+    double total_ms = ticks_to_us(SDL_GetPerformanceCounter() - start) / 1000.0;
+
+    Settings tuned = *get_settings();
+    pick_settings(&bench, &tuned);
+    tuned.tuned = 1;
+    set_settings(&tuned);
+
+    printf("\n=== SETTINGS AUTO-TUNE (%.1f ms) ===\n", total_ms);
+    printf("Display: %d Hz | fill rate: %.0f Mpix/s | text: %.1f us/label\n",
+           bench.refresh_rate, bench.fill_mpixels, bench.text_us);
+    printf("Audio processing:");
+    for (int k = 0; k < 5; k++) printf(" %d=%.1fus", 256 << k, bench.audio_us[k]);
+    printf("\n====================================\n");
+    return 0;
+}
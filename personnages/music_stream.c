@@ -0,0 +1,661 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+#ifdef USE_VORBISFILE
+#include <vorbis/vorbisfile.h>
+#endif
+
+// =============================================================================
+// MUSIC STREAMING - incremental decode on a background thread
+// =============================================================================
+//
+// Instead of keeping a whole track resident, a streaming thread decodes a
+// few thousand frames at a time, converts them to the mixer format with an
+// SDL_AudioStream and writes them into a fixed ring buffer. The mixer pulls
+// from the ring through Mix_HookMusic. Memory use is the ring plus one
+// decode block, whatever the length of the track.
+//
+// Looping is gapless (the decoder rewinds inside the same fill loop) and
+// switching tracks can crossfade: both tracks are decoded and mixed with
+// complementary gains for the duration of the fade.
+//
+// The mixer side owns the music bus gain: volume changes, pause / resume
+// and ducking under sound effects are all per-sample ramps (gain.c), so
+// nothing ever jumps between two buffers.
+//
+// Supported formats: PCM WAV (built in), OGG Vorbis when built with
+// USE_VORBISFILE (make VORBIS=1).
+
+#define MUSIC_RING_BYTES (128 * 1024)     // ~0.74s of 44.1kHz stereo S16 (power of
+                                          // two: offsets stay right when the counters wrap)
+#define MUSIC_DECODE_FRAMES 4096          // Frames decoded per step
+#define MUSIC_CHUNK_BYTES 8192            // Bytes moved into the ring per step
+
+// Default music bus ramps
+#define MUSIC_VOLUME_RAMP_MS 50           // Volume changes
+#define MUSIC_PAUSE_FADE_MS 150           // Pause / resume
+#define MUSIC_DUCK_LEVEL 64               // Gain while effects play (0-128, 64 = -6 dB)
+#define MUSIC_DUCK_ATTACK_MS 30
+#define MUSIC_DUCK_RELEASE_MS 250
+
+// -----------------------------------------------------------------------------
+// Decoders
+// -----------------------------------------------------------------------------
+
+typedef struct MusicDecoder MusicDecoder;
+struct MusicDecoder {
+    int frequency;
+    int channels;
+    // Decode up to 'frames' interleaved S16 frames; returns frames read (0 = end)
+    int (*read)(MusicDecoder* dec, Sint16* out, int frames);
+    int (*rewind)(MusicDecoder* dec);
+    void (*close)(MusicDecoder* dec);
+    SDL_RWops* rw;
+    Sint64 data_start;        // WAV: offset of the sample data
+    Uint32 data_bytes;        // WAV: size of the sample data
+    Uint32 data_read;         // WAV: bytes consumed so far
+    int bytes_per_sample;     // WAV: 1 or 2
+#ifdef USE_VORBISFILE
+    OggVorbis_File vorbis;
+#endif
+};
+
+static int wav_read(MusicDecoder* dec, Sint16* out, int frames) {
+    int frame_bytes = dec->channels * dec->bytes_per_sample;
+    Uint32 remaining = dec->data_bytes - dec->data_read;
+    Uint32 want = (Uint32)frames * frame_bytes;
+    if (want > remaining) want = remaining - remaining % frame_bytes;
+    if (want == 0) return 0;
+
+    size_t got;
+    if (dec->bytes_per_sample == 2) {
+        got = SDL_RWread(dec->rw, out, 1, want);
+        for (size_t i = 0; i < got / 2; i++) {
+            out[i] = (Sint16)SDL_SwapLE16((Uint16)out[i]);
+        }
+    } else {
+        // 8-bit unsigned PCM: expand in place from the back
+        Uint8* bytes = (Uint8*)out;
+        got = SDL_RWread(dec->rw, bytes, 1, want);
+        for (size_t i = got; i > 0; i--) {
+            out[i - 1] = (Sint16)((bytes[i - 1] - 128) << 8);
+        }
+    }
+    dec->data_read += (Uint32)got;
+    return (int)(got / frame_bytes);
+}
+
+static int wav_rewind(MusicDecoder* dec) {
+    dec->data_read = 0;
+    return SDL_RWseek(dec->rw, dec->data_start, RW_SEEK_SET) < 0 ? -1 : 0;
+}
+
+static void wav_close(MusicDecoder* dec) {
+    SDL_RWclose(dec->rw);
+    SDL_free(dec);
+}
+
+// Parse a RIFF/WAVE header and position the stream at the sample data
+static MusicDecoder* open_wav_decoder(const char* path) {
+    SDL_RWops* rw = SDL_RWFromFile(path, "rb");
+    if (!rw) return NULL;
+
+    char tag[4];
+    if (SDL_RWread(rw, tag, 1, 4) != 4 || memcmp(tag, "RIFF", 4) != 0) goto fail;
+    SDL_ReadLE32(rw);
+    if (SDL_RWread(rw, tag, 1, 4) != 4 || memcmp(tag, "WAVE", 4) != 0) goto fail;
+
+    int format = 0, channels = 0, frequency = 0, bits = 0;
+    for (;;) {
+        if (SDL_RWread(rw, tag, 1, 4) != 4) goto fail;
+        Uint32 size = SDL_ReadLE32(rw);
+
+        if (memcmp(tag, "fmt ", 4) == 0) {
+            format = SDL_ReadLE16(rw);
+            channels = SDL_ReadLE16(rw);
+            frequency = (int)SDL_ReadLE32(rw);
+            SDL_ReadLE32(rw);               // byte rate
+            SDL_ReadLE16(rw);               // block align
+            bits = SDL_ReadLE16(rw);
+            SDL_RWseek(rw, (Sint64)(size - 16 + (size & 1)), RW_SEEK_CUR);
+        } else if (memcmp(tag, "data", 4) == 0) {
+            // 1 = PCM, 0xFFFE = WAVE_FORMAT_EXTENSIBLE (assumed PCM)
+            if ((format != 1 && format != 0xFFFE) || (bits != 8 && bits != 16) ||
+                channels < 1 || channels > 2) {
+                printf("Streaming: unsupported WAV format in '%s' (format %d, %d bits)\n",
+                       path, format, bits);
+                goto fail;
+            }
+            MusicDecoder* dec = SDL_calloc(1, sizeof(MusicDecoder));
+            if (!dec) goto fail;
+            dec->frequency = frequency;
+            dec->channels = channels;
+            dec->bytes_per_sample = bits / 8;
+            dec->rw = rw;
+            dec->data_start = SDL_RWtell(rw);
+            dec->data_bytes = size;
+            dec->read = wav_read;
+            dec->rewind = wav_rewind;
+            dec->close = wav_close;
+            return dec;
+        } else {
+            SDL_RWseek(rw, (Sint64)(size + (size & 1)), RW_SEEK_CUR);
+        }
+    }
+
+fail:
+    SDL_RWclose(rw);
+    return NULL;
+}
+
+#ifdef USE_VORBISFILE
+static int vorbis_read(MusicDecoder* dec, Sint16* out, int frames) {
+    int want = frames * dec->channels * 2;
+    int total = 0;
+    int section;
+    while (total < want) {
+        long got = ov_read(&dec->vorbis, (char*)out + total, want - total, 0, 2, 1, &section);
+        if (got <= 0) break;
+        total += (int)got;
+    }
+    return total / (dec->channels * 2);
+}
+
+static int vorbis_rewind(MusicDecoder* dec) {
+    return ov_pcm_seek(&dec->vorbis, 0) == 0 ? 0 : -1;
+}
+
+static void vorbis_close(MusicDecoder* dec) {
+    ov_clear(&dec->vorbis);
+    SDL_free(dec);
+}
+
+static MusicDecoder* open_vorbis_decoder(const char* path) {
+    MusicDecoder* dec = SDL_calloc(1, sizeof(MusicDecoder));
+    if (!dec) return NULL;
+    if (ov_fopen(path, &dec->vorbis) != 0) {
+        SDL_free(dec);
+        return NULL;
+    }
+    vorbis_info* info = ov_info(&dec->vorbis, -1);
+    dec->frequency = (int)info->rate;
+    dec->channels = info->channels;
+    if (dec->channels < 1 || dec->channels > 2) {
+        vorbis_close(dec);
+        return NULL;
+    }
+    dec->read = vorbis_read;
+    dec->rewind = vorbis_rewind;
+    dec->close = vorbis_close;
+    return dec;
+}
+#endif
+
+// Case-insensitive check of a file extension
+static int has_extension(const char* path, const char* ext) {
+    size_t len = strlen(path);
+    size_t ext_len = strlen(ext);
+    if (len < ext_len) return 0;
+    for (size_t i = 0; i < ext_len; i++) {
+        char c = path[len - ext_len + i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != ext[i]) return 0;
+    }
+    return 1;
+}
+
+static MusicDecoder* open_decoder(const char* path) {
+    if (has_extension(path, ".wav")) return open_wav_decoder(path);
+#ifdef USE_VORBISFILE
+    if (has_extension(path, ".ogg")) return open_vorbis_decoder(path);
+#endif
+    return NULL;
+}
+
+// Can this file be streamed (as opposed to loaded with Mix_LoadMUS)?
+// Only the header is parsed, so this is cheap enough to call at startup.
+int can_stream_music(const char* path) {
+    MusicDecoder* dec = open_decoder(path);
+    if (!dec) return 0;
+    dec->close(dec);
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// Tracks: a decoder plus conversion to the mixer format
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    MusicDecoder* decoder;
+    SDL_AudioStream* converter;
+    int loop;
+    int finished;
+} MusicTrack;
+
+// Streaming state shared between the render, streaming and audio threads
+static struct {
+    int started;
+    SDL_Thread* thread;
+    SDL_sem* wake;                  // Posted when ring space frees up or a request arrives
+    SDL_atomic_t quit;
+    SDL_atomic_t paused;
+    SDL_atomic_t volume;            // 0-128
+    SDL_atomic_t playing;           // A track is being streamed
+    SDL_atomic_t underruns;
+
+    // Music bus settings (written by the render thread)
+    SDL_atomic_t ramp_ms;
+    SDL_atomic_t pause_fade_ms;
+    SDL_atomic_t duck_level;        // 0-128 (128 = no ducking)
+    SDL_atomic_t duck_attack_ms;
+    SDL_atomic_t duck_release_ms;
+
+    // Music bus state (audio thread only)
+    GainRamp gain;
+    int applied_volume;
+    int applied_paused;
+    int applied_ducked;
+    int applied_duck_level;
+
+    // Ring buffer (single producer: streaming thread, single consumer: mixer)
+    Uint8 ring[MUSIC_RING_BYTES];
+    SDL_atomic_t read_pos;          // Total bytes consumed (wraps)
+    SDL_atomic_t write_pos;         // Total bytes produced (wraps)
+    SDL_atomic_t flush_pos;         // Write position the mixer should skip to
+    SDL_atomic_t flush_pending;     // Set by the streaming thread on stop / switch
+
+    // Pending request from the render thread
+    SDL_mutex* request_lock;
+    int request_pending;
+    char request_path[256];
+    int request_loop;
+    int request_fade_ms;
+    int request_stop;
+
+    // Streaming thread only
+    MusicTrack current;
+    MusicTrack next;
+    int fade_total;                 // Crossfade length in frames (0 = none)
+    int fade_done;
+    Sint16 decode_buffer[MUSIC_DECODE_FRAMES * 2];
+    Uint8 chunk_a[MUSIC_CHUNK_BYTES];
+    Uint8 chunk_b[MUSIC_CHUNK_BYTES];
+} music;
+
+// Drop what is queued in the ring so a stop or a switch is heard right away.
+// Only the mixer moves the read position, so it applies the flush itself on
+// its next callback.
+static void flush_ring(void) {
+    SDL_AtomicSet(&music.flush_pos, SDL_AtomicGet(&music.write_pos));
+    SDL_AtomicSet(&music.flush_pending, 1);
+}
+
+static void close_track(MusicTrack* track) {
+    if (track->decoder) track->decoder->close(track->decoder);
+    if (track->converter) SDL_FreeAudioStream(track->converter);
+    memset(track, 0, sizeof(*track));
+}
+
+static int open_track(MusicTrack* track, const char* path, int loop) {
+    memset(track, 0, sizeof(*track));
+    track->decoder = open_decoder(path);
+    if (!track->decoder) {
+        printf("Streaming: cannot open '%s'\n", path);
+        return -1;
+    }
+    track->converter = SDL_NewAudioStream(AUDIO_S16SYS, (Uint8)track->decoder->channels,
+                                          track->decoder->frequency,
+                                          audio.format, (Uint8)audio.channels, audio.frequency);
+    if (!track->converter) {
+        printf("Streaming: cannot convert '%s': %s\n", path, SDL_GetError());
+        close_track(track);
+        return -1;
+    }
+    track->loop = loop;
+    return 0;
+}
+
+// Fill 'out' with up to 'bytes' of mixer-format audio; returns bytes written
+static int read_track(MusicTrack* track, Uint8* out, int bytes) {
+    if (!track->decoder) return 0;
+
+    int rewound = 0;
+    while (SDL_AudioStreamAvailable(track->converter) < bytes && !track->finished) {
+        int frames = track->decoder->read(track->decoder, music.decode_buffer, MUSIC_DECODE_FRAMES);
+        if (frames > 0) {
+            SDL_AudioStreamPut(track->converter, music.decode_buffer,
+                               frames * track->decoder->channels * (int)sizeof(Sint16));
+            rewound = 0;
+        } else if (track->loop && !rewound && track->decoder->rewind(track->decoder) == 0) {
+            // Gapless loop: keep filling from the start without flushing
+            rewound = 1;
+        } else {
+            SDL_AudioStreamFlush(track->converter);
+            track->finished = 1;
+        }
+    }
+
+    int got = SDL_AudioStreamGet(track->converter, out, bytes);
+    return got > 0 ? got : 0;
+}
+
+// Apply a pending play / stop request (streaming thread)
+static void handle_request(void) {
+    SDL_LockMutex(music.request_lock);
+    if (!music.request_pending) {
+        SDL_UnlockMutex(music.request_lock);
+        return;
+    }
+    char path[256];
+    strcpy(path, music.request_path);
+    int loop = music.request_loop;
+    int fade_ms = music.request_fade_ms;
+    int stop = music.request_stop;
+    music.request_pending = 0;
+    SDL_UnlockMutex(music.request_lock);
+
+    if (stop) {
+        close_track(&music.current);
+        close_track(&music.next);
+        music.fade_total = 0;
+        flush_ring();
+        SDL_AtomicSet(&music.playing, 0);
+        return;
+    }
+
+    // A crossfade interrupted by another request jumps to its target
+    if (music.next.decoder) {
+        close_track(&music.current);
+        music.current = music.next;
+        memset(&music.next, 0, sizeof(music.next));
+        music.fade_total = 0;
+    }
+
+    if (music.current.decoder && fade_ms > 0) {
+        if (open_track(&music.next, path, loop) == 0) {
+            music.fade_total = (int)((Sint64)fade_ms * audio.frequency / 1000);
+            music.fade_done = 0;
+        }
+    } else {
+        close_track(&music.current);
+        flush_ring();
+        open_track(&music.current, path, loop);
+    }
+    SDL_AtomicSet(&music.playing, music.current.decoder != NULL);
+}
+
+// Mix the incoming track over the outgoing one with a linear crossfade
+static int produce_crossfade(Uint8* out, int bytes) {
+    int frame_bytes = audio.channels * (int)sizeof(Sint16);
+    int got_a = read_track(&music.current, out, bytes);
+    int got_b = read_track(&music.next, music.chunk_b, bytes);
+    if (got_a < got_b) memset(out + got_a, 0, got_b - got_a);
+    if (got_b < got_a) memset(music.chunk_b + got_b, 0, got_a - got_b);
+    int got = got_a > got_b ? got_a : got_b;
+
+    Sint16* a = (Sint16*)out;
+    const Sint16* b = (const Sint16*)music.chunk_b;
+    int frames = got / frame_bytes;
+    for (int f = 0; f < frames; f++) {
+        float t = (float)(music.fade_done + f) / (float)music.fade_total;
+        if (t > 1.0f) t = 1.0f;
+        for (int c = 0; c < audio.channels; c++) {
+            int i = f * audio.channels + c;
+            a[i] = (Sint16)(a[i] * (1.0f - t) + b[i] * t);
+        }
+    }
+    music.fade_done += frames;
+
+    if (music.fade_done >= music.fade_total || music.current.finished) {
+        close_track(&music.current);
+        music.current = music.next;
+        memset(&music.next, 0, sizeof(music.next));
+        music.fade_total = 0;
+    }
+    return got;
+}
+
+// Copy produced audio into the ring (caller checked there is room)
+static void write_ring(const Uint8* data, int bytes) {
+    Uint32 w = (Uint32)SDL_AtomicGet(&music.write_pos);
+    Uint32 offset = w % MUSIC_RING_BYTES;
+    Uint32 first = MUSIC_RING_BYTES - offset;
+    if (first > (Uint32)bytes) first = (Uint32)bytes;
+
+    memcpy(music.ring + offset, data, first);
+    memcpy(music.ring, data + first, bytes - first);
+    SDL_AtomicSet(&music.write_pos, (int)(w + (Uint32)bytes));  // Publish
+}
+
+static int music_stream_thread(void* data) {
+    (void)data;
+
+    while (!SDL_AtomicGet(&music.quit)) {
+        handle_request();
+
+        Uint32 used = (Uint32)SDL_AtomicGet(&music.write_pos) - (Uint32)SDL_AtomicGet(&music.read_pos);
+        if (!music.current.decoder || MUSIC_RING_BYTES - used < MUSIC_CHUNK_BYTES) {
+            // Nothing to do until the mixer consumes data or a request arrives
+            SDL_SemWaitTimeout(music.wake, 100);
+            continue;
+        }
+
+        int got = music.fade_total > 0
+                ? produce_crossfade(music.chunk_a, MUSIC_CHUNK_BYTES)
+                : read_track(&music.current, music.chunk_a, MUSIC_CHUNK_BYTES);
+        if (got > 0) {
+            write_ring(music.chunk_a, got);
+        } else if (music.current.finished) {
+            close_track(&music.current);
+            SDL_AtomicSet(&music.playing, 0);
+        }
+    }
+    return 0;
+}
+
+// Start a new gain ramp when volume, pause or ducking changed (audio thread)
+static void update_music_gain(void) {
+    int volume = SDL_AtomicGet(&music.volume);
+    int paused = SDL_AtomicGet(&music.paused);
+    int duck_level = SDL_AtomicGet(&music.duck_level);
+    int ducked = duck_level < MIX_MAX_VOLUME && SDL_AtomicGet(&audio.active_voices) > 0;
+
+    if (volume == music.applied_volume && paused == music.applied_paused &&
+        ducked == music.applied_ducked && duck_level == music.applied_duck_level) {
+        return;
+    }
+
+    // The ramp length depends on what changed
+    int ms;
+    if (paused != music.applied_paused) {
+        ms = SDL_AtomicGet(&music.pause_fade_ms);
+    } else if (ducked != music.applied_ducked) {
+        ms = SDL_AtomicGet(ducked ? &music.duck_attack_ms : &music.duck_release_ms);
+    } else {
+        ms = SDL_AtomicGet(&music.ramp_ms);
+    }
+
+    float target = paused ? 0.0f : (float)volume / MIX_MAX_VOLUME;
+    if (ducked) target *= (float)duck_level / MIX_MAX_VOLUME;
+    start_gain_ramp(&music.gain, target, (int)((Sint64)ms * audio.frequency / 1000));
+
+    music.applied_volume = volume;
+    music.applied_paused = paused;
+    music.applied_ducked = ducked;
+    music.applied_duck_level = duck_level;
+}
+
+// Mixer callback (audio thread): copy from the ring into the music stream
+static void music_stream_hook(void* udata, Uint8* stream, int len) {
+    (void)udata;
+    update_music_gain();
+
+    // Skip the audio queued before a stop or a switch (never backwards:
+    // a second flush may be seen after the mixer already passed its position)
+    if (SDL_AtomicCAS(&music.flush_pending, 1, 0)) {
+        Uint32 target = (Uint32)SDL_AtomicGet(&music.flush_pos);
+        if ((Sint32)(target - (Uint32)SDL_AtomicGet(&music.read_pos)) > 0) {
+            SDL_AtomicSet(&music.read_pos, (int)target);
+            SDL_SemPost(music.wake);
+        }
+    }
+
+    // Once a pause has faded out, stop consuming so resume continues from
+    // the exact sample where the fade ended (stream is pre-filled with silence)
+    if (music.applied_paused && music.gain.remaining == 0) return;
+
+    Uint32 r = (Uint32)SDL_AtomicGet(&music.read_pos);
+    Uint32 available = (Uint32)SDL_AtomicGet(&music.write_pos) - r;
+    Uint32 n = (Uint32)len < available ? (Uint32)len : available;
+    n -= n % 4;  // Whole stereo S16 frames
+
+    Uint32 offset = r % MUSIC_RING_BYTES;
+    Uint32 first = MUSIC_RING_BYTES - offset;
+    if (first > n) first = n;
+    memcpy(stream, music.ring + offset, first);
+    memcpy(stream + first, music.ring, n - first);
+    SDL_AtomicSet(&music.read_pos, (int)(r + n));
+    SDL_SemPost(music.wake);
+
+    apply_gain_ramp(&music.gain, (Sint16*)stream, (int)(n / 4));
+
+    if (n < (Uint32)len && SDL_AtomicGet(&music.playing)) {
+        SDL_AtomicAdd(&music.underruns, 1);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Public API (render thread)
+// -----------------------------------------------------------------------------
+
+// Start the streaming thread and hook it into the mixer
+int start_music_stream(void) {
+    if (music.started) return 0;
+    if (!audio.opened || audio.format != AUDIO_S16SYS || audio.channels != 2) {
+        printf("Streaming: mixer format not supported, using Mix_Music instead\n");
+        return -1;
+    }
+
+    SDL_AtomicSet(&music.quit, 0);
+    SDL_AtomicSet(&music.paused, 0);
+    SDL_AtomicSet(&music.volume, MIX_MAX_VOLUME);
+    SDL_AtomicSet(&music.ramp_ms, MUSIC_VOLUME_RAMP_MS);
+    SDL_AtomicSet(&music.pause_fade_ms, MUSIC_PAUSE_FADE_MS);
+    SDL_AtomicSet(&music.duck_level, MUSIC_DUCK_LEVEL);
+    SDL_AtomicSet(&music.duck_attack_ms, MUSIC_DUCK_ATTACK_MS);
+    SDL_AtomicSet(&music.duck_release_ms, MUSIC_DUCK_RELEASE_MS);
+
+    // Fade in from silence on the first callback
+    init_gain_ramp(&music.gain, 0.0f);
+    music.applied_volume = -1;
+    music.applied_paused = 0;
+    music.applied_ducked = 0;
+    music.applied_duck_level = MUSIC_DUCK_LEVEL;
+    SDL_AtomicSet(&music.read_pos, 0);
+    SDL_AtomicSet(&music.write_pos, 0);
+    SDL_AtomicSet(&music.flush_pending, 0);
+    music.wake = SDL_CreateSemaphore(0);
+    music.request_lock = SDL_CreateMutex();
+    music.thread = NULL;
+    if (music.wake && music.request_lock) {
+        music.thread = SDL_CreateThread(music_stream_thread, "music_stream", NULL);
+    }
+    if (!music.thread) {
+        printf("Streaming: failed to start thread: %s\n", SDL_GetError());
+        if (music.wake) SDL_DestroySemaphore(music.wake);
+        if (music.request_lock) SDL_DestroyMutex(music.request_lock);
+        music.wake = NULL;
+        music.request_lock = NULL;
+        return -1;
+    }
+
+    Mix_HookMusic(music_stream_hook, NULL);
+    music.started = 1;
+    printf("Music streaming started (%d KB ring buffer)\n", MUSIC_RING_BYTES / 1024);
+    return 0;
+}
+
+// Queue a track switch. The file is opened and decoded on the streaming
+// thread, so this never blocks on I/O. crossfade_ms = 0 switches instantly.
+int play_music_stream(const char* path, int loop, int crossfade_ms) {
+    if (!music.started) return -1;
+
+    SDL_LockMutex(music.request_lock);
+    strncpy(music.request_path, path, sizeof(music.request_path) - 1);
+    music.request_path[sizeof(music.request_path) - 1] = '\0';
+    music.request_loop = loop;
+    music.request_fade_ms = crossfade_ms;
+    music.request_stop = 0;
+    music.request_pending = 1;
+    SDL_UnlockMutex(music.request_lock);
+
+    SDL_SemPost(music.wake);
+    return 0;
+}
+
+// Queue a stop request
+void stop_music_stream(void) {
+    if (!music.started) return;
+
+    SDL_LockMutex(music.request_lock);
+    music.request_stop = 1;
+    music.request_pending = 1;
+    SDL_UnlockMutex(music.request_lock);
+    SDL_SemPost(music.wake);
+}
+
+// Pause / resume with a fade (the mixer applies it sample-accurately)
+void set_music_stream_paused(int paused) {
+    SDL_AtomicSet(&music.paused, paused != 0);
+}
+
+int is_music_stream_paused(void) {
+    return SDL_AtomicGet(&music.paused);
+}
+
+int is_music_stream_playing(void) {
+    return music.started && SDL_AtomicGet(&music.playing);
+}
+
+// Set the target volume (0-128); the mixer ramps towards it
+void set_music_stream_volume(int volume) {
+    SDL_AtomicSet(&music.volume, volume);
+}
+
+// Length of the ramp used for volume changes
+void set_music_ramp_time(int ms) {
+    SDL_AtomicSet(&music.ramp_ms, ms < 0 ? 0 : ms);
+}
+
+// Length of the pause / resume fades
+void set_music_pause_fade(int ms) {
+    SDL_AtomicSet(&music.pause_fade_ms, ms < 0 ? 0 : ms);
+}
+
+// Lower the music to 'level' (0-128, 128 disables ducking) while any sound
+// effect voice is playing
+void set_music_ducking(int level, int attack_ms, int release_ms) {
+    if (level < 0) level = 0;
+    if (level > MIX_MAX_VOLUME) level = MIX_MAX_VOLUME;
+    SDL_AtomicSet(&music.duck_attack_ms, attack_ms < 0 ? 0 : attack_ms);
+    SDL_AtomicSet(&music.duck_release_ms, release_ms < 0 ? 0 : release_ms);
+    SDL_AtomicSet(&music.duck_level, level);
+}
+
+// Stop the thread, unhook from the mixer and release everything
+void shutdown_music_stream(void) {
+    if (!music.started) return;
+
+    Mix_HookMusic(NULL, NULL);
+    SDL_AtomicSet(&music.quit, 1);
+    SDL_SemPost(music.wake);
+    SDL_WaitThread(music.thread, NULL);
+
+    close_track(&music.current);
+    close_track(&music.next);
+    SDL_DestroySemaphore(music.wake);
+    SDL_DestroyMutex(music.request_lock);
+    music.started = 0;
+    printf("Music streaming stopped (%d underruns)\n", SDL_AtomicGet(&music.underruns));
+}
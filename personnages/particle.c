@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "header.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PARTICLE_USE_AVX 1
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define PARTICLE_USE_SSE 1
+#endif
+
+// =============================================================================
+// PARTICLES - structure-of-arrays particle emitters
+// =============================================================================
+//
+// Each emitter keeps its live particles packed in separate float arrays
+// (position, velocity, age, lifetime, fade), so integration, aging and the
+// alpha fade run as one SIMD kernel over contiguous data: 8 particles per
+// step with AVX (make AVX=1), 4 with SSE, with a scalar loop for the rest.
+// Dead particles are swap-removed. Drawing builds one quad per particle into
+// the emitter's vertex buffer and queues the whole emitter as a single
+// SDL_RenderGeometry call.
+
+// Smallest slice of an emitter worth handing to another worker
+#define PARTICLE_PARALLEL_BATCH 8192
+
+static ParticleEmitter emitters[PARTICLE_MAX_EMITTERS];
+static int use_simd = 1;
+static Uint32 rng_state = 0x9E3779B9u;
+
+// xorshift32, uniform in [0, 1)
+static float random_unit(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state >> 8) * (1.0f / 16777216.0f);
+}
+
+static float random_range(float lo, float hi) {
+    return lo + (hi - lo) * random_unit();
+}
+
+// Create a named emitter able to hold 'capacity' live particles.
+// Returns the emitter id, or -1 on failure.
+int create_particle_emitter(const char* name, int capacity, const ParticleEmitterConfig* config) {
+    int id = -1;
+    for (int i = 0; i < PARTICLE_MAX_EMITTERS; i++) {
+        if (!emitters[i].active) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0) {
+        printf("Error: Maximum particle emitters limit reached (%d)\n", PARTICLE_MAX_EMITTERS);
+        return -1;
+    }
+    if (capacity <= 0 || config->palette_size <= 0 || config->palette_size > PARTICLE_PALETTE_SIZE) {
+        printf("Error: Invalid particle emitter '%s'\n", name);
+        return -1;
+    }
+
+    ParticleEmitter* e = &emitters[id];
+    memset(e, 0, sizeof(*e));
+
+    // One block for the float arrays, padded so kernels can run a full
+    // vector past the last particle
+    int stride = (capacity + 7) & ~7;
+    e->storage = SDL_malloc(sizeof(float) * stride * PARTICLE_FLOAT_ARRAYS);
+    e->colors = SDL_malloc(sizeof(SDL_Color) * capacity);
+    e->indices = SDL_malloc(sizeof(int) * capacity * 6);
+    if (!e->storage || !e->colors || !e->indices) {
+        printf("Error: Failed to allocate particle emitter '%s'\n", name);
+        SDL_free(e->storage);
+        SDL_free(e->colors);
+        SDL_free(e->indices);
+        memset(e, 0, sizeof(*e));
+        return -1;
+    }
+    memset(e->storage, 0, sizeof(float) * stride * PARTICLE_FLOAT_ARRAYS);
+
+    e->x = e->storage;
+    e->y = e->x + stride;
+    e->vx = e->y + stride;
+    e->vy = e->vx + stride;
+    e->age = e->vy + stride;
+    e->inv_life = e->age + stride;
+    e->fade = e->inv_life + stride;
+
+    // Two triangles per quad; the pattern never changes
+    for (int i = 0; i < capacity; i++) {
+        int v = i * 4;
+        int* idx = &e->indices[i * 6];
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 3; idx[5] = v;
+    }
+
+    strncpy(e->name, name, sizeof(e->name) - 1);
+    e->config = *config;
+    e->capacity = capacity;
+    e->active = 1;
+    return id;
+}
+
+// Look up an emitter by name (-1 if missing)
+int find_particle_emitter(const char* name) {
+    for (int i = 0; i < PARTICLE_MAX_EMITTERS; i++) {
+        if (emitters[i].active && strcmp(emitters[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// Spawn up to 'count' particles at (x, y). Returns the number spawned.
+int emit_particles(int emitter, float x, float y, int count) {
+    if (emitter < 0 || emitter >= PARTICLE_MAX_EMITTERS || !emitters[emitter].active) return 0;
+
+    ParticleEmitter* e = &emitters[emitter];
+    const ParticleEmitterConfig* c = &e->config;
+    if (count > e->capacity - e->count) count = e->capacity - e->count;
+
+    for (int n = 0; n < count; n++) {
+        int i = e->count++;
+        float angle = c->direction + random_range(-0.5f, 0.5f) * c->spread;
+        float speed = random_range(c->speed_min, c->speed_max);
+        e->x[i] = x;
+        e->y[i] = y;
+        e->vx[i] = cosf(angle) * speed;
+        e->vy[i] = sinf(angle) * speed;
+        e->age[i] = 0.0f;
+        e->inv_life[i] = 1.0f / random_range(c->life_min, c->life_max);
+        e->fade[i] = 1.0f;
+
+        Color color = c->palette[(int)(random_unit() * c->palette_size)];
+        e->colors[i] = (SDL_Color){color.r, color.g, color.b, color.a};
+    }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+// Update kernels: v = v * damping + g * dt; p += v * dt; age += dt;
+// fade = max(0, 1 - age / lifetime)
+// -----------------------------------------------------------------------------
+
+static void integrate_scalar(ParticleEmitter* e, int begin, int end,
+                             float dt, float damping, float gravity_dt) {
+    for (int i = begin; i < end; i++) {
+        e->vx[i] = e->vx[i] * damping;
+        e->vy[i] = e->vy[i] * damping + gravity_dt;
+        e->x[i] += e->vx[i] * dt;
+        e->y[i] += e->vy[i] * dt;
+        e->age[i] += dt;
+        float fade = 1.0f - e->age[i] * e->inv_life[i];
+        e->fade[i] = fade > 0.0f ? fade : 0.0f;
+    }
+}
+
+// Returns the index reached; the caller finishes the tail
+static int integrate_simd(ParticleEmitter* e, int begin, int end,
+                          float dt, float damping, float gravity_dt) {
+    int i = begin;
+
+#if defined(PARTICLE_USE_AVX)
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vdamp = _mm256_set1_ps(damping);
+    const __m256 vgdt = _mm256_set1_ps(gravity_dt);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= end; i += 8) {
+        __m256 vx = _mm256_mul_ps(_mm256_loadu_ps(e->vx + i), vdamp);
+        __m256 vy = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(e->vy + i), vdamp), vgdt);
+        _mm256_storeu_ps(e->vx + i, vx);
+        _mm256_storeu_ps(e->vy + i, vy);
+        _mm256_storeu_ps(e->x + i, _mm256_add_ps(_mm256_loadu_ps(e->x + i), _mm256_mul_ps(vx, vdt)));
+        _mm256_storeu_ps(e->y + i, _mm256_add_ps(_mm256_loadu_ps(e->y + i), _mm256_mul_ps(vy, vdt)));
+        __m256 age = _mm256_add_ps(_mm256_loadu_ps(e->age + i), vdt);
+        _mm256_storeu_ps(e->age + i, age);
+        __m256 fade = _mm256_sub_ps(one, _mm256_mul_ps(age, _mm256_loadu_ps(e->inv_life + i)));
+        _mm256_storeu_ps(e->fade + i, _mm256_max_ps(fade, zero));
+    }
+#elif defined(PARTICLE_USE_SSE)
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdamp = _mm_set1_ps(damping);
+    const __m128 vgdt = _mm_set1_ps(gravity_dt);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 vx = _mm_mul_ps(_mm_loadu_ps(e->vx + i), vdamp);
+        __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(e->vy + i), vdamp), vgdt);
+        _mm_storeu_ps(e->vx + i, vx);
+        _mm_storeu_ps(e->vy + i, vy);
+        _mm_storeu_ps(e->x + i, _mm_add_ps(_mm_loadu_ps(e->x + i), _mm_mul_ps(vx, vdt)));
+        _mm_storeu_ps(e->y + i, _mm_add_ps(_mm_loadu_ps(e->y + i), _mm_mul_ps(vy, vdt)));
+        __m128 age = _mm_add_ps(_mm_loadu_ps(e->age + i), vdt);
+        _mm_storeu_ps(e->age + i, age);
+        __m128 fade = _mm_sub_ps(one, _mm_mul_ps(age, _mm_loadu_ps(e->inv_life + i)));
+        _mm_storeu_ps(e->fade + i, _mm_max_ps(fade, zero));
+    }
+#else
+    (void)e; (void)end; (void)dt; (void)damping; (void)gravity_dt;
+#endif
+
+    return i;
+}
+
+// Swap-remove every particle whose fade reached zero
+static void remove_dead(ParticleEmitter* e) {
+    int i = 0;
+    while (i < e->count) {
+        if (e->fade[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --e->count;
+        e->x[i] = e->x[last];
+        e->y[i] = e->y[last];
+        e->vx[i] = e->vx[last];
+        e->vy[i] = e->vy[last];
+        e->age[i] = e->age[last];
+        e->inv_life[i] = e->inv_life[last];
+        e->fade[i] = e->fade[last];
+        e->colors[i] = e->colors[last];
+    }
+}
+
+typedef struct {
+    ParticleEmitter* emitter;
+    float dt, damping, gravity_dt;
+} IntegrateParams;
+
+// Integrate particles [begin, end) of an emitter (parallel_for body)
+static void integrate_range(int begin, int end, void* data) {
+    const IntegrateParams* p = (const IntegrateParams*)data;
+    int done = use_simd ? integrate_simd(p->emitter, begin, end, p->dt, p->damping, p->gravity_dt)
+                        : begin;
+    integrate_scalar(p->emitter, done, end, p->dt, p->damping, p->gravity_dt);
+}
+
+// Advance every emitter by the frame time. Large emitters are split across
+// the job workers; the ranges are independent, removal runs afterwards.
+void update_particles(double frame_seconds) {
+    float dt = (float)frame_seconds;
+    if (dt <= 0.0f) return;
+
+    for (int n = 0; n < PARTICLE_MAX_EMITTERS; n++) {
+        ParticleEmitter* e = &emitters[n];
+        if (!e->active || e->count == 0) continue;
+
+        // Drag is a per-second factor, so scale it to this frame
+        IntegrateParams params = {e, dt, powf(e->config.drag, dt), e->config.gravity * dt};
+        parallel_for(e->count, PARTICLE_PARALLEL_BATCH, integrate_range, &params);
+        remove_dead(e);
+    }
+}
+
+// Queue each emitter as one triangle mesh (one quad per particle)
+void draw_particles(void) {
+    render_queue_set_layer(RENDER_LAYER_OVERLAY);
+
+    for (int n = 0; n < PARTICLE_MAX_EMITTERS; n++) {
+        ParticleEmitter* e = &emitters[n];
+        if (!e->active || e->count == 0) continue;
+
+        // The mesh only lives until the frame is presented
+        SDL_Vertex* vertices = frame_alloc(sizeof(SDL_Vertex) * e->count * 4);
+        if (!vertices) continue;
+
+        float min_x = e->x[0], max_x = e->x[0];
+        float min_y = e->y[0], max_y = e->y[0];
+        float size = e->config.size;
+
+        for (int i = 0; i < e->count; i++) {
+            // Particles shrink to half size as they fade out
+            float h = size * (0.25f + 0.25f * e->fade[i]);
+            float x = e->x[i], y = e->y[i];
+            SDL_Color color = e->colors[i];
+            color.a = (Uint8)(color.a * e->fade[i]);
+
+            SDL_Vertex* v = &vertices[i * 4];
+            v[0] = (SDL_Vertex){{x - h, y - h}, color, {0.0f, 0.0f}};
+            v[1] = (SDL_Vertex){{x + h, y - h}, color, {1.0f, 0.0f}};
+            v[2] = (SDL_Vertex){{x + h, y + h}, color, {1.0f, 1.0f}};
+            v[3] = (SDL_Vertex){{x - h, y + h}, color, {0.0f, 1.0f}};
+
+            if (x < min_x) min_x = x;
+            if (x > max_x) max_x = x;
+            if (y < min_y) min_y = y;
+            if (y > max_y) max_y = y;
+        }
+
+        SDL_Rect bounds = {(int)floorf(min_x - size), (int)floorf(min_y - size),
+                           (int)ceilf(max_x - min_x + 2.0f * size) + 1,
+                           (int)ceilf(max_y - min_y + 2.0f * size) + 1};
+        queue_geometry(NULL, vertices, e->count * 4, e->indices, e->count * 6,
+                       &bounds, e->config.blend);
+    }
+}
+
+// Live particles over all emitters
+int get_live_particle_count(void) {
+    int total = 0;
+    for (int n = 0; n < PARTICLE_MAX_EMITTERS; n++) {
+        if (emitters[n].active) total += emitters[n].count;
+    }
+    return total;
+}
+
+// Use the SIMD kernels (default) or the scalar loop only (for comparison)
+void set_particle_simd(int enabled) {
+    use_simd = enabled;
+}
+
+// Remove every live particle of an emitter
+void clear_particles(int emitter) {
+    if (emitter < 0 || emitter >= PARTICLE_MAX_EMITTERS) return;
+    emitters[emitter].count = 0;
+}
+
+void destroy_particle_emitter(int emitter) {
+    if (emitter < 0 || emitter >= PARTICLE_MAX_EMITTERS || !emitters[emitter].active) return;
+
+    ParticleEmitter* e = &emitters[emitter];
+    SDL_free(e->storage);
+    SDL_free(e->colors);
+    SDL_free(e->indices);
+    memset(e, 0, sizeof(*e));
+}
+
+void cleanup_particles(void) {
+    for (int n = 0; n < PARTICLE_MAX_EMITTERS; n++) {
+        destroy_particle_emitter(n);
+    }
+}
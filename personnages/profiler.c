@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// PROFILER - per-frame timing and counters
+// =============================================================================
+//
+// The main loop marks the start of the frame and the end of each phase
+// (update, render, present). Frames are kept in a fixed ring so a long
+// session never allocates; the report covers the most recent frames.
+
+#define PROFILER_MAX_FRAMES 65536
+
+static FrameProfile frames[PROFILER_MAX_FRAMES];
+static int frame_count = 0;         // Frames stored (<= PROFILER_MAX_FRAMES)
+static int frame_head = 0;          // Next slot to write
+static int total_frame_count = 0;   // Frames profiled since start
+
+static FrameProfile current;
+static Uint64 frame_start = 0;
+static Uint64 phase_start = 0;
+
+static double counter_to_ms(Uint64 ticks) {
+    return (double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+// Mark the beginning of a frame
+void profiler_begin_frame(void) {
+    memset(&current, 0, sizeof(current));
+    frame_start = SDL_GetPerformanceCounter();
+    phase_start = frame_start;
+}
+
+// Mark the end of a phase; its duration is added to the phase's total
+void profiler_end_phase(ProfilePhase phase) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double ms = counter_to_ms(now - phase_start);
+    phase_start = now;
+
+    switch (phase) {
+        case PROFILE_EVENTS:  current.events_ms += ms;  break;
+        case PROFILE_UPDATE:  current.update_ms += ms;  break;
+        case PROFILE_RENDER:  current.render_ms += ms;  break;
+        case PROFILE_PRESENT: current.present_ms += ms; break;
+    }
+}
+
+// Mark the end of a frame and store its profile
+void profiler_end_frame(void) {
+    current.total_ms = counter_to_ms(SDL_GetPerformanceCounter() - frame_start);
+
+    RenderQueueStats rq = render_queue_get_stats();
+    CullStats cull = get_cull_stats();
+    current.draw_commands = rq.commands;
+    current.state_changes = rq.state_changes;
+    current.submissions = rq.submissions;
+    current.sequences_drawn = cull.drawn;
+
+    // Job worker activity since the previous frame
+    static double last_busy_ms = 0.0;
+    static int last_jobs = 0;
+    double busy_ms = 0.0;
+    int jobs = 0;
+    int workers = get_job_worker_count();
+    for (int i = 0; i < workers; i++) {
+        double worker_busy;
+        int worker_jobs;
+        get_job_worker_stats(i, &worker_busy, &worker_jobs);
+        busy_ms += worker_busy;
+        jobs += worker_jobs;
+    }
+    if (current.total_ms > 0.0) {
+        current.worker_utilization = (float)((busy_ms - last_busy_ms) / (current.total_ms * workers));
+    }
+    current.jobs_run = jobs - last_jobs;
+    last_busy_ms = busy_ms;
+    last_jobs = jobs;
+
+    // Heap traffic since the previous frame
+    static int last_allocations = 0;
+    MemoryStats memory = get_memory_stats();
+    current.allocations = memory.allocations - last_allocations;
+    last_allocations = memory.allocations;
+
+    frames[frame_head] = current;
+    frame_head = (frame_head + 1) % PROFILER_MAX_FRAMES;
+    if (frame_count < PROFILER_MAX_FRAMES) frame_count++;
+    total_frame_count++;
+}
+
+// Stored frames in chronological order
+static const FrameProfile* frame_at(int i) {
+    int oldest = (frame_head - frame_count + PROFILER_MAX_FRAMES) % PROFILER_MAX_FRAMES;
+    return &frames[(oldest + i) % PROFILER_MAX_FRAMES];
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Print min / average / percentiles of the frame times
+void profiler_print_report(void) {
+    if (frame_count == 0) return;
+
+    double* totals = malloc(sizeof(double) * frame_count);
+    if (!totals) return;
+
+    double sum = 0.0, update = 0.0, render = 0.0, present = 0.0, utilization = 0.0;
+    long jobs = 0, allocations = 0;
+    for (int i = 0; i < frame_count; i++) {
+        const FrameProfile* f = frame_at(i);
+        totals[i] = f->total_ms;
+        sum += f->total_ms;
+        update += f->update_ms;
+        render += f->render_ms;
+        present += f->present_ms;
+        utilization += f->worker_utilization;
+        jobs += f->jobs_run;
+        allocations += f->allocations;
+    }
+    qsort(totals, frame_count, sizeof(double), compare_doubles);
+
+    printf("\n=== FRAME TIMING REPORT (%d frames) ===\n", frame_count);
+    printf("Frame time  min %.3f ms | avg %.3f ms | p50 %.3f ms | p95 %.3f ms | p99 %.3f ms | max %.3f ms\n",
+           totals[0], sum / frame_count,
+           totals[frame_count / 2],
+           totals[(int)(frame_count * 0.95)],
+           totals[(int)(frame_count * 0.99)],
+           totals[frame_count - 1]);
+    printf("Avg phases  update %.3f ms | render %.3f ms | present %.3f ms\n",
+           update / frame_count, render / frame_count, present / frame_count);
+    printf("Jobs        %.1f per frame | worker utilization %.1f%%\n",
+           (double)jobs / frame_count, 100.0 * utilization / frame_count);
+    printf("Memory      %.2f SDL heap allocations per frame | frame arena peak %.1f KB\n",
+           (double)allocations / frame_count, get_memory_stats().arena_peak / 1024.0);
+    printf("=======================================\n");
+    print_job_stats();
+
+    free(totals);
+}
+
+// Write one CSV line per frame
+int profiler_write_csv(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Failed to open report file '%s'\n", path);
+        return -1;
+    }
+
+    fprintf(file, "frame,total_ms,events_ms,update_ms,render_ms,present_ms,"
+                  "draw_commands,state_changes,submissions,sequences_drawn,"
+                  "worker_utilization,jobs_run,allocations\n");
+    int first = total_frame_count - frame_count;
+    for (int i = 0; i < frame_count; i++) {
+        const FrameProfile* f = frame_at(i);
+        fprintf(file, "%d,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d,%.4f,%d,%d\n",
+                first + i, f->total_ms, f->events_ms, f->update_ms, f->render_ms,
+                f->present_ms, f->draw_commands, f->state_changes, f->submissions,
+                f->sequences_drawn, f->worker_utilization, f->jobs_run, f->allocations);
+    }
+    fclose(file);
+    printf("Per-frame timing written to '%s'\n", path);
+    return 0;
+}
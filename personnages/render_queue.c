@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "header.h"
+
+// =============================================================================
+// RENDER QUEUE - sorted, state-elided draw submission
+// =============================================================================
+//
+// Widgets no longer talk to the renderer directly. They push commands into
+// this queue, which is sorted at flush time by layer, then by render state
+// (texture, blend mode, color) so that consecutive commands share state and
+// can be batched. Two commands are only reordered if their bounds do not
+// overlap, so the final image is identical to drawing in submission order.
+
+#define RENDER_QUEUE_CAPACITY 2048
+#define MAX_BATCH_RECTS 1024
+
+static RenderCommand commands[RENDER_QUEUE_CAPACITY];
+static int command_count = 0;
+static int current_layer = RENDER_LAYER_SEQUENCES;
+static SDL_Renderer* queue_renderer = NULL;
+
+static RenderQueueStats frame_stats;
+static RenderQueueStats total_stats;
+static int total_frames = 0;
+
+// Scratch buffers used to batch rects / points into a single SDL call
+static SDL_Rect batch_rects[MAX_BATCH_RECTS];
+static SDL_Point batch_points[MAX_BATCH_RECTS];
+
+// Reset the queue for a new frame
+void render_queue_begin(SDL_Renderer* renderer) {
+    queue_renderer = renderer;
+    command_count = 0;
+    current_layer = RENDER_LAYER_SEQUENCES;
+    memset(&frame_stats, 0, sizeof(frame_stats));
+}
+
+// Select the layer used by the next commands
+void render_queue_set_layer(int layer) {
+    current_layer = layer;
+}
+
+// Reserve a command slot (flushes early if the queue is full)
+static RenderCommand* push_command(RenderCommandType type, const SDL_Rect* bounds) {
+    if (command_count >= RENDER_QUEUE_CAPACITY) {
+        // Everything already queued was submitted earlier, so drawing it now
+        // keeps the correct order
+        render_queue_flush(queue_renderer);
+    }
+
+    RenderCommand* cmd = &commands[command_count];
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->type = type;
+    cmd->layer = current_layer;
+    cmd->order = command_count;
+    cmd->blend = SDL_BLENDMODE_BLEND;
+    cmd->bounds = *bounds;
+    command_count++;
+    return cmd;
+}
+
+// Queue a filled rectangle
+void queue_fill_rect(const SDL_Rect* rect, Color color) {
+    RenderCommand* cmd = push_command(RQ_FILL_RECT, rect);
+    cmd->color = color;
+}
+
+// Queue a one pixel rectangle outline
+void queue_outline_rect(const SDL_Rect* rect, Color color) {
+    RenderCommand* cmd = push_command(RQ_OUTLINE_RECT, rect);
+    cmd->color = color;
+}
+
+// Queue a textured quad (src may be NULL for the whole texture)
+void queue_texture(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest, Uint8 alpha) {
+    if (!texture) return;
+    RenderCommand* cmd = push_command(RQ_TEXTURE, dest);
+    cmd->texture = texture;
+    cmd->color = create_color(255, 255, 255, alpha);
+    if (src) {
+        cmd->src = *src;
+        cmd->has_src = 1;
+    }
+}
+
+// Queue a textured quad at a sub-pixel position (drawn with SDL_RenderCopyF)
+void queue_texture_f(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect* dest, Uint8 alpha) {
+    if (!texture) return;
+
+    // Integer bounds enclosing the quad, for overlap tests
+    int x0 = (int)floorf(dest->x);
+    int y0 = (int)floorf(dest->y);
+    SDL_Rect bounds = {x0, y0,
+                       (int)ceilf(dest->x + dest->w) - x0,
+                       (int)ceilf(dest->y + dest->h) - y0};
+    RenderCommand* cmd = push_command(RQ_TEXTURE_F, &bounds);
+    cmd->texture = texture;
+    cmd->dest_f = *dest;
+    cmd->color = create_color(255, 255, 255, alpha);
+    if (src) {
+        cmd->src = *src;
+        cmd->has_src = 1;
+    }
+}
+
+// Queue a rendered text texture. If owns_texture is set, the queue destroys
+// the texture once it has been drawn.
+void queue_glyph_run(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest, int owns_texture) {
+    if (!texture) return;
+    RenderCommand* cmd = push_command(RQ_GLYPH_RUN, dest);
+    cmd->texture = texture;
+    cmd->color = create_color(255, 255, 255, 255);
+    cmd->owns_texture = owns_texture;
+    if (src) {
+        cmd->src = *src;
+        cmd->has_src = 1;
+    }
+}
+
+// Queue a text texture owned by the caller, tinted by 'tint' (color and alpha
+// modulation), so one white rasterization can be drawn in any color
+void queue_text(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest, Color tint) {
+    if (!texture) return;
+    RenderCommand* cmd = push_command(RQ_GLYPH_RUN, dest);
+    cmd->texture = texture;
+    cmd->color = tint;
+    if (src) {
+        cmd->src = *src;
+        cmd->has_src = 1;
+    }
+}
+
+// Queue a circle (filled, or an outline of the given thickness)
+void queue_circle(int center_x, int center_y, int radius, Color color, int filled, int thickness) {
+    if (radius <= 0) return;
+    SDL_Rect bounds = {center_x - radius, center_y - radius, radius * 2 + 1, radius * 2 + 1};
+    RenderCommand* cmd = push_command(RQ_CIRCLE, &bounds);
+    cmd->color = color;
+    cmd->filled = filled;
+    cmd->thickness = thickness;
+}
+
+// Queue a triangle mesh drawn with a single SDL_RenderGeometry call. The
+// vertex and index arrays must stay valid until the queue is flushed.
+void queue_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertex_count,
+                    const int* indices, int index_count, const SDL_Rect* bounds, SDL_BlendMode blend) {
+    if (vertex_count <= 0) return;
+    RenderCommand* cmd = push_command(RQ_GEOMETRY, bounds);
+    cmd->texture = texture;
+    cmd->blend = blend;
+    cmd->color = create_color(255, 255, 255, 255);
+    cmd->vertices = vertices;
+    cmd->vertex_count = vertex_count;
+    cmd->indices = indices;
+    cmd->index_count = index_count;
+}
+
+// Two commands overlap if their bounds intersect
+static int bounds_overlap(const SDL_Rect* a, const SDL_Rect* b) {
+    return a->x < b->x + b->w && b->x < a->x + a->w &&
+           a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+// Two commands share state if they could be submitted back to back
+// without touching the renderer state
+static int same_state(const RenderCommand* a, const RenderCommand* b) {
+    return a->texture == b->texture && a->blend == b->blend &&
+           a->color.r == b->color.r && a->color.g == b->color.g &&
+           a->color.b == b->color.b && a->color.a == b->color.a;
+}
+
+// Sort by layer, overlap slot, texture, blend mode, color, then submission order
+static int compare_commands(const void* pa, const void* pb) {
+    const RenderCommand* a = (const RenderCommand*)pa;
+    const RenderCommand* b = (const RenderCommand*)pb;
+
+    if (a->layer != b->layer) return a->layer - b->layer;
+    if (a->slot != b->slot) return a->slot - b->slot;
+    if (a->texture != b->texture) return (uintptr_t)a->texture < (uintptr_t)b->texture ? -1 : 1;
+    if (a->blend != b->blend) return (int)a->blend - (int)b->blend;
+
+    Uint32 ca = ((Uint32)a->color.r << 24) | ((Uint32)a->color.g << 16) | ((Uint32)a->color.b << 8) | a->color.a;
+    Uint32 cb = ((Uint32)b->color.r << 24) | ((Uint32)b->color.g << 16) | ((Uint32)b->color.b << 8) | b->color.a;
+    if (ca != cb) return ca < cb ? -1 : 1;
+    if (a->type != b->type) return (int)a->type - (int)b->type;
+    return a->order - b->order;
+}
+
+// Assign every command the lowest slot that keeps it above all earlier,
+// overlapping commands with a different state. Commands in the same slot
+// never overlap (or share state), so they can be reordered freely.
+// This is O(n^2) per layer, which is fine for UI-sized queues.
+static void assign_slots(void) {
+    for (int i = 0; i < command_count; i++) {
+        RenderCommand* cmd = &commands[i];
+        cmd->slot = 0;
+        for (int j = 0; j < i; j++) {
+            RenderCommand* prev = &commands[j];
+            if (prev->layer != cmd->layer) continue;
+            if (prev->slot < cmd->slot) continue;
+            if (!bounds_overlap(&prev->bounds, &cmd->bounds)) continue;
+            if (same_state(prev, cmd) && prev->type == cmd->type) {
+                cmd->slot = prev->slot;
+            } else {
+                cmd->slot = prev->slot + 1;
+            }
+        }
+    }
+}
+
+// Renderer state as last set by the queue (used to elide redundant calls)
+typedef struct {
+    int color_valid;
+    Color color;
+    int blend_valid;
+    SDL_BlendMode blend;
+    SDL_Texture* texture;
+    Color texture_color;
+} RenderState;
+
+static void apply_draw_state(SDL_Renderer* renderer, RenderState* state, const RenderCommand* cmd) {
+    if (!state->blend_valid || state->blend != cmd->blend) {
+        SDL_SetRenderDrawBlendMode(renderer, cmd->blend);
+        state->blend = cmd->blend;
+        state->blend_valid = 1;
+        frame_stats.state_changes++;
+    }
+    if (!state->color_valid ||
+        state->color.r != cmd->color.r || state->color.g != cmd->color.g ||
+        state->color.b != cmd->color.b || state->color.a != cmd->color.a) {
+        SDL_SetRenderDrawColor(renderer, cmd->color.r, cmd->color.g, cmd->color.b, cmd->color.a);
+        state->color = cmd->color;
+        state->color_valid = 1;
+        frame_stats.state_changes++;
+    }
+}
+
+static void apply_texture_state(RenderState* state, const RenderCommand* cmd) {
+    if (state->texture != cmd->texture || state->texture_color.a != cmd->color.a) {
+        SDL_SetTextureAlphaMod(cmd->texture, cmd->color.a);
+        state->texture_color.a = cmd->color.a;
+        frame_stats.state_changes++;
+    }
+    // Only glyph runs are tinted; other textures are always drawn unmodulated
+    if (cmd->type == RQ_GLYPH_RUN &&
+        (state->texture != cmd->texture || state->texture_color.r != cmd->color.r ||
+         state->texture_color.g != cmd->color.g || state->texture_color.b != cmd->color.b)) {
+        SDL_SetTextureColorMod(cmd->texture, cmd->color.r, cmd->color.g, cmd->color.b);
+        state->texture_color.r = cmd->color.r;
+        state->texture_color.g = cmd->color.g;
+        state->texture_color.b = cmd->color.b;
+        frame_stats.state_changes++;
+    }
+    state->texture = cmd->texture;
+}
+
+// Submit a run of filled circles as horizontal spans
+static void submit_filled_circle(SDL_Renderer* renderer, const RenderCommand* cmd) {
+    int radius = (cmd->bounds.w - 1) / 2;
+    int cx = cmd->bounds.x + radius;
+    int cy = cmd->bounds.y + radius;
+    int count = 0;
+
+    for (int dy = -radius; dy <= radius && count < MAX_BATCH_RECTS; dy++) {
+        int dx = (int)sqrt((double)(radius * radius - dy * dy));
+        batch_rects[count++] = (SDL_Rect){cx - dx, cy + dy, dx * 2 + 1, 1};
+    }
+    SDL_RenderFillRects(renderer, batch_rects, count);
+    frame_stats.submissions++;
+}
+
+// Submit a circle outline as a single point list
+static void submit_circle_outline(SDL_Renderer* renderer, const RenderCommand* cmd) {
+    int radius = (cmd->bounds.w - 1) / 2;
+    int cx = cmd->bounds.x + radius;
+    int cy = cmd->bounds.y + radius;
+    int count = 0;
+
+    for (int t = 0; t < cmd->thickness; t++) {
+        int r = radius - t;
+        int x = r;
+        int y = 0;
+        int err = 0;
+
+        while (x >= y && count + 8 <= MAX_BATCH_RECTS) {
+            batch_points[count++] = (SDL_Point){cx + x, cy + y};
+            batch_points[count++] = (SDL_Point){cx + y, cy + x};
+            batch_points[count++] = (SDL_Point){cx - y, cy + x};
+            batch_points[count++] = (SDL_Point){cx - x, cy + y};
+            batch_points[count++] = (SDL_Point){cx - x, cy - y};
+            batch_points[count++] = (SDL_Point){cx - y, cy - x};
+            batch_points[count++] = (SDL_Point){cx + y, cy - x};
+            batch_points[count++] = (SDL_Point){cx + x, cy - y};
+
+            if (err <= 0) {
+                y += 1;
+                err += 2*y + 1;
+            }
+            if (err > 0) {
+                x -= 1;
+                err -= 2*x + 1;
+            }
+        }
+    }
+    SDL_RenderDrawPoints(renderer, batch_points, count);
+    frame_stats.submissions++;
+}
+
+// Sort, batch and submit every queued command, then empty the queue
+void render_queue_flush(SDL_Renderer* renderer) {
+    if (!renderer || command_count == 0) return;
+
+    frame_stats.commands += command_count;
+
+    assign_slots();
+    qsort(commands, command_count, sizeof(RenderCommand), compare_commands);
+
+    // State set outside the queue (e.g. by SDL_RenderClear) is unknown
+    RenderState state;
+    memset(&state, 0, sizeof(state));
+
+    int i = 0;
+    while (i < command_count) {
+        RenderCommand* cmd = &commands[i];
+
+        switch (cmd->type) {
+            case RQ_FILL_RECT:
+            case RQ_OUTLINE_RECT: {
+                // Batch consecutive rects of the same kind and state
+                apply_draw_state(renderer, &state, cmd);
+                int count = 0;
+                int j = i;
+                while (j < command_count && count < MAX_BATCH_RECTS &&
+                       commands[j].type == cmd->type && same_state(&commands[j], cmd)) {
+                    batch_rects[count++] = commands[j].bounds;
+                    j++;
+                }
+                if (cmd->type == RQ_FILL_RECT) {
+                    SDL_RenderFillRects(renderer, batch_rects, count);
+                } else {
+                    SDL_RenderDrawRects(renderer, batch_rects, count);
+                }
+                frame_stats.submissions++;
+                i = j;
+                continue;
+            }
+
+            case RQ_CIRCLE:
+                apply_draw_state(renderer, &state, cmd);
+                if (cmd->filled) {
+                    submit_filled_circle(renderer, cmd);
+                } else {
+                    submit_circle_outline(renderer, cmd);
+                }
+                break;
+
+            case RQ_TEXTURE:
+            case RQ_GLYPH_RUN:
+                apply_texture_state(&state, cmd);
+                SDL_RenderCopy(renderer, cmd->texture, cmd->has_src ? &cmd->src : NULL, &cmd->bounds);
+                frame_stats.submissions++;
+                break;
+
+            case RQ_TEXTURE_F:
+                apply_texture_state(&state, cmd);
+                SDL_RenderCopyF(renderer, cmd->texture, cmd->has_src ? &cmd->src : NULL, &cmd->dest_f);
+                frame_stats.submissions++;
+                break;
+
+            case RQ_GEOMETRY:
+                // Untextured meshes use the draw blend mode, colors come from the vertices
+                if (cmd->texture) {
+                    SDL_SetTextureBlendMode(cmd->texture, cmd->blend);
+                    apply_texture_state(&state, cmd);
+                } else {
+                    apply_draw_state(renderer, &state, cmd);
+                }
+                SDL_RenderGeometry(renderer, cmd->texture, cmd->vertices, cmd->vertex_count,
+                                   cmd->indices, cmd->index_count);
+                frame_stats.submissions++;
+                break;
+        }
+        i++;
+    }
+
+    // Release textures that were only alive for this frame
+    for (i = 0; i < command_count; i++) {
+        if (commands[i].owns_texture && commands[i].texture) {
+            SDL_DestroyTexture(commands[i].texture);
+        }
+    }
+    command_count = 0;
+}
+
+// Finish the frame: flush and accumulate statistics
+void render_queue_end(SDL_Renderer* renderer) {
+    render_queue_flush(renderer);
+
+    total_stats.commands += frame_stats.commands;
+    total_stats.state_changes += frame_stats.state_changes;
+    total_stats.submissions += frame_stats.submissions;
+    total_frames++;
+}
+
+// Statistics of the last completed frame
+RenderQueueStats render_queue_get_stats(void) {
+    return frame_stats;
+}
+
+// Print average statistics over all frames so far
+void render_queue_print_stats(void) {
+    if (total_frames == 0) return;
+    printf("Render queue: %d frames, avg %.1f commands, %.1f state changes, %.1f submissions per frame\n",
+           total_frames,
+           (double)total_stats.commands / total_frames,
+           (double)total_stats.state_changes / total_frames,
+           (double)total_stats.submissions / total_frames);
+}
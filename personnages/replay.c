@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// INPUT RECORDING / REPLAY - repeatable interactive workloads
+// =============================================================================
+//
+// File layout (little-endian):
+//   "SDLR"  magic
+//   u16     format version
+//   u16     reserved
+//   records...
+//
+// Every record starts with a one byte kind:
+//   REC_FRAME       varint frame duration (microseconds)
+//   REC_KEY_DOWN    varint timestamp delta (ms), i32 keycode, u16 scancode, u16 mod, u8 repeat
+//   REC_KEY_UP      same as REC_KEY_DOWN
+//   REC_TEXT        varint timestamp delta (ms), u8 length, UTF-8 bytes
+//   REC_MOUSE_DOWN  varint timestamp delta (ms), u8 button, u8 clicks, i16 x, i16 y
+//   REC_MOUSE_UP    same as REC_MOUSE_DOWN
+//   REC_QUIT        varint timestamp delta (ms)
+//   REC_END         end of stream
+//
+// Frame records carry the measured frame time, so a replay at maximum speed
+// still feeds the simulation the original deltas and stays deterministic.
+
+#define REPLAY_MAGIC "SDLR"
+#define REPLAY_VERSION 1
+
+enum {
+    REC_FRAME      = 0,
+    REC_KEY_DOWN   = 1,
+    REC_KEY_UP     = 2,
+    REC_TEXT       = 3,
+    REC_MOUSE_DOWN = 4,
+    REC_MOUSE_UP   = 5,
+    REC_QUIT       = 6,
+    REC_END        = 0xFF
+};
+
+static SDL_RWops* record_file = NULL;
+static Uint32 record_last_timestamp = 0;
+static int recorded_events = 0;
+
+static SDL_RWops* replay_file = NULL;
+static int replay_fast = 0;
+static int replay_pending_kind = -1;     // Kind byte read ahead of time
+static Uint32 replay_timestamp = 0;      // Reconstructed event timestamp
+static double replay_elapsed = 0.0;      // Recorded time of the frames played so far
+static Uint64 replay_start_counter = 0;
+static Uint8 replay_keys[SDL_NUM_SCANCODES];
+
+// -----------------------------------------------------------------------------
+// Varint helpers (7 bits per byte, high bit = more bytes follow)
+// -----------------------------------------------------------------------------
+
+static void write_varint(SDL_RWops* rw, Uint32 value) {
+    while (value >= 0x80) {
+        SDL_WriteU8(rw, (Uint8)(value | 0x80));
+        value >>= 7;
+    }
+    SDL_WriteU8(rw, (Uint8)value);
+}
+
+static Uint32 read_varint(SDL_RWops* rw) {
+    Uint32 value = 0;
+    int shift = 0;
+    Uint8 byte;
+    do {
+        if (SDL_RWread(rw, &byte, 1, 1) != 1) return value;
+        value |= (Uint32)(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && shift < 32);
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+// Recording
+// -----------------------------------------------------------------------------
+
+// Open a file and start recording events into it
+int start_input_recording(const char* path) {
+    record_file = SDL_RWFromFile(path, "wb");
+    if (!record_file) {
+        printf("Failed to open recording file '%s': %s\n", path, SDL_GetError());
+        return -1;
+    }
+
+    SDL_RWwrite(record_file, REPLAY_MAGIC, 1, 4);
+    SDL_WriteLE16(record_file, REPLAY_VERSION);
+    SDL_WriteLE16(record_file, 0);
+
+    record_last_timestamp = SDL_GetTicks();
+    recorded_events = 0;
+    printf("Recording input to '%s'\n", path);
+    return 0;
+}
+
+// Write the delta between this event's timestamp and the previous one
+static void write_timestamp(Uint32 timestamp) {
+    Uint32 delta = timestamp >= record_last_timestamp ? timestamp - record_last_timestamp : 0;
+    write_varint(record_file, delta);
+    record_last_timestamp = timestamp;
+}
+
+// Record one SDL event (ignored if not recording or not relevant)
+void record_input_event(const SDL_Event* event) {
+    if (!record_file) return;
+
+    switch (event->type) {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            SDL_WriteU8(record_file, event->type == SDL_KEYDOWN ? REC_KEY_DOWN : REC_KEY_UP);
+            write_timestamp(event->key.timestamp);
+            SDL_WriteLE32(record_file, (Uint32)event->key.keysym.sym);
+            SDL_WriteLE16(record_file, (Uint16)event->key.keysym.scancode);
+            SDL_WriteLE16(record_file, event->key.keysym.mod);
+            SDL_WriteU8(record_file, event->key.repeat);
+            break;
+
+        case SDL_TEXTINPUT: {
+            Uint8 len = (Uint8)strlen(event->text.text);
+            SDL_WriteU8(record_file, REC_TEXT);
+            write_timestamp(event->text.timestamp);
+            SDL_WriteU8(record_file, len);
+            SDL_RWwrite(record_file, event->text.text, 1, len);
+            break;
+        }
+
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            SDL_WriteU8(record_file, event->type == SDL_MOUSEBUTTONDOWN ? REC_MOUSE_DOWN : REC_MOUSE_UP);
+            write_timestamp(event->button.timestamp);
+            SDL_WriteU8(record_file, event->button.button);
+            SDL_WriteU8(record_file, event->button.clicks);
+            SDL_WriteLE16(record_file, (Uint16)(Sint16)event->button.x);
+            SDL_WriteLE16(record_file, (Uint16)(Sint16)event->button.y);
+            break;
+
+        case SDL_QUIT:
+            SDL_WriteU8(record_file, REC_QUIT);
+            write_timestamp(event->common.timestamp);
+            break;
+
+        default:
+            return;
+    }
+    recorded_events++;
+}
+
+// Record the start of a frame and how long the previous one took
+void record_input_frame(double frame_seconds) {
+    if (!record_file) return;
+
+    SDL_WriteU8(record_file, REC_FRAME);
+    write_varint(record_file, (Uint32)(frame_seconds * 1000000.0 + 0.5));
+}
+
+// Finish and close the recording
+void stop_input_recording(void) {
+    if (!record_file) return;
+
+    SDL_WriteU8(record_file, REC_END);
+    Sint64 size = SDL_RWtell(record_file);
+    SDL_RWclose(record_file);
+    record_file = NULL;
+    printf("Recording finished: %d events, %lld bytes\n", recorded_events, (long long)size);
+}
+
+// -----------------------------------------------------------------------------
+// Replay
+// -----------------------------------------------------------------------------
+
+// Open a recording for replay. fast = 1 ignores the original timing.
+int start_input_replay(const char* path, int fast) {
+    replay_file = SDL_RWFromFile(path, "rb");
+    if (!replay_file) {
+        printf("Failed to open replay file '%s': %s\n", path, SDL_GetError());
+        return -1;
+    }
+
+    char magic[4];
+    if (SDL_RWread(replay_file, magic, 1, 4) != 4 || memcmp(magic, REPLAY_MAGIC, 4) != 0) {
+        printf("Error: '%s' is not an input recording\n", path);
+        SDL_RWclose(replay_file);
+        replay_file = NULL;
+        return -1;
+    }
+    Uint16 version = SDL_ReadLE16(replay_file);
+    SDL_ReadLE16(replay_file);
+    if (version != REPLAY_VERSION) {
+        printf("Error: Unsupported recording version %d\n", version);
+        SDL_RWclose(replay_file);
+        replay_file = NULL;
+        return -1;
+    }
+
+    replay_fast = fast;
+    replay_pending_kind = -1;
+    replay_timestamp = 0;
+    replay_elapsed = 0.0;
+    replay_start_counter = SDL_GetPerformanceCounter();
+    memset(replay_keys, 0, sizeof(replay_keys));
+    printf("Replaying input from '%s' (%s speed)\n", path, fast ? "maximum" : "original");
+    return 0;
+}
+
+// Is a replay currently running?
+int is_replay_active(void) {
+    return replay_file != NULL;
+}
+
+// Read the next record kind (or the one already peeked)
+static int next_record_kind(void) {
+    if (replay_pending_kind >= 0) {
+        int kind = replay_pending_kind;
+        replay_pending_kind = -1;
+        return kind;
+    }
+    Uint8 kind;
+    if (SDL_RWread(replay_file, &kind, 1, 1) != 1) return REC_END;
+    return kind;
+}
+
+// Start the next recorded frame. Returns 0 when the recording is over.
+// At original speed this waits until the frame is due.
+int replay_begin_frame(double* frame_seconds) {
+    if (!replay_file) return 0;
+
+    *frame_seconds = 0.0;
+    int kind = next_record_kind();
+    if (kind == REC_END) return 0;
+    if (kind != REC_FRAME) {
+        // Events without a preceding frame marker belong to a zero-length frame
+        replay_pending_kind = kind;
+        return 1;
+    }
+
+    *frame_seconds = read_varint(replay_file) / 1000000.0;
+    replay_elapsed += *frame_seconds;
+
+    if (!replay_fast) {
+        double wall = (double)(SDL_GetPerformanceCounter() - replay_start_counter) /
+                      (double)SDL_GetPerformanceFrequency();
+        if (replay_elapsed > wall) {
+            SDL_Delay((Uint32)((replay_elapsed - wall) * 1000.0));
+        }
+    }
+    return 1;
+}
+
+// Return the next recorded event of the current frame (like SDL_PollEvent)
+int replay_poll_event(SDL_Event* event) {
+    if (!replay_file) return 0;
+
+    int kind = next_record_kind();
+    if (kind == REC_FRAME || kind == REC_END) {
+        // Belongs to the next frame (or ends the stream)
+        replay_pending_kind = kind;
+        return 0;
+    }
+
+    memset(event, 0, sizeof(*event));
+    replay_timestamp += read_varint(replay_file);
+
+    switch (kind) {
+        case REC_KEY_DOWN:
+        case REC_KEY_UP:
+            event->type = kind == REC_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+            event->key.timestamp = replay_timestamp;
+            event->key.state = kind == REC_KEY_DOWN ? SDL_PRESSED : SDL_RELEASED;
+            event->key.keysym.sym = (SDL_Keycode)SDL_ReadLE32(replay_file);
+            event->key.keysym.scancode = (SDL_Scancode)SDL_ReadLE16(replay_file);
+            event->key.keysym.mod = SDL_ReadLE16(replay_file);
+            event->key.repeat = SDL_ReadU8(replay_file);
+            if (event->key.keysym.scancode < SDL_NUM_SCANCODES) {
+                replay_keys[event->key.keysym.scancode] = kind == REC_KEY_DOWN;
+            }
+            break;
+
+        case REC_TEXT: {
+            Uint8 len = SDL_ReadU8(replay_file);
+            if (len >= SDL_TEXTINPUTEVENT_TEXT_SIZE) len = SDL_TEXTINPUTEVENT_TEXT_SIZE - 1;
+            event->type = SDL_TEXTINPUT;
+            event->text.timestamp = replay_timestamp;
+            SDL_RWread(replay_file, event->text.text, 1, len);
+            event->text.text[len] = '\0';
+            break;
+        }
+
+        case REC_MOUSE_DOWN:
+        case REC_MOUSE_UP:
+            event->type = kind == REC_MOUSE_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            event->button.timestamp = replay_timestamp;
+            event->button.state = kind == REC_MOUSE_DOWN ? SDL_PRESSED : SDL_RELEASED;
+            event->button.button = SDL_ReadU8(replay_file);
+            event->button.clicks = SDL_ReadU8(replay_file);
+            event->button.x = (Sint16)SDL_ReadLE16(replay_file);
+            event->button.y = (Sint16)SDL_ReadLE16(replay_file);
+            break;
+
+        case REC_QUIT:
+            event->type = SDL_QUIT;
+            event->common.timestamp = replay_timestamp;
+            break;
+
+        default:
+            printf("Error: Corrupt recording (record kind %d)\n", kind);
+            replay_pending_kind = REC_END;
+            return 0;
+    }
+    return 1;
+}
+
+// Keyboard state reconstructed from the replayed key events
+const Uint8* replay_keyboard_state(void) {
+    return replay_keys;
+}
+
+// Close the replay file
+void stop_input_replay(void) {
+    if (!replay_file) return;
+
+    SDL_RWclose(replay_file);
+    replay_file = NULL;
+    printf("Replay finished (%.2f s of recorded time)\n", replay_elapsed);
+}
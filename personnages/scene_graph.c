@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include "header.h"
+
+// =============================================================================
+// SCENE GRAPH - parent links, relative positions and cached world bounds
+// =============================================================================
+//
+// Every sequence stores its position relative to its parent (local_x/local_y).
+// The world position (x/y) and the bounds of the whole subtree are cached and
+// only recomputed for subtrees flagged dirty, so moving a container is a single
+// update_sequence_position() call no matter how many children it has.
+
+// Index of a sequence inside the active pool (-1 for a sequence of another
+// scene: it is brought up to date when its scene is entered)
+static int sequence_index(const Sequence* seq) {
+    return is_active_sequence(seq) ? (int)(seq - sequences) : -1;
+}
+
+// Check whether 'node' is 'ancestor' or one of its descendants
+static int is_in_subtree(int node, int ancestor) {
+    while (node >= 0) {
+        if (node == ancestor) return 1;
+        node = sequences[node].parent;
+    }
+    return 0;
+}
+
+// Remove a sequence from its parent's child list
+static void detach_from_parent(Sequence* child) {
+    int idx = sequence_index(child);
+    if (child->parent < 0) return;
+
+    Sequence* parent = &sequences[child->parent];
+    if (parent->first_child == idx) {
+        parent->first_child = child->next_sibling;
+    } else {
+        for (int c = parent->first_child; c >= 0; c = sequences[c].next_sibling) {
+            if (sequences[c].next_sibling == idx) {
+                sequences[c].next_sibling = child->next_sibling;
+                break;
+            }
+        }
+    }
+    child->parent = -1;
+    child->next_sibling = -1;
+    mark_sequence_dirty(parent);
+}
+
+// Attach a sequence to a parent (NULL = make it a root again).
+// If keep_world_position is 1 the child stays where it is on screen,
+// otherwise its current local position is interpreted relative to the parent.
+int set_sequence_parent(Sequence* child, Sequence* parent, int keep_world_position) {
+    if (!child) return -1;
+
+    int child_idx = sequence_index(child);
+    if (child_idx < 0 || (parent && sequence_index(parent) < 0)) {
+        printf("Error: Cannot parent '%s' outside the active sequence pool\n", child->name);
+        return -1;
+    }
+    if (parent && is_in_subtree(sequence_index(parent), child_idx)) {
+        printf("Error: Cannot parent '%s' to its own descendant '%s'\n",
+               child->name, parent->name);
+        return -1;
+    }
+
+    // Make sure world coordinates are current before converting
+    update_scene_graph();
+
+    int world_x = child->x;
+    int world_y = child->y;
+
+    detach_from_parent(child);
+
+    if (parent) {
+        child->parent = sequence_index(parent);
+
+        // Append at the end so draw order follows creation order
+        if (parent->first_child < 0) {
+            parent->first_child = child_idx;
+        } else {
+            int last = parent->first_child;
+            while (sequences[last].next_sibling >= 0) last = sequences[last].next_sibling;
+            sequences[last].next_sibling = child_idx;
+        }
+    }
+
+    if (keep_world_position) {
+        child->local_x = world_x - (parent ? parent->x : 0);
+        child->local_y = world_y - (parent ? parent->y : 0);
+    }
+
+    mark_sequence_dirty(child);
+    return 0;
+}
+
+// Set the group opacity of a sequence (affects the sequence and all children)
+void set_sequence_opacity(Sequence* seq, Uint8 opacity) {
+    if (!seq || seq->opacity == opacity) return;
+
+    seq->opacity = opacity;
+    seq->generation++;
+    mark_sequence_dirty(seq);
+}
+
+// Flag a sequence for update and propagate "something below changed" upwards.
+// Stops as soon as an ancestor is already flagged, so repeated calls are cheap.
+void mark_sequence_dirty(Sequence* seq) {
+    if (!seq) return;
+
+    seq->dirty = 1;
+    int idx = sequence_index(seq);
+    while (idx >= 0 && !sequences[idx].subtree_dirty) {
+        sequences[idx].subtree_dirty = 1;
+        idx = sequences[idx].parent;
+    }
+}
+
+// Grow 'dst' so that it also contains 'src'
+static void union_bounds(SDL_Rect* dst, const SDL_Rect* src) {
+    if (src->w <= 0 || src->h <= 0) return;
+    if (dst->w <= 0 || dst->h <= 0) {
+        *dst = *src;
+        return;
+    }
+    int x1 = dst->x < src->x ? dst->x : src->x;
+    int y1 = dst->y < src->y ? dst->y : src->y;
+    int x2 = (dst->x + dst->w) > (src->x + src->w) ? (dst->x + dst->w) : (src->x + src->w);
+    int y2 = (dst->y + dst->h) > (src->y + src->h) ? (dst->y + dst->h) : (src->y + src->h);
+    dst->x = x1;
+    dst->y = y1;
+    dst->w = x2 - x1;
+    dst->h = y2 - y1;
+}
+
+// Recompute a node and its dirty descendants.
+// 'force' is set when an ancestor moved, so the whole subtree must follow.
+static void update_node(int idx, int force) {
+    Sequence* seq = &sequences[idx];
+    if (!force && !seq->subtree_dirty) return;
+
+    if (force || seq->dirty) {
+        int old_x = seq->x, old_y = seq->y;
+        Uint8 old_opacity = seq->world_opacity;
+        int old_visible = seq->world_visible;
+        if (seq->parent >= 0) {
+            Sequence* parent = &sequences[seq->parent];
+            seq->x = parent->x + seq->local_x;
+            seq->y = parent->y + seq->local_y;
+            seq->world_opacity = (Uint8)((parent->world_opacity * seq->opacity) / 255);
+            seq->world_visible = parent->world_visible && seq->visible;
+        } else {
+            seq->x = seq->local_x;
+            seq->y = seq->local_y;
+            seq->world_opacity = seq->opacity;
+            seq->world_visible = seq->visible;
+        }
+        // Followers (colliders, ...) only see world changes through the generation
+        if (seq->x != old_x || seq->y != old_y || seq->world_opacity != old_opacity ||
+            seq->world_visible != old_visible) {
+            seq->generation++;
+        }
+        force = 1;
+    }
+
+    SDL_Rect bounds = {seq->x, seq->y, seq->w, seq->h};
+    for (int c = seq->first_child; c >= 0; c = sequences[c].next_sibling) {
+        update_node(c, force);
+        union_bounds(&bounds, &sequences[c].subtree_bounds);
+    }
+    seq->subtree_bounds = bounds;
+
+    seq->dirty = 0;
+    seq->subtree_dirty = 0;
+}
+
+// Bring cached world positions and bounds up to date (call once per frame)
+void update_scene_graph(void) {
+    for (int i = 0; i < sequence_count; i++) {
+        if (sequences[i].parent < 0 && sequences[i].subtree_dirty) {
+            update_node(i, 0);
+        }
+    }
+}
+
+// Recompute every node of the active pool at the next update (the pool was
+// just swapped in and may have been changed while it was inactive)
+void invalidate_scene_graph(void) {
+    for (int i = 0; i < sequence_count; i++) {
+        sequences[i].dirty = 1;
+        sequences[i].subtree_dirty = 1;
+    }
+}
+
+// A subtree is culled when it is hidden, fully transparent or entirely off-screen
+int is_sequence_subtree_culled(const Sequence* seq) {
+    if (!seq->world_visible || seq->world_opacity == 0) return 1;
+
+    const SDL_Rect* b = &seq->subtree_bounds;
+    return b->x >= SCREEN_WIDTH || b->y >= SCREEN_HEIGHT ||
+           b->x + b->w <= 0 || b->y + b->h <= 0;
+}
+
+// Depth-first hit test; the last match in draw order (the topmost) wins
+static void pick_node(int idx, int x, int y, int inputs_only, Sequence** best) {
+    Sequence* seq = &sequences[idx];
+    if (is_sequence_subtree_culled(seq)) return;
+
+    const SDL_Rect* b = &seq->subtree_bounds;
+    if (x < b->x || x > b->x + b->w || y < b->y || y > b->y + b->h) return;
+
+    if ((!inputs_only || seq->is_input) &&
+        x >= seq->x && x <= seq->x + seq->w &&
+        y >= seq->y && y <= seq->y + seq->h) {
+        *best = seq;
+    }
+
+    for (int c = seq->first_child; c >= 0; c = sequences[c].next_sibling) {
+        pick_node(c, x, y, inputs_only, best);
+    }
+}
+
+// Return the topmost visible sequence under a screen point, or NULL
+Sequence* pick_sequence_at(int x, int y, int inputs_only) {
+    Sequence* best = NULL;
+    for (int i = 0; i < sequence_count; i++) {
+        if (sequences[i].parent < 0) {
+            pick_node(i, x, y, inputs_only, &best);
+        }
+    }
+    return best;
+}
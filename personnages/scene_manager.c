@@ -0,0 +1,486 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// SCENE MANAGER - screens with their own pools, preloaded in the background
+// =============================================================================
+//
+// Each screen of the game (menu, character select, game, results) is a scene
+// owning its own sequence and round sequence pools. A scene declares the
+// images it needs and the scene that usually follows it. While a scene runs,
+// the next one is prepared: its images are decoded by the job workers and
+// uploaded a few per frame, then it is built with its pools swapped in for
+// the duration of the build. Entering it is a pointer swap.
+//
+// A scene that is left stays built (sequences, labels, images), so going back
+// is instant as well. Beyond SCENE_MAX_CACHED built scenes the least recently
+// used one is unloaded: its fonts and text textures go back to their caches
+// and its images stay in the texture cache until the slot is needed or the
+// cache goes over its memory budget (the texture budget of the settings).
+// Sprite sheets draw from the same cache, so an atlas declared by the scene
+// is decoded off the render thread and exists on the GPU only once.
+
+static Scene scenes[SCENE_MAX_SCENES];
+static int scene_count = 0;
+static int active_scene = -1;
+static int requested_scene = -1;
+static SDL_Renderer* scene_renderer = NULL;
+static Uint32 frame = 0;
+
+static SceneTexture textures[SCENE_TEXTURE_CACHE];
+static size_t texture_bytes = 0;
+static size_t texture_budget = 0;      // 0 = unlimited
+static JobCounter decode_counter;
+static SceneStats stats;
+
+static Scene* get_scene(int scene) {
+    if (scene < 0 || scene >= scene_count) return NULL;
+    return &scenes[scene];
+}
+
+// The scene manager draws with this renderer (builds and uploads)
+void init_scene_manager(SDL_Renderer* renderer) {
+    scene_renderer = renderer;
+    scene_count = 0;
+    active_scene = -1;
+    requested_scene = -1;
+    frame = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Declare a scene. Nothing is loaded until it is preloaded or entered.
+// Returns the scene index, or -1.
+int register_scene(const char* name, const SceneConfig* config) {
+    if (scene_count >= SCENE_MAX_SCENES) {
+        printf("Error: Maximum scenes limit reached (%d)\n", SCENE_MAX_SCENES);
+        return -1;
+    }
+    if (config->image_count > SCENE_MAX_IMAGES) {
+        printf("Error: Scene '%s' declares too many images (max %d)\n", name, SCENE_MAX_IMAGES);
+        return -1;
+    }
+    Scene* scene = &scenes[scene_count];
+    memset(scene, 0, sizeof(*scene));
+    strncpy(scene->name, name, sizeof(scene->name) - 1);
+    scene->config = *config;
+    scene->state = SCENE_UNLOADED;
+    return scene_count++;
+}
+
+// Find a scene by name (-1 if missing)
+int find_scene(const char* name) {
+    if (!name) return -1;
+    for (int i = 0; i < scene_count; i++) {
+        if (strcmp(scenes[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+const char* get_scene_name(int scene) {
+    Scene* s = get_scene(scene);
+    return s ? s->name : "";
+}
+
+int get_active_scene(void) {
+    return active_scene;
+}
+
+// Scene declared as following this one (-1 if none)
+int get_next_scene(int scene) {
+    Scene* s = get_scene(scene);
+    return s ? find_scene(s->config.next) : -1;
+}
+
+// -----------------------------------------------------------------------------
+// Texture cache
+// -----------------------------------------------------------------------------
+
+// Worker side: decode an image into a surface
+static void decode_scene_texture(void* data) {
+    SceneTexture* texture = (SceneTexture*)data;
+    texture->surface = IMG_Load(texture->path);
+    SDL_AtomicSet(&texture->decoded, 1);
+}
+
+// Take a reference on an image, starting its decode if it is not cached.
+// Returns the cache index, or -1 if the cache is full of used images.
+static int acquire_scene_texture(const char* path) {
+    int free_slot = -1;
+    for (int i = 0; i < SCENE_TEXTURE_CACHE; i++) {
+        SceneTexture* t = &textures[i];
+        if (t->path[0] && strcmp(t->path, path) == 0) {
+            if (t->texture) stats.texture_hits++;
+            t->refcount++;
+            return i;
+        }
+        // Empty slots first, then the unused image released the longest ago
+        if (t->refcount > 0 || t->decoding) continue;
+        if (free_slot < 0 || !t->path[0] ||
+            (textures[free_slot].path[0] && t->released_at < textures[free_slot].released_at)) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        printf("Error: Scene texture cache full (%d images in use)\n", SCENE_TEXTURE_CACHE);
+        return -1;
+    }
+
+    SceneTexture* t = &textures[free_slot];
+    if (t->texture) {
+        SDL_DestroyTexture(t->texture);
+        texture_bytes -= (size_t)t->w * t->h * 4;
+    }
+    memset(t, 0, sizeof(*t));
+    strncpy(t->path, path, sizeof(t->path) - 1);
+    t->refcount = 1;
+    t->decoding = 1;
+
+    Job job = {decode_scene_texture, t, NULL};
+    run_jobs(&job, 1, &decode_counter);
+    return free_slot;
+}
+
+// Upload a decoded image (render thread)
+static void upload_scene_texture(SceneTexture* t) {
+    t->decoding = 0;
+    SDL_AtomicSet(&t->decoded, 0);
+    if (t->surface) {
+        t->texture = SDL_CreateTextureFromSurface(scene_renderer, t->surface);
+        t->w = t->surface->w;
+        t->h = t->surface->h;
+        SDL_FreeSurface(t->surface);
+        t->surface = NULL;
+    }
+    if (!t->texture) {
+        printf("Failed to load scene image '%s': %s\n", t->path, IMG_GetError());
+        t->failed = 1;
+        return;
+    }
+    texture_bytes += (size_t)t->w * t->h * 4;
+    stats.uploads++;
+}
+
+// Destroy the unused images released the longest ago while the cache is
+// over its budget
+static void trim_scene_textures(void) {
+    while (texture_budget > 0 && texture_bytes > texture_budget) {
+        SceneTexture* victim = NULL;
+        for (int i = 0; i < SCENE_TEXTURE_CACHE; i++) {
+            SceneTexture* t = &textures[i];
+            if (!t->texture || t->refcount > 0) continue;
+            if (!victim || t->released_at < victim->released_at) victim = t;
+        }
+        if (!victim) return;   // Everything left belongs to a loaded scene
+
+        SDL_DestroyTexture(victim->texture);
+        texture_bytes -= (size_t)victim->w * victim->h * 4;
+        memset(victim, 0, sizeof(*victim));
+        stats.images_evicted++;
+    }
+}
+
+// Memory the scene images may use (0 = unlimited). Images of loaded scenes
+// are kept whatever the budget.
+void set_scene_texture_budget(size_t bytes) {
+    texture_budget = bytes;
+    trim_scene_textures();
+}
+
+// Upload the images whose decode finished, at most 'limit' of them
+static void upload_decoded_textures(int limit) {
+    int uploads = 0;
+    for (int i = 0; i < SCENE_TEXTURE_CACHE && uploads < limit; i++) {
+        if (textures[i].decoding && SDL_AtomicGet(&textures[i].decoded)) {
+            upload_scene_texture(&textures[i]);
+            uploads++;
+        }
+    }
+}
+
+// Show a cached image on a sequence. The image must be declared by the scene
+// being built. Returns 0 on success, -1 if it is not available.
+int set_sequence_scene_image(Sequence* seq, const char* path) {
+    if (!seq) return -1;
+    for (int i = 0; i < SCENE_TEXTURE_CACHE; i++) {
+        SceneTexture* t = &textures[i];
+        if (!t->texture || strcmp(t->path, path) != 0) continue;
+        if (seq->image && !seq->image_shared) SDL_DestroyTexture(seq->image);
+        seq->image = t->texture;
+        seq->image_shared = 1;
+        seq->image_width = t->w;
+        seq->image_height = t->h;
+        return 0;
+    }
+    printf("Warning: Scene image '%s' is not loaded\n", path);
+    return -1;
+}
+
+// Take a reference on a cached image for another owner (a sprite sheet).
+// Images declared by the scene being built are already uploaded; any other
+// image is decoded by a worker and uploaded right away, which stalls this
+// frame. Returns NULL if the image cannot be loaded.
+SDL_Texture* acquire_scene_image(const char* path) {
+    int index = acquire_scene_texture(path);
+    if (index < 0) return NULL;
+
+    SceneTexture* t = &textures[index];
+    if (t->decoding) {
+        printf("Warning: Image '%s' is not declared by the scene, loading it now\n", path);
+        wait_for_counter(&decode_counter);
+        upload_decoded_textures(SCENE_TEXTURE_CACHE);
+    }
+    if (!t->texture) {
+        t->refcount--;
+        t->released_at = frame;
+        return NULL;
+    }
+    return t->texture;
+}
+
+// Drop a reference taken with acquire_scene_image()
+void release_scene_image(SDL_Texture* texture) {
+    for (int i = 0; texture && i < SCENE_TEXTURE_CACHE; i++) {
+        if (textures[i].texture != texture) continue;
+        if (textures[i].refcount > 0) textures[i].refcount--;
+        textures[i].released_at = frame;
+        trim_scene_textures();
+        return;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Loading and switching
+// -----------------------------------------------------------------------------
+
+// Run 'function' with the pools of a scene swapped in, then restore the
+// pools of the active scene
+static void with_scene_pools(Scene* scene, void (*function)(Scene* scene)) {
+    Sequence* saved_sequences = sequences;
+    int saved_count = sequence_count;
+    RoundSequence* saved_rounds = round_sequences;
+    int saved_round_count = round_sequence_count;
+
+    sequences = scene->sequences;
+    sequence_count = scene->sequence_count;
+    round_sequences = scene->round_sequences;
+    round_sequence_count = scene->round_sequence_count;
+
+    function(scene);
+
+    scene->sequence_count = sequence_count;
+    scene->round_sequence_count = round_sequence_count;
+    sequences = saved_sequences;
+    sequence_count = saved_count;
+    round_sequences = saved_rounds;
+    round_sequence_count = saved_round_count;
+}
+
+static void run_build(Scene* scene) {
+    init_sequences();
+    init_round_sequences();
+    if (scene->config.build) scene->config.build((int)(scene - scenes), scene_renderer);
+    update_scene_graph();
+}
+
+static void run_unload(Scene* scene) {
+    if (scene->config.unload) scene->config.unload((int)(scene - scenes), scene_renderer);
+    for (int i = 0; i < sequence_count; i++) {
+        cancel_sequence_tweens(&sequences[i]);
+        stop_sequence_animation(&sequences[i]);
+    }
+    cleanup_sequences();
+    cleanup_round_sequences();
+}
+
+// Whether every image of a loading scene has been uploaded (or failed)
+static int scene_images_ready(const Scene* scene) {
+    for (int i = 0; i < scene->config.image_count; i++) {
+        int t = scene->textures[i];
+        if (t >= 0 && textures[t].decoding) return 0;
+    }
+    return 1;
+}
+
+static void build_scene(Scene* scene) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    with_scene_pools(scene, run_build);
+    scene->state = SCENE_READY;
+    stats.builds++;
+
+    double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 /
+                (double)SDL_GetPerformanceFrequency();
+    printf("Scene '%s' built (%d sequences, %.2f ms)\n", scene->name, scene->sequence_count, ms);
+}
+
+// Start loading a scene in the background (no-op if it is already loaded)
+void preload_scene(int scene) {
+    Scene* s = get_scene(scene);
+    if (!s || s->state != SCENE_UNLOADED) return;
+
+    for (int i = 0; i < s->config.image_count; i++) {
+        s->textures[i] = acquire_scene_texture(s->config.images[i]);
+    }
+    s->state = SCENE_LOADING;
+}
+
+// Release a built scene that is not active
+static void unload_scene(Scene* scene) {
+    with_scene_pools(scene, run_unload);
+    for (int i = 0; i < scene->config.image_count; i++) {
+        int t = scene->textures[i];
+        if (t < 0) continue;
+        if (textures[t].refcount > 0) textures[t].refcount--;
+        textures[t].released_at = frame;
+    }
+    trim_scene_textures();
+    scene->state = SCENE_UNLOADED;
+    stats.unloads++;
+    printf("Scene '%s' unloaded\n", scene->name);
+}
+
+// Keep at most SCENE_MAX_CACHED inactive scenes built. The scene preloaded
+// for the active one is never the one released.
+static void unload_old_scenes(void) {
+    Scene* active = get_scene(active_scene);
+    int next = active ? find_scene(active->config.next) : -1;
+
+    for (;;) {
+        int built = 0;
+        int oldest = -1;
+        for (int i = 0; i < scene_count; i++) {
+            if (scenes[i].state != SCENE_READY) continue;
+            built++;
+            if (i == next) continue;
+            if (oldest < 0 || scenes[i].left_at < scenes[oldest].left_at) oldest = i;
+        }
+        if (built <= SCENE_MAX_CACHED || oldest < 0) return;
+        unload_scene(&scenes[oldest]);
+    }
+}
+
+// Make a scene the active one right away. If it is not ready, its loading
+// is finished first (that frame takes longer). Returns 0 on success.
+int switch_scene(int scene) {
+    Scene* target = get_scene(scene);
+    if (!target) {
+        printf("Error: Unknown scene %d\n", scene);
+        return -1;
+    }
+    if (scene == active_scene) return 0;
+
+    int was_ready = target->state == SCENE_READY;
+    if (target->state == SCENE_UNLOADED) preload_scene(scene);
+    if (target->state == SCENE_LOADING) {
+        wait_for_counter(&decode_counter);
+        upload_decoded_textures(SCENE_TEXTURE_CACHE);
+        build_scene(target);
+    }
+
+    // The scene left keeps its pools as they are
+    Scene* current = get_scene(active_scene);
+    if (current) {
+        unfocus_all_inputs();
+        if (current->config.leave) current->config.leave(active_scene, scene_renderer);
+        current->sequence_count = sequence_count;
+        current->round_sequence_count = round_sequence_count;
+        current->state = SCENE_READY;
+        current->left_at = frame;
+    }
+
+    sequences = target->sequences;
+    sequence_count = target->sequence_count;
+    round_sequences = target->round_sequences;
+    round_sequence_count = target->round_sequence_count;
+    invalidate_scene_graph();
+    target->state = SCENE_ACTIVE;
+    active_scene = scene;
+
+    stats.switches++;
+    if (was_ready) {
+        stats.preloaded++;
+    } else {
+        stats.loaded_on_demand++;
+    }
+    printf("Scene '%s' entered (%s)\n", target->name, was_ready ? "preloaded" : "loaded on demand");
+
+    if (target->config.enter) target->config.enter(scene, scene_renderer);
+    preload_scene(find_scene(target->config.next));
+    unload_old_scenes();
+    return 0;
+}
+
+// Switch at the start of the next update (safe from event handlers)
+void request_scene(int scene) {
+    if (get_scene(scene)) requested_scene = scene;
+}
+
+// Once per frame before the other updates: pending switch, background
+// loading (a few uploads, at most one build) and the active scene's update
+void update_scenes(double frame_seconds) {
+    frame++;
+    if (requested_scene >= 0) {
+        int scene = requested_scene;
+        requested_scene = -1;
+        switch_scene(scene);
+    }
+
+    upload_decoded_textures(SCENE_UPLOADS_PER_FRAME);
+    for (int i = 0; i < scene_count; i++) {
+        if (scenes[i].state == SCENE_LOADING && scene_images_ready(&scenes[i])) {
+            build_scene(&scenes[i]);
+            unload_old_scenes();
+            break;
+        }
+    }
+
+    Scene* active = get_scene(active_scene);
+    if (active && active->config.update) active->config.update(active_scene, frame_seconds);
+}
+
+SceneStats get_scene_stats(void) {
+    return stats;
+}
+
+void print_scene_stats(void) {
+    int cached = 0;
+    for (int i = 0; i < SCENE_TEXTURE_CACHE; i++) {
+        if (textures[i].texture) cached++;
+    }
+    printf("\n=== SCENE STATS ===\n");
+    printf("Switches: %d | preloaded: %d | loaded on demand: %d\n",
+           stats.switches, stats.preloaded, stats.loaded_on_demand);
+    printf("Builds: %d | unloads: %d | images uploaded: %d | cache hits: %d | evicted: %d\n",
+           stats.builds, stats.unloads, stats.uploads, stats.texture_hits, stats.images_evicted);
+    printf("Cached images: %d/%d | %.1f KB (budget %.0f KB)\n",
+           cached, SCENE_TEXTURE_CACHE, texture_bytes / 1024.0, texture_budget / 1024.0);
+    printf("===================\n");
+}
+
+// Unload every scene and free the texture cache. Must run before
+// cleanup_text() and shutdown_job_system().
+void cleanup_scenes(void) {
+    wait_for_counter(&decode_counter);
+
+    Scene* active = get_scene(active_scene);
+    if (active) {
+        active->sequence_count = sequence_count;
+        active->round_sequence_count = round_sequence_count;
+        active->state = SCENE_READY;
+        active_scene = -1;
+    }
+    for (int i = 0; i < scene_count; i++) {
+        if (scenes[i].state == SCENE_READY) unload_scene(&scenes[i]);
+    }
+    sequence_count = 0;
+    round_sequence_count = 0;
+
+    for (int i = 0; i < SCENE_TEXTURE_CACHE; i++) {
+        if (textures[i].surface) SDL_FreeSurface(textures[i].surface);
+        if (textures[i].texture) SDL_DestroyTexture(textures[i].texture);
+    }
+    memset(textures, 0, sizeof(textures));
+    texture_bytes = 0;
+    scene_count = 0;
+    requested_scene = -1;
+}
@@ -1,32 +1,41 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
-#include <math.h>
 #include "header.h"
 
-// Global variables
-Sequence sequences[100];
+// Global variables. The pools are pointers so the scene manager can swap in
+// the pools of the active scene; these are used when no scene is active.
+static Sequence default_sequences[MAX_SEQUENCES];
+static RoundSequence default_round_sequences[MAX_ROUND_SEQUENCES];
+Sequence* sequences = default_sequences;
 int sequence_count = 0;
-RoundSequence round_sequences[50];
+RoundSequence* round_sequences = default_round_sequences;
 int round_sequence_count = 0;
 
+static SequenceFont sequence_fonts[SEQUENCE_MAX_FONTS];
+
 // Helper function to create colors
 Color create_color(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
     Color color = {r, g, b, a};
     return color;
 }
 
+static int same_color(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
 // Initialize sequences system
 void init_sequences(void) {
     sequence_count = 0;
-    memset(sequences, 0, sizeof(sequences));
+    memset(sequences, 0, sizeof(Sequence) * MAX_SEQUENCES);
     printf("Sequences system initialized\n");
 }
 
 // Create a new sequence
 int create_sequence(int id, const char* name, int x, int y, int w, int h, 
                     Color color, const char* text, int font_size) {
-    if (sequence_count >= 100) {
-        printf("Error: Maximum sequences limit reached (100)\n");
+    if (sequence_count >= MAX_SEQUENCES) {
+        printf("Error: Maximum sequences limit reached (%d)\n", MAX_SEQUENCES);
         return -1;
     }
     
@@ -76,6 +85,8 @@ int create_sequence(int id, const char* name, int x, int y, int w, int h,
     seq->image        = NULL;
     seq->image_width  = 0;
     seq->image_height = 0;
+    seq->animation    = -1;
+    seq->text_label   = -1;
 
     // Input field - disabled by default
     seq->is_input       = 0;
@@ -85,6 +96,24 @@ int create_sequence(int id, const char* name, int x, int y, int w, int h,
     seq->cursor_pos     = 0;
     seq->cursor_visible = 0;
     seq->cursor_timer   = 0;
+
+    // Spectrum widget - disabled by default
+    seq->is_spectrum    = 0;
+    seq->bar_color      = create_color(255, 255, 255, 255);
+
+    // Scene graph - new sequences are roots positioned in screen space
+    seq->parent         = -1;
+    seq->first_child    = -1;
+    seq->next_sibling   = -1;
+    seq->local_x        = x;
+    seq->local_y        = y;
+    seq->opacity        = 255;
+    seq->world_opacity  = 255;
+    seq->world_visible  = 1;
+    seq->subtree_bounds = (SDL_Rect){x, y, w, h};
+    seq->dirty          = 0;
+    seq->subtree_dirty  = 0;
+    seq->cull_flags     = 0;
     
     sequence_count++;
     printf("Created sequence: ID=%d, Name='%s' at (%d, %d) size %dx%d\n", 
@@ -93,117 +122,104 @@ int create_sequence(int id, const char* name, int x, int y, int w, int h,
     return sequence_count - 1; // Return index
 }
 
+// Scale an alpha value by the sequence's inherited group opacity
+static Uint8 apply_opacity(Uint8 alpha, Uint8 opacity) {
+    return (Uint8)((alpha * opacity) / 255);
+}
+
 // Draw a single sequence
 void draw_sequence(SDL_Renderer* renderer, Sequence* seq) {
-    if (!seq || !seq->visible) return;
+    if (!seq || !seq->visible || (seq->cull_flags & CULL_SELF)) return;
+
+    Uint8 opacity = seq->world_opacity;
 
     // Delegate input fields to their own draw function
     if (seq->is_input) {
         draw_input_sequence(renderer, seq);
         return;
     }
+
+    // Delegate spectrum displays to their own draw function
+    if (seq->is_spectrum) {
+        draw_spectrum_sequence(renderer, seq);
+        return;
+    }
     
     // Special handling for volume_indicator - draw as circle
     if (strcmp(seq->name, "volume_indicator") == 0) {
-        // Draw filled circle for volume indicator
         int centerX = seq->x + seq->w / 2;
         int centerY = seq->y + seq->h / 2;
         int radius = (seq->w < seq->h ? seq->w : seq->h) / 2;
         
-        // Draw filled circle using multiple horizontal lines
-        SDL_SetRenderDrawColor(renderer, seq->color.r, seq->color.g, seq->color.b, seq->color.a);
-        for (int dy = -radius; dy <= radius; dy++) {
-            int dx = (int)sqrt(radius * radius - dy * dy);
-            SDL_RenderDrawLine(renderer, centerX - dx, centerY + dy, centerX + dx, centerY + dy);
-        }
-        
-        // Draw circle border
-        SDL_SetRenderDrawColor(renderer, 
-                              seq->color.r / 2, 
-                              seq->color.g / 2, 
-                              seq->color.b / 2, 
-                              255);
-        // Simple circle outline using points
-        for (int angle = 0; angle < 360; angle += 2) {
-            float rad = angle * 3.14159 / 180.0;
-            int x = centerX + (int)(radius * cos(rad));
-            int y = centerY + (int)(radius * sin(rad));
-            SDL_RenderDrawPoint(renderer, x, y);
+        // Filled circle plus a darker border
+        if (!(seq->cull_flags & CULL_FILL)) {
+            queue_circle(centerX, centerY, radius,
+                         create_color(seq->color.r, seq->color.g, seq->color.b,
+                                      apply_opacity(seq->color.a, opacity)), 1, 0);
         }
+        queue_circle(centerX, centerY, radius,
+                     create_color(seq->color.r / 2, seq->color.g / 2, seq->color.b / 2, opacity),
+                     0, 1);
     } else {
         // Normal rectangle drawing for other sequences
         SDL_Rect rect = {seq->x, seq->y, seq->w, seq->h};
-        SDL_SetRenderDrawColor(renderer, seq->color.r, seq->color.g, seq->color.b, seq->color.a);
-        SDL_RenderFillRect(renderer, &rect);
+        if (!(seq->cull_flags & CULL_FILL)) {
+            queue_fill_rect(&rect, create_color(seq->color.r, seq->color.g, seq->color.b,
+                                                apply_opacity(seq->color.a, opacity)));
+        }
         
         // Draw border (optional - darker version of the color)
-        SDL_SetRenderDrawColor(renderer, 
-                              seq->color.r / 2, 
-                              seq->color.g / 2, 
-                              seq->color.b / 2, 
-                              255);
-        SDL_RenderDrawRect(renderer, &rect);
+        queue_outline_rect(&rect, create_color(seq->color.r / 2, seq->color.g / 2,
+                                               seq->color.b / 2, opacity));
         
-        // Draw image if present (scaled to fit sequence size)
-        if (seq->image) {
-            SDL_RenderCopy(renderer, seq->image, NULL, &rect);
+        // Draw the current animation frame, or the image if present
+        // (scaled to fit sequence size)
+        SDL_Texture* sheet;
+        SDL_Rect region;
+        if (get_sequence_animation_frame(seq, &sheet, &region)) {
+            queue_texture(sheet, &region, &rect, opacity);
+        } else if (seq->image) {
+            queue_texture(seq->image, NULL, &rect, opacity);
         }
     }
     
-    // Draw text if present (centered inside the sequence)
-    if (strlen(seq->text_content) > 0 && seq->font) {
-        // Render shadow
-        SDL_Surface* shadow_surface = TTF_RenderUTF8_Blended(
-            seq->font,
-            seq->text_content,
-            (SDL_Color){seq->shadow_color.r, seq->shadow_color.g,
-                       seq->shadow_color.b, seq->shadow_color.a}
-        );
-
-        if (shadow_surface) {
-            SDL_Texture* shadow_texture = SDL_CreateTextureFromSurface(renderer, shadow_surface);
-            if (shadow_texture) {
-                SDL_Rect shadow_rect = {
-                    seq->x + (seq->w - shadow_surface->w) / 2 + seq->shadow_offset_x,
-                    seq->y + (seq->h - shadow_surface->h) / 2 + seq->shadow_offset_y,
-                    shadow_surface->w,
-                    shadow_surface->h
-                };
-                SDL_RenderCopy(renderer, shadow_texture, NULL, &shadow_rect);
-                SDL_DestroyTexture(shadow_texture);
-            }
-            SDL_FreeSurface(shadow_surface);
-        }
-
-        // Render main text centered
-        SDL_Surface* text_surface = TTF_RenderUTF8_Blended(
-            seq->font,
-            seq->text_content,
-            (SDL_Color){seq->text_color.r, seq->text_color.g,
-                       seq->text_color.b, seq->text_color.a}
-        );
-
-        if (text_surface) {
-            SDL_Texture* text_texture = SDL_CreateTextureFromSurface(renderer, text_surface);
-            if (text_texture) {
-                SDL_Rect text_rect = {
-                    seq->x + (seq->w - text_surface->w) / 2,
-                    seq->y + (seq->h - text_surface->h) / 2,
-                    text_surface->w,
-                    text_surface->h
-                };
-                SDL_RenderCopy(renderer, text_texture, NULL, &text_rect);
-                SDL_DestroyTexture(text_texture);
-            }
-            SDL_FreeSurface(text_surface);
-        }
+    // Draw text if present (centered inside the sequence). The label is
+    // rasterized off-thread and tinted here, once for the shadow and once
+    // for the text.
+    int text_w, text_h;
+    SDL_Texture* text = get_text_label_texture(seq->text_label, &text_w, &text_h);
+    if (text) {
+        SDL_Rect text_rect = {
+            seq->x + (seq->w - text_w) / 2,
+            seq->y + (seq->h - text_h) / 2,
+            text_w,
+            text_h
+        };
+        SDL_Rect src = {0, 0, text_w, text_h};   // Pooled textures are larger than the text
+        SDL_Rect shadow_rect = text_rect;
+        shadow_rect.x += seq->shadow_offset_x;
+        shadow_rect.y += seq->shadow_offset_y;
+
+        Color shadow = seq->shadow_color;
+        shadow.a = apply_opacity(shadow.a, opacity);
+        queue_text(text, &src, &shadow_rect, shadow);
+
+        Color color = seq->text_color;
+        color.a = apply_opacity(color.a, opacity);
+        queue_text(text, &src, &text_rect, color);
     }
 }
 
-// Draw all sequences
+// Draw all sequences that survive culling (depth-first, in creation order)
 void draw_all_sequences(SDL_Renderer* renderer) {
-    for (int i = 0; i < sequence_count; i++) {
-        draw_sequence(renderer, &sequences[i]);
+    update_scene_graph();
+    cull_sequences();
+    render_queue_set_layer(RENDER_LAYER_SEQUENCES);
+
+    int count = 0;
+    Sequence** list = get_draw_list(&count);
+    for (int i = 0; i < count; i++) {
+        draw_sequence(renderer, list[i]);
     }
 }
 
@@ -218,6 +234,13 @@ Sequence* get_sequence_by_id(int id) {
     return NULL;
 }
 
+// Whether a sequence lives in the active pool (sequences of the other
+// scenes keep their data but are not drawn, picked or laid out)
+int is_active_sequence(const Sequence* seq) {
+    return (uintptr_t)seq >= (uintptr_t)sequences &&
+           (uintptr_t)seq < (uintptr_t)(sequences + sequence_count);
+}
+
 // Get sequence by name
 Sequence* get_sequence_by_name(const char* name) {
     for (int i = 0; i < sequence_count; i++) {
@@ -229,47 +252,128 @@ Sequence* get_sequence_by_name(const char* name) {
     return NULL;
 }
 
-// Update sequence text content
+// Update sequence text content (no-op if the text is unchanged)
 void update_sequence_text(Sequence* seq, const char* new_text) {
     if (!seq) return;
+    if (strncmp(seq->text_content, new_text, sizeof(seq->text_content) - 1) == 0) return;
     
     strncpy(seq->text_content, new_text, sizeof(seq->text_content) - 1);
     seq->text_content[sizeof(seq->text_content) - 1] = '\0';
+    refresh_sequence_text(seq);
 }
 
-// Update sequence position
+// The text a sequence displays changed: send it to its label. Input fields
+// show their buffer, or the placeholder while it is empty.
+void refresh_sequence_text(Sequence* seq) {
+    if (!seq) return;
+
+    seq->generation++;
+    if (seq->text_label < 0) return;
+
+    if (seq->is_input) {
+        set_text_label(seq->text_label,
+                       seq->input_buffer[0] ? seq->input_buffer : seq->placeholder);
+    } else {
+        set_text_label(seq->text_label, seq->text_content);
+    }
+}
+
+// Update sequence position (relative to its parent, or the screen for roots).
+// Children follow automatically on the next scene graph update.
 void update_sequence_position(Sequence* seq, int x, int y) {
     if (!seq) return;
+    if (seq->local_x == x && seq->local_y == y) return;
     
-    seq->x = x;
-    seq->y = y;
+    seq->local_x = x;
+    seq->local_y = y;
+    seq->generation++;
+    mark_sequence_dirty(seq);
+}
+
+// Update sequence size (bounds of the sequence and its ancestors follow)
+void update_sequence_size(Sequence* seq, int w, int h) {
+    if (!seq) return;
+    if (seq->w == w && seq->h == h) return;
+    
+    seq->w = w;
+    seq->h = h;
+    seq->generation++;
+    mark_sequence_dirty(seq);
 }
 
 // Update sequence color
 void update_sequence_color(Sequence* seq, Color new_color) {
-    if (!seq) return;
+    if (!seq || same_color(seq->color, new_color)) return;
     
     seq->color = new_color;
+    seq->generation++;
 }
 
-// Set sequence visibility
+// Set sequence visibility (hiding a sequence hides its whole subtree)
 void set_sequence_visibility(Sequence* seq, int visible) {
-    if (!seq) return;
+    if (!seq || seq->visible == visible) return;
     
     seq->visible = visible;
+    seq->generation++;
+    mark_sequence_dirty(seq);
+}
+
+// Find or open a shared font. Returns NULL if it cannot be opened.
+static TTF_Font* acquire_sequence_font(const char* path, int size) {
+    int free_slot = -1;
+    for (int i = 0; i < SEQUENCE_MAX_FONTS; i++) {
+        SequenceFont* f = &sequence_fonts[i];
+        if (f->font && f->size == size && strcmp(f->path, path) == 0) {
+            f->refcount++;
+            return f->font;
+        }
+        if (free_slot < 0 && (!f->font || f->refcount == 0)) free_slot = i;
+    }
+    if (free_slot < 0) {
+        printf("Error: Maximum sequence fonts limit reached (%d)\n", SEQUENCE_MAX_FONTS);
+        return NULL;
+    }
+
+    TTF_Font* font = TTF_OpenFont(path, size);
+    if (!font) return NULL;
+
+    // Reuse the slot of an unused font if the cache is full
+    SequenceFont* f = &sequence_fonts[free_slot];
+    if (f->font) TTF_CloseFont(f->font);
+    strncpy(f->path, path, sizeof(f->path) - 1);
+    f->path[sizeof(f->path) - 1] = '\0';
+    f->size = size;
+    f->font = font;
+    f->refcount = 1;
+    return font;
+}
+
+// Give a shared font back (it stays open for the next user)
+static void release_sequence_font(TTF_Font* font) {
+    if (!font) return;
+    for (int i = 0; i < SEQUENCE_MAX_FONTS; i++) {
+        if (sequence_fonts[i].font == font) {
+            if (sequence_fonts[i].refcount > 0) sequence_fonts[i].refcount--;
+            return;
+        }
+    }
+}
+
+// Close every shared font (at exit, after the sequences are cleaned up)
+void cleanup_sequence_fonts(void) {
+    for (int i = 0; i < SEQUENCE_MAX_FONTS; i++) {
+        if (sequence_fonts[i].font) TTF_CloseFont(sequence_fonts[i].font);
+    }
+    memset(sequence_fonts, 0, sizeof(sequence_fonts));
 }
 
 // Load a font into a specific sequence
 int load_sequence_font(Sequence* seq, const char* font_path, int font_size) {
     if (!seq) return -1;
     
-    // Close previous font if any
-    if (seq->font) {
-        TTF_CloseFont(seq->font);
-        seq->font = NULL;
-    }
-    
-    seq->font = TTF_OpenFont(font_path, font_size);
+    // Release previous font if any
+    release_sequence_font(seq->font);
+    seq->font = acquire_sequence_font(font_path, font_size);
     if (!seq->font) {
         printf("Failed to load font '%s': %s\n", font_path, TTF_GetError());
         return -1;
@@ -279,6 +383,12 @@ int load_sequence_font(Sequence* seq, const char* font_path, int font_size) {
     strncpy(seq->font_path, font_path, sizeof(seq->font_path) - 1);
     seq->font_path[sizeof(seq->font_path) - 1] = '\0';
     seq->font_size = font_size;
+
+    // Rasterization uses per-worker copies of the font; seq->font stays for
+    // measuring on the main thread
+    release_text_label(seq->text_label);
+    seq->text_label = create_text_label(font_path, font_size);
+    refresh_sequence_text(seq);
     
     printf("Font loaded for sequence '%s': %s (size %d)\n", seq->name, font_path, font_size);
     return 0;
@@ -308,7 +418,7 @@ int load_sequence_image(SDL_Renderer* renderer, Sequence* seq, const char* image
     printf("Loading image for sequence '%s': %s\n", seq->name, image_path);
     
     // Load image as surface
-    SDL_Surface* surface = IMG_Load(image_path);
+    SDL_Surface* surface = load_image_surface(image_path);
     if (!surface) {
         printf("Failed to load image '%s': %s\n", image_path, IMG_GetError());
         return -1;
@@ -320,6 +430,7 @@ int load_sequence_image(SDL_Renderer* renderer, Sequence* seq, const char* image
     
     // Create texture from surface
     seq->image = SDL_CreateTextureFromSurface(renderer, surface);
+    seq->image_shared = 0;
     SDL_FreeSurface(surface);
     
     if (!seq->image) {
@@ -335,15 +446,16 @@ int load_sequence_image(SDL_Renderer* renderer, Sequence* seq, const char* image
 // Cleanup sequences
 void cleanup_sequences(void) {
     for (int i = 0; i < sequence_count; i++) {
-        if (sequences[i].font) {
-            TTF_CloseFont(sequences[i].font);
-            sequences[i].font = NULL;
-        }
-        // Free image texture if present
-        if (sequences[i].image) {
+        release_sequence_font(sequences[i].font);
+        sequences[i].font = NULL;
+        release_text_label(sequences[i].text_label);
+        sequences[i].text_label = -1;
+        // Free image texture if present (cached scene images are not ours)
+        if (sequences[i].image && !sequences[i].image_shared) {
             SDL_DestroyTexture(sequences[i].image);
-            sequences[i].image = NULL;
         }
+        sequences[i].image = NULL;
+        sequences[i].image_shared = 0;
     }
     sequence_count = 0;
     printf("Sequences cleaned up\n");
@@ -353,53 +465,10 @@ void cleanup_sequences(void) {
 // ROUND SEQUENCE FUNCTIONS
 // =============================================================================
 
-// Helper function to draw filled circle
-static void draw_filled_circle(SDL_Renderer* renderer, int center_x, int center_y, int radius) {
-    for (int w = 0; w < radius * 2; w++) {
-        for (int h = 0; h < radius * 2; h++) {
-            int dx = radius - w;
-            int dy = radius - h;
-            if ((dx*dx + dy*dy) <= (radius * radius)) {
-                SDL_RenderDrawPoint(renderer, center_x + dx, center_y + dy);
-            }
-        }
-    }
-}
-
-// Helper function to draw circle outline
-static void draw_circle_outline(SDL_Renderer* renderer, int center_x, int center_y, int radius, int thickness) {
-    for (int t = 0; t < thickness; t++) {
-        int r = radius - t;
-        int x = r;
-        int y = 0;
-        int err = 0;
-        
-        while (x >= y) {
-            SDL_RenderDrawPoint(renderer, center_x + x, center_y + y);
-            SDL_RenderDrawPoint(renderer, center_x + y, center_y + x);
-            SDL_RenderDrawPoint(renderer, center_x - y, center_y + x);
-            SDL_RenderDrawPoint(renderer, center_x - x, center_y + y);
-            SDL_RenderDrawPoint(renderer, center_x - x, center_y - y);
-            SDL_RenderDrawPoint(renderer, center_x - y, center_y - x);
-            SDL_RenderDrawPoint(renderer, center_x + y, center_y - x);
-            SDL_RenderDrawPoint(renderer, center_x + x, center_y - y);
-            
-            if (err <= 0) {
-                y += 1;
-                err += 2*y + 1;
-            }
-            if (err > 0) {
-                x -= 1;
-                err -= 2*x + 1;
-            }
-        }
-    }
-}
-
 // Initialize round sequences system
 void init_round_sequences(void) {
     round_sequence_count = 0;
-    memset(round_sequences, 0, sizeof(round_sequences));
+    memset(round_sequences, 0, sizeof(RoundSequence) * MAX_ROUND_SEQUENCES);
     printf("Round sequences system initialized\n");
 }
 
@@ -407,8 +476,8 @@ void init_round_sequences(void) {
 int create_round_sequence(int id, const char* name, int center_x, int center_y, 
                           int radius, Color color, const char* text, int font_size, 
                           int filled) {
-    if (round_sequence_count >= 50) {
-        printf("Error: Maximum round sequences limit reached (50)\n");
+    if (round_sequence_count >= MAX_ROUND_SEQUENCES) {
+        printf("Error: Maximum round sequences limit reached (%d)\n", MAX_ROUND_SEQUENCES);
         return -1;
     }
     
@@ -459,19 +528,14 @@ int create_round_sequence(int id, const char* name, int center_x, int center_y,
 
 // Draw a single round sequence
 void draw_round_sequence(SDL_Renderer* renderer, RoundSequence* seq) {
-    if (!seq || !seq->visible) {
+    if (!seq || is_round_sequence_culled(seq)) {
         return;
     }
     
-    // Set color with alpha blending
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, seq->color.r, seq->color.g, seq->color.b, seq->color.a);
-    
     // Draw circle (filled or outline)
-    if (seq->filled) {
-        draw_filled_circle(renderer, seq->center_x, seq->center_y, seq->radius);
-    } else {
-        draw_circle_outline(renderer, seq->center_x, seq->center_y, seq->radius, seq->outline_thickness);
+    if (seq->color.a > 0) {
+        queue_circle(seq->center_x, seq->center_y, seq->radius, seq->color,
+                     seq->filled, seq->outline_thickness);
     }
     
     // Draw text if present
@@ -492,16 +556,16 @@ void draw_round_sequence(SDL_Renderer* renderer, RoundSequence* seq) {
                     text_surface->w,
                     text_surface->h
                 };
-                SDL_RenderCopy(renderer, text_texture, NULL, &text_rect);
-                SDL_DestroyTexture(text_texture);
+                queue_glyph_run(text_texture, NULL, &text_rect, 1);
             }
             SDL_FreeSurface(text_surface);
         }
     }
 }
 
-// Draw all round sequences
+// Draw all round sequences (on their own layer, above regular sequences)
 void draw_all_round_sequences(SDL_Renderer* renderer) {
+    render_queue_set_layer(RENDER_LAYER_ROUND);
     for (int i = 0; i < round_sequence_count; i++) {
         draw_round_sequence(renderer, &round_sequences[i]);
     }
@@ -529,43 +593,55 @@ RoundSequence* get_round_sequence_by_name(const char* name) {
     return NULL;
 }
 
-// Update round sequence text content
+// Update round sequence text content (no-op if the text is unchanged)
 void update_round_sequence_text(RoundSequence* seq, const char* new_text) {
     if (!seq) return;
+    if (strncmp(seq->text_content, new_text, sizeof(seq->text_content) - 1) == 0) return;
     
     strncpy(seq->text_content, new_text, sizeof(seq->text_content) - 1);
     seq->text_content[sizeof(seq->text_content) - 1] = '\0';
+    seq->generation++;
 }
 
 // Update round sequence position
 void update_round_sequence_position(RoundSequence* seq, int center_x, int center_y) {
     if (!seq) return;
+    if (seq->center_x == center_x && seq->center_y == center_y) return;
     
     seq->center_x = center_x;
     seq->center_y = center_y;
+    seq->generation++;
+}
+
+// Update round sequence radius
+void update_round_sequence_radius(RoundSequence* seq, int radius) {
+    if (!seq || seq->radius == radius) return;
+    
+    seq->radius = radius;
+    seq->generation++;
 }
 
 // Update round sequence color
 void update_round_sequence_color(RoundSequence* seq, Color new_color) {
-    if (!seq) return;
+    if (!seq || same_color(seq->color, new_color)) return;
     
     seq->color = new_color;
+    seq->generation++;
 }
 
 // Set round sequence visibility
 void set_round_sequence_visibility(RoundSequence* seq, int visible) {
-    if (!seq) return;
+    if (!seq || seq->visible == visible) return;
     
     seq->visible = visible;
+    seq->generation++;
 }
 
 // Cleanup round sequences
 void cleanup_round_sequences(void) {
     for (int i = 0; i < round_sequence_count; i++) {
-        if (round_sequences[i].font) {
-            TTF_CloseFont(round_sequences[i].font);
-            round_sequences[i].font = NULL;
-        }
+        release_sequence_font(round_sequences[i].font);
+        round_sequences[i].font = NULL;
     }
     round_sequence_count = 0;
     printf("Round sequences cleaned up\n");
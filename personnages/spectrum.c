@@ -0,0 +1,353 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "header.h"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SPECTRUM_USE_SSE 1
+#endif
+
+// =============================================================================
+// SPECTRUM - analysis of the mixed output and the spectrum bar widget
+// =============================================================================
+//
+// A Mix_SetPostMix callback sees every buffer the device is about to play.
+// On the audio thread it measures RMS loudness and runs a radix-2 FFT over
+// the last SPECTRUM_FFT_SIZE samples, folding the bins into a few log-spaced
+// bands. Results go through a triple buffer: the audio thread never waits
+// for the render thread and the render thread always reads a complete set.
+//
+// The callback's own run time is measured against the duration of the
+// buffer it analysed (the callback budget); the target is under 5%.
+
+#define SPECTRUM_FFT_SIZE 1024
+#define SPECTRUM_FFT_BITS 10
+#define SPECTRUM_MIN_HZ 60.0f
+#define SPECTRUM_MAX_HZ 16000.0f
+#define SPECTRUM_FLOOR_DB -60.0f          // Maps to 0, 0 dBFS maps to 1
+#define SPECTRUM_DECAY_PER_SECOND 1.5f    // How fast bars fall back
+#define SPECTRUM_BUDGET_PERCENT 5.0
+
+// FFT tables (built once in start_audio_analysis)
+static float window[SPECTRUM_FFT_SIZE];            // Hann window
+static Uint16 bit_reverse[SPECTRUM_FFT_SIZE];
+static float twiddle_re[SPECTRUM_FFT_SIZE];         // Per stage, stage h at offset h - 1
+static float twiddle_im[SPECTRUM_FFT_SIZE];
+static int band_first_bin[SPECTRUM_BANDS];
+static int band_last_bin[SPECTRUM_BANDS];
+
+// Audio thread working state
+static float history[SPECTRUM_FFT_SIZE];            // Mono samples, circular
+static int history_pos = 0;
+static float fft_re[SPECTRUM_FFT_SIZE];
+static float fft_im[SPECTRUM_FFT_SIZE];
+static AudioAnalysis smoothed;
+
+// Triple buffer: the audio thread owns write_slot, the render thread owns
+// read_slot and the third slot is exchanged through 'middle'
+#define ANALYSIS_FRESH 4
+static AudioAnalysis slots[3];
+static int write_slot = 0;
+static int read_slot = 1;
+static SDL_atomic_t middle;
+
+// Callback cost (audio thread, read after the callback is removed)
+static Uint64 analysis_ticks_total = 0;
+static Uint64 analysis_ticks_max = 0;
+static double budget_seconds_total = 0.0;
+static double worst_budget_ratio = 0.0;
+static int analysis_callbacks = 0;
+static int analysis_running = 0;
+
+// -----------------------------------------------------------------------------
+// FFT
+// -----------------------------------------------------------------------------
+
+static void build_fft_tables(int frequency) {
+    const float pi = 3.14159265358979f;
+
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; i++) {
+        window[i] = 0.5f - 0.5f * cosf(2.0f * pi * i / (SPECTRUM_FFT_SIZE - 1));
+
+        int r = 0;
+        for (int b = 0; b < SPECTRUM_FFT_BITS; b++) {
+            if (i & (1 << b)) r |= 1 << (SPECTRUM_FFT_BITS - 1 - b);
+        }
+        bit_reverse[i] = (Uint16)r;
+    }
+
+    // Stage with half size h uses twiddles e^(-i*pi*k/h), k < h
+    for (int h = 1; h < SPECTRUM_FFT_SIZE; h <<= 1) {
+        for (int k = 0; k < h; k++) {
+            twiddle_re[h - 1 + k] = cosf(-pi * k / h);
+            twiddle_im[h - 1 + k] = sinf(-pi * k / h);
+        }
+    }
+
+    // Log-spaced bands between SPECTRUM_MIN_HZ and SPECTRUM_MAX_HZ
+    float max_hz = SPECTRUM_MAX_HZ < frequency / 2.0f ? SPECTRUM_MAX_HZ : frequency / 2.0f;
+    float bin_hz = (float)frequency / SPECTRUM_FFT_SIZE;
+    for (int b = 0; b < SPECTRUM_BANDS; b++) {
+        float lo = SPECTRUM_MIN_HZ * powf(max_hz / SPECTRUM_MIN_HZ, (float)b / SPECTRUM_BANDS);
+        float hi = SPECTRUM_MIN_HZ * powf(max_hz / SPECTRUM_MIN_HZ, (float)(b + 1) / SPECTRUM_BANDS);
+        int first = (int)(lo / bin_hz);
+        int last = (int)(hi / bin_hz);
+        if (first < 1) first = 1;
+        if (last < first) last = first;
+        if (last > SPECTRUM_FFT_SIZE / 2 - 1) last = SPECTRUM_FFT_SIZE / 2 - 1;
+        band_first_bin[b] = first;
+        band_last_bin[b] = last;
+    }
+}
+
+// In-place iterative FFT of fft_re/fft_im (input already in bit-reversed order)
+static void run_fft(void) {
+    for (int h = 1; h < SPECTRUM_FFT_SIZE; h <<= 1) {
+        const float* wr = &twiddle_re[h - 1];
+        const float* wi = &twiddle_im[h - 1];
+
+        for (int g = 0; g < SPECTRUM_FFT_SIZE; g += 2 * h) {
+            float* ar = &fft_re[g];
+            float* ai = &fft_im[g];
+            float* br = &fft_re[g + h];
+            float* bi = &fft_im[g + h];
+            int k = 0;
+
+#ifdef SPECTRUM_USE_SSE
+            // Four butterflies at a time once a stage is wide enough
+            for (; k + 4 <= h; k += 4) {
+                __m128 w_re = _mm_loadu_ps(wr + k);
+                __m128 w_im = _mm_loadu_ps(wi + k);
+                __m128 b_re = _mm_loadu_ps(br + k);
+                __m128 b_im = _mm_loadu_ps(bi + k);
+                __m128 t_re = _mm_sub_ps(_mm_mul_ps(b_re, w_re), _mm_mul_ps(b_im, w_im));
+                __m128 t_im = _mm_add_ps(_mm_mul_ps(b_re, w_im), _mm_mul_ps(b_im, w_re));
+                __m128 a_re = _mm_loadu_ps(ar + k);
+                __m128 a_im = _mm_loadu_ps(ai + k);
+                _mm_storeu_ps(br + k, _mm_sub_ps(a_re, t_re));
+                _mm_storeu_ps(bi + k, _mm_sub_ps(a_im, t_im));
+                _mm_storeu_ps(ar + k, _mm_add_ps(a_re, t_re));
+                _mm_storeu_ps(ai + k, _mm_add_ps(a_im, t_im));
+            }
+#endif
+            // Scalar butterflies (narrow stages, or no SSE)
+            for (; k < h; k++) {
+                float t_re = br[k] * wr[k] - bi[k] * wi[k];
+                float t_im = br[k] * wi[k] + bi[k] * wr[k];
+                br[k] = ar[k] - t_re;
+                bi[k] = ai[k] - t_im;
+                ar[k] += t_re;
+                ai[k] += t_im;
+            }
+        }
+    }
+}
+
+// Map an amplitude (1 = full scale) to 0..1 on a dB scale
+static float amplitude_to_level(float amplitude) {
+    if (amplitude <= 0.0f) return 0.0f;
+    float level = (20.0f * log10f(amplitude) - SPECTRUM_FLOOR_DB) / -SPECTRUM_FLOOR_DB;
+    if (level < 0.0f) return 0.0f;
+    if (level > 1.0f) return 1.0f;
+    return level;
+}
+
+// Rise instantly, fall back at a fixed rate
+static float smooth_towards(float current, float target, float decay) {
+    if (target >= current) return target;
+    current -= decay;
+    return current > target ? current : target;
+}
+
+// -----------------------------------------------------------------------------
+// Post-mix callback (audio thread)
+// -----------------------------------------------------------------------------
+
+static void analysis_postmix(void* udata, Uint8* stream, int len) {
+    (void)udata;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    const Sint16* samples = (const Sint16*)stream;
+    int frames = len / 4;  // Stereo S16
+    if (frames == 0) return;
+
+    // RMS, peak and mono history
+    float sum_squares = 0.0f;
+    float peak = 0.0f;
+    for (int f = 0; f < frames; f++) {
+        float l = samples[2 * f] / 32768.0f;
+        float r = samples[2 * f + 1] / 32768.0f;
+        sum_squares += l * l + r * r;
+        float m = fabsf(l) > fabsf(r) ? fabsf(l) : fabsf(r);
+        if (m > peak) peak = m;
+
+        history[history_pos] = (l + r) * 0.5f;
+        history_pos = (history_pos + 1) & (SPECTRUM_FFT_SIZE - 1);
+    }
+    float rms = sqrtf(sum_squares / (frames * 2));
+
+    // Windowed samples, oldest first, in bit-reversed order
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; i++) {
+        int j = bit_reverse[i];
+        fft_re[j] = history[(history_pos + i) & (SPECTRUM_FFT_SIZE - 1)] * window[i];
+        fft_im[j] = 0.0f;
+    }
+    run_fft();
+
+    // Strongest bin of each band; a full-scale sine peaks at N/4 with Hann
+    double seconds = (double)frames / audio.frequency;
+    float decay = (float)(SPECTRUM_DECAY_PER_SECOND * seconds);
+    const float scale = 4.0f / SPECTRUM_FFT_SIZE;
+    for (int b = 0; b < SPECTRUM_BANDS; b++) {
+        float best = 0.0f;
+        for (int k = band_first_bin[b]; k <= band_last_bin[b]; k++) {
+            float power = fft_re[k] * fft_re[k] + fft_im[k] * fft_im[k];
+            if (power > best) best = power;
+        }
+        smoothed.bands[b] = smooth_towards(smoothed.bands[b],
+                                           amplitude_to_level(sqrtf(best) * scale), decay);
+    }
+    smoothed.rms = rms;
+    smoothed.peak = peak;
+    smoothed.level = smooth_towards(smoothed.level, amplitude_to_level(rms), decay);
+    smoothed.sequence++;
+
+    // Publish: fill our slot, then swap it with the middle one
+    slots[write_slot] = smoothed;
+    SDL_MemoryBarrierRelease();
+    write_slot = SDL_AtomicSet(&middle, write_slot | ANALYSIS_FRESH) & 3;
+
+    Uint64 ticks = SDL_GetPerformanceCounter() - start;
+    double ratio = (double)ticks / SDL_GetPerformanceFrequency() / seconds;
+    analysis_ticks_total += ticks;
+    if (ticks > analysis_ticks_max) analysis_ticks_max = ticks;
+    if (ratio > worst_budget_ratio) worst_budget_ratio = ratio;
+    budget_seconds_total += seconds;
+    analysis_callbacks++;
+}
+
+// -----------------------------------------------------------------------------
+// Public API (render thread)
+// -----------------------------------------------------------------------------
+
+// Install the analysis callback on the mixed output
+int start_audio_analysis(void) {
+    if (!audio.opened) return -1;
+    if (audio.format != AUDIO_S16SYS || audio.channels != 2) {
+        printf("Error: Audio analysis needs stereo S16 output\n");
+        return -1;
+    }
+
+    build_fft_tables(audio.frequency);
+    memset(slots, 0, sizeof(slots));
+    memset(&smoothed, 0, sizeof(smoothed));
+    write_slot = 0;
+    read_slot = 1;
+    SDL_AtomicSet(&middle, 2);
+
+    Mix_SetPostMix(analysis_postmix, NULL);
+    analysis_running = 1;
+    printf("Audio analysis started (%d-point FFT, %d bands)\n", SPECTRUM_FFT_SIZE, SPECTRUM_BANDS);
+    return 0;
+}
+
+// Latest published analysis (all zero when analysis is not running)
+const AudioAnalysis* get_audio_analysis(void) {
+    if (SDL_AtomicGet(&middle) & ANALYSIS_FRESH) {
+        read_slot = SDL_AtomicSet(&middle, read_slot) & 3;
+        SDL_MemoryBarrierAcquire();
+    }
+    return &slots[read_slot];
+}
+
+// Remove the callback and report its cost against the callback budget
+void stop_audio_analysis(void) {
+    if (!analysis_running) return;
+
+    Mix_SetPostMix(NULL, NULL);
+    analysis_running = 0;
+    if (analysis_callbacks == 0) return;
+
+    double freq = (double)SDL_GetPerformanceFrequency();
+    double avg_percent = analysis_ticks_total / freq / budget_seconds_total * 100.0;
+    printf("Audio analysis: %d callbacks, avg %.3f us, max %.3f us, "
+           "avg %.2f%% / worst %.2f%% of callback budget (target < %.0f%%)\n",
+           analysis_callbacks,
+           analysis_ticks_total / freq * 1e6 / analysis_callbacks,
+           analysis_ticks_max / freq * 1e6,
+           avg_percent, worst_budget_ratio * 100.0, SPECTRUM_BUDGET_PERCENT);
+    if (avg_percent > SPECTRUM_BUDGET_PERCENT) {
+        printf("Warning: Audio analysis is over budget\n");
+    }
+}
+
+// Time the post-mix analysis on a buffer of 'frames' stereo frames (used by
+// the settings auto-tune). Runs the callback on the calling thread, so only
+// while it is not installed; its state is reset afterwards. Returns the
+// microseconds per callback, or -1.
+double time_audio_analysis(Sint16* samples, int frames, int runs) {
+    if (analysis_running || !audio.opened || frames <= 0 || runs <= 0) return -1.0;
+
+    build_fft_tables(audio.frequency);
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < runs; i++) {
+        analysis_postmix(NULL, (Uint8*)samples, frames * 4);
+    }
+    Uint64 ticks = SDL_GetPerformanceCounter() - start;
+
+    memset(history, 0, sizeof(history));
+    history_pos = 0;
+    memset(&smoothed, 0, sizeof(smoothed));
+    analysis_ticks_total = 0;
+    analysis_ticks_max = 0;
+    budget_seconds_total = 0.0;
+    worst_budget_ratio = 0.0;
+    analysis_callbacks = 0;
+    return (double)ticks * 1e6 / (double)SDL_GetPerformanceFrequency() / runs;
+}
+
+// -----------------------------------------------------------------------------
+// Spectrum widget
+// -----------------------------------------------------------------------------
+
+// Turn a sequence into a spectrum bar display
+void set_sequence_spectrum(Sequence* seq, Color bar_color) {
+    if (!seq) return;
+
+    seq->is_spectrum = 1;
+    seq->bar_color = bar_color;
+
+    printf("Spectrum display enabled on sequence '%s'\n", seq->name);
+}
+
+// Draw a spectrum sequence (called by draw_sequence when is_spectrum == 1)
+void draw_spectrum_sequence(SDL_Renderer* renderer, Sequence* seq) {
+    (void)renderer;
+    if (!seq || !seq->visible) return;
+
+    int opacity = seq->world_opacity;
+    SDL_Rect rect = {seq->x, seq->y, seq->w, seq->h};
+
+    if (!(seq->cull_flags & CULL_FILL)) {
+        queue_fill_rect(&rect, create_color(seq->color.r, seq->color.g,
+                                            seq->color.b, seq->color.a * opacity / 255));
+    }
+
+    const AudioAnalysis* analysis = get_audio_analysis();
+    int pad = 2;
+    int inner_h = seq->h - pad * 2;
+    int bar_w = (seq->w - pad * 2) / SPECTRUM_BANDS;
+    if (bar_w < 1 || inner_h < 1) return;
+
+    Color bar = create_color(seq->bar_color.r, seq->bar_color.g, seq->bar_color.b,
+                             seq->bar_color.a * opacity / 255);
+    for (int b = 0; b < SPECTRUM_BANDS; b++) {
+        int bar_h = (int)(analysis->bands[b] * inner_h + 0.5f);
+        if (bar_h <= 0) continue;
+
+        SDL_Rect r = {seq->x + pad + b * bar_w, seq->y + pad + inner_h - bar_h,
+                      bar_w > 2 ? bar_w - 1 : bar_w, bar_h};
+        queue_fill_rect(&r, bar);
+    }
+}
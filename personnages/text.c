@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// TEXT - off-thread text rasterization
+// =============================================================================
+//
+// Widgets no longer call TTF_RenderUTF8_Blended while drawing. Each one owns a
+// label; when its text changes the label queues a job that rasterizes the new
+// string on a worker, using that worker's own copy of the font (SDL_ttf fonts
+// must not be shared between threads). Finished surfaces come back through a
+// small queue and are uploaded on the render thread at the start of the next
+// frame, a few per frame. Until then the label keeps drawing its previous
+// texture, so a burst of text changes never stalls a frame.
+//
+// Text is rendered white and tinted by the render queue, which lets a shadow
+// and its text share one texture and makes color / opacity changes free.
+// Textures come from the streaming texture pool (texture_pool.c): new text is
+// written into the label's texture when it still fits its size class.
+// A label has at most one job in flight: text that changes again meanwhile is
+// picked up when the running job comes back.
+
+static TextFont fonts[TEXT_MAX_FONTS];
+static int font_count = 0;
+static TextLabel labels[TEXT_MAX_LABELS];
+
+// Labels whose job has finished, in completion order (filled by workers)
+static int completed[TEXT_MAX_LABELS];
+static int completed_head = 0;
+static int completed_tail = 0;
+static SDL_SpinLock completed_lock = 0;
+static JobCounter text_counter;
+
+// Statistics
+static int in_flight_count = 0;
+static int upload_count = 0;
+static int stale_count = 0;
+
+// Find or open a font for every job worker. Returns the font index, or -1.
+static int get_text_font(const char* path, int size) {
+    for (int i = 0; i < font_count; i++) {
+        if (fonts[i].size == size && strcmp(fonts[i].path, path) == 0) return i;
+    }
+    if (font_count >= TEXT_MAX_FONTS) {
+        printf("Error: Maximum text fonts limit reached (%d)\n", TEXT_MAX_FONTS);
+        return -1;
+    }
+
+    // Opened here on the main thread: FreeType faces may be used from
+    // different threads, but not created concurrently
+    TextFont* font = &fonts[font_count];
+    memset(font, 0, sizeof(*font));
+    int workers = get_job_worker_count();
+    for (int i = 0; i < workers; i++) {
+        font->instances[i] = TTF_OpenFont(path, size);
+        if (!font->instances[i]) {
+            printf("Failed to load font '%s': %s\n", path, TTF_GetError());
+            for (int j = 0; j < i; j++) TTF_CloseFont(font->instances[j]);
+            return -1;
+        }
+    }
+    strncpy(font->path, path, sizeof(font->path) - 1);
+    font->size = size;
+    font->instance_count = workers;
+    return font_count++;
+}
+
+// Worker side: rasterize the job text and hand the label back
+static void rasterize_label(void* data) {
+    TextLabel* label = (TextLabel*)data;
+    TextFont* font = &fonts[label->font];
+
+    // Threads started after the font was opened fall back to the first copy
+    int worker = get_job_worker_index();
+    if (worker >= font->instance_count) worker = 0;
+
+    label->job_surface = TTF_RenderUTF8_Blended(font->instances[worker], label->job_text,
+                                                (SDL_Color){255, 255, 255, 255});
+
+    SDL_AtomicLock(&completed_lock);
+    completed[completed_tail % TEXT_MAX_LABELS] = (int)(label - labels);
+    completed_tail++;
+    SDL_AtomicUnlock(&completed_lock);
+}
+
+static void submit_label(TextLabel* label) {
+    strcpy(label->job_text, label->text);
+    label->job_generation = label->generation;
+    label->job_surface = NULL;
+    label->in_flight = 1;
+    in_flight_count++;
+
+    Job job = {rasterize_label, label, NULL};
+    run_jobs(&job, 1, &text_counter);
+}
+
+// Create a label drawn with the given font. Returns the label index, or -1.
+int create_text_label(const char* font_path, int font_size) {
+    int font = get_text_font(font_path, font_size);
+    if (font < 0) return -1;
+
+    for (int i = 0; i < TEXT_MAX_LABELS; i++) {
+        TextLabel* label = &labels[i];
+        if (label->active || label->in_flight) continue;
+        memset(label, 0, sizeof(*label));
+        label->active = 1;
+        label->font = font;
+        return i;
+    }
+    printf("Error: Maximum text labels limit reached (%d)\n", TEXT_MAX_LABELS);
+    return -1;
+}
+
+// Change the text of a label. Rasterization happens in the background; the
+// previous text stays on screen until the new one is uploaded.
+void set_text_label(int label, const char* text) {
+    if (label < 0 || label >= TEXT_MAX_LABELS || !labels[label].active) return;
+
+    TextLabel* l = &labels[label];
+    if (strcmp(l->text, text) == 0) return;
+    strncpy(l->text, text, sizeof(l->text) - 1);
+    l->text[sizeof(l->text) - 1] = '\0';
+    l->generation++;
+
+    // Nothing to rasterize: empty text disappears right away
+    if (l->text[0] == '\0') {
+        release_pooled_texture(l->texture);
+        l->texture = NULL;
+        l->w = l->h = 0;
+        l->shown_generation = l->generation;
+        return;
+    }
+    if (!l->in_flight) submit_label(l);
+}
+
+// Current texture of a label (NULL until its first text is ready)
+SDL_Texture* get_text_label_texture(int label, int* w, int* h) {
+    if (label < 0 || label >= TEXT_MAX_LABELS || !labels[label].active) return NULL;
+    if (w) *w = labels[label].w;
+    if (h) *h = labels[label].h;
+    return labels[label].texture;
+}
+
+// Generation of the latest text requested for a label (0 if none)
+Uint32 get_text_label_generation(int label) {
+    if (label < 0 || label >= TEXT_MAX_LABELS || !labels[label].active) return 0;
+    return labels[label].generation;
+}
+
+// Whether the text of 'generation' (or a later one) has been uploaded. A
+// freed label has nothing left to show and counts as shown.
+int is_text_label_shown(int label, Uint32 generation) {
+    if (label < 0 || label >= TEXT_MAX_LABELS || !labels[label].active) return 1;
+    return (Sint32)(labels[label].shown_generation - generation) >= 0;
+}
+
+// Free a label. A running job keeps the slot until it comes back.
+void release_text_label(int label) {
+    if (label < 0 || label >= TEXT_MAX_LABELS || !labels[label].active) return;
+
+    TextLabel* l = &labels[label];
+    release_pooled_texture(l->texture);
+    l->texture = NULL;
+    l->active = 0;
+    l->released = l->in_flight;
+}
+
+// Pop one finished label (-1 if none)
+static int pop_completed(void) {
+    int label = -1;
+    SDL_AtomicLock(&completed_lock);
+    if (completed_head != completed_tail) {
+        label = completed[completed_head % TEXT_MAX_LABELS];
+        completed_head++;
+    }
+    SDL_AtomicUnlock(&completed_lock);
+    return label;
+}
+
+// Upload finished rasterizations (render thread, once per frame before drawing)
+void update_text_labels(SDL_Renderer* renderer) {
+    for (int uploads = 0; uploads < TEXT_UPLOADS_PER_FRAME; ) {
+        int index = pop_completed();
+        if (index < 0) break;
+
+        TextLabel* l = &labels[index];
+        SDL_Surface* surface = l->job_surface;
+        l->job_surface = NULL;
+        l->in_flight = 0;
+        in_flight_count--;
+
+        if (l->released || !l->active) {
+            l->released = 0;
+        } else if (l->job_generation != l->generation) {
+            // The text changed while this job ran: start over with the latest
+            stale_count++;
+            if (l->text[0] != '\0') submit_label(l);
+        } else {
+            // Written in place when the text still fits the label's texture.
+            // A failed rasterization is final for this text as well.
+            SDL_Texture* texture = surface ? upload_pooled_texture(renderer, l->texture, surface) : NULL;
+            if (texture) {
+                l->texture = texture;
+                l->w = surface->w;
+                l->h = surface->h;
+                upload_count++;
+                uploads++;
+            }
+            l->shown_generation = l->job_generation;
+        }
+        if (surface) SDL_FreeSurface(surface);
+    }
+}
+
+// Jobs in flight, textures uploaded and results dropped as stale so far
+void get_text_stats(int* in_flight, int* uploads, int* stale) {
+    if (in_flight) *in_flight = in_flight_count;
+    if (uploads) *uploads = upload_count;
+    if (stale) *stale = stale_count;
+}
+
+// Wait for running jobs, then return every texture and free the fonts.
+// Must run before shutdown_job_system(), which drops queued jobs.
+void cleanup_text(void) {
+    wait_for_counter(&text_counter);
+
+    int index;
+    while ((index = pop_completed()) >= 0) {
+        if (labels[index].job_surface) SDL_FreeSurface(labels[index].job_surface);
+    }
+    for (int i = 0; i < TEXT_MAX_LABELS; i++) {
+        release_pooled_texture(labels[i].texture);
+    }
+    for (int i = 0; i < font_count; i++) {
+        for (int j = 0; j < fonts[i].instance_count; j++) {
+            TTF_CloseFont(fonts[i].instances[j]);
+        }
+    }
+    memset(labels, 0, sizeof(labels));
+    memset(fonts, 0, sizeof(fonts));
+    font_count = 0;
+    completed_head = completed_tail = 0;
+    in_flight_count = 0;
+}
@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// =============================================================================
+// TEXTURE POOL - reusable streaming textures bucketed by size class
+// =============================================================================
+//
+// Text labels change often (input fields, counters). Instead of creating and
+// destroying a texture for every change, labels borrow a streaming texture
+// whose size is the next power of two of their content (a size class), write
+// the new pixels into it with SDL_LockTexture and draw only the used corner.
+// A label keeps its texture as long as the text stays in the same class; a
+// texture that is given back goes to the free list of its class and is handed
+// to the next label that needs that class. Free textures are only destroyed
+// when the pool needs the slot for another class, or when the memory of the
+// pool goes over its budget (the text cache budget of the settings).
+
+static PooledTexture pool[TEXTURE_POOL_MAX];
+static TexturePoolStats stats;
+static size_t budget = 0;      // 0 = unlimited
+
+// Size class of one dimension: next power of two, at least 'minimum'
+static int size_class(int size, int minimum) {
+    int c = minimum;
+    while (c < size) c <<= 1;
+    return c;
+}
+
+static PooledTexture* find_entry(SDL_Texture* texture) {
+    if (!texture) return NULL;
+    for (int i = 0; i < TEXTURE_POOL_MAX; i++) {
+        if (pool[i].texture == texture) return &pool[i];
+    }
+    return NULL;
+}
+
+// Borrow a streaming texture of at least w x h. Returns NULL on failure.
+SDL_Texture* acquire_pooled_texture(SDL_Renderer* renderer, int w, int h) {
+    int cw = size_class(w, TEXTURE_POOL_MIN_WIDTH);
+    int ch = size_class(h, TEXTURE_POOL_MIN_HEIGHT);
+
+    PooledTexture* empty = NULL;
+    PooledTexture* victim = NULL;
+    for (int i = 0; i < TEXTURE_POOL_MAX; i++) {
+        PooledTexture* entry = &pool[i];
+        if (!entry->texture) {
+            if (!empty) empty = entry;
+            continue;
+        }
+        if (entry->in_use) continue;
+        if (entry->w == cw && entry->h == ch) {
+            entry->in_use = 1;
+            stats.in_use++;
+            stats.hits++;
+            return entry->texture;
+        }
+        // Oldest free texture of another class, if a slot has to be recycled
+        if (!victim || entry->released_at < victim->released_at) victim = entry;
+    }
+
+    PooledTexture* slot = empty ? empty : victim;
+    if (!slot) {
+        printf("Error: Texture pool exhausted (%d textures in use)\n", TEXTURE_POOL_MAX);
+        return NULL;
+    }
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_STREAMING, cw, ch);
+    if (!texture) {
+        printf("Failed to create pooled texture: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    if (slot->texture) {
+        SDL_DestroyTexture(slot->texture);
+        stats.bytes -= (size_t)slot->w * slot->h * 4;
+        stats.evictions++;
+    }
+    slot->texture = texture;
+    slot->w = cw;
+    slot->h = ch;
+    slot->in_use = 1;
+
+    stats.misses++;
+    stats.in_use++;
+    stats.bytes += (size_t)cw * ch * 4;
+    if (stats.bytes > stats.peak_bytes) stats.peak_bytes = stats.bytes;
+    return texture;
+}
+
+// Destroy the oldest free textures while the pool is over its budget
+static void trim_to_budget(void) {
+    while (budget > 0 && stats.bytes > budget) {
+        PooledTexture* victim = NULL;
+        for (int i = 0; i < TEXTURE_POOL_MAX; i++) {
+            PooledTexture* entry = &pool[i];
+            if (!entry->texture || entry->in_use) continue;
+            if (!victim || entry->released_at < victim->released_at) victim = entry;
+        }
+        if (!victim) return;   // Everything left is in use
+
+        SDL_DestroyTexture(victim->texture);
+        stats.bytes -= (size_t)victim->w * victim->h * 4;
+        stats.evictions++;
+        memset(victim, 0, sizeof(*victim));
+    }
+}
+
+// Give a texture back to its class (it stays allocated for the next user
+// unless the pool is over budget)
+void release_pooled_texture(SDL_Texture* texture) {
+    PooledTexture* entry = find_entry(texture);
+    if (!entry || !entry->in_use) return;
+    entry->in_use = 0;
+    entry->released_at = ++stats.releases;
+    stats.in_use--;
+    trim_to_budget();
+}
+
+// Memory the free textures may keep allocated (0 = unlimited). Textures in
+// use are never destroyed, so the pool can go over while labels need them.
+void set_texture_pool_budget(size_t bytes) {
+    budget = bytes;
+    trim_to_budget();
+}
+
+// Write a surface into the top-left corner of a pooled texture. 'current'
+// (may be NULL) is reused if the surface has the same size class, otherwise
+// it is released and another texture is borrowed. On failure 'current' is
+// left as it was and NULL is returned.
+SDL_Texture* upload_pooled_texture(SDL_Renderer* renderer, SDL_Texture* current,
+                                   const SDL_Surface* surface) {
+    int cw = size_class(surface->w, TEXTURE_POOL_MIN_WIDTH);
+    int ch = size_class(surface->h, TEXTURE_POOL_MIN_HEIGHT);
+
+    PooledTexture* entry = find_entry(current);
+    SDL_Texture* texture = current;
+    if (!entry || entry->w != cw || entry->h != ch) {
+        texture = acquire_pooled_texture(renderer, surface->w, surface->h);
+        if (!texture) return NULL;
+    } else {
+        stats.hits++;
+    }
+
+    SDL_Rect rect = {0, 0, surface->w, surface->h};
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(texture, &rect, &pixels, &pitch) != 0) {
+        printf("Failed to lock pooled texture: %s\n", SDL_GetError());
+        if (texture != current) release_pooled_texture(texture);
+        return NULL;
+    }
+    SDL_ConvertPixels(surface->w, surface->h, surface->format->format, surface->pixels,
+                      surface->pitch, SDL_PIXELFORMAT_ARGB8888, pixels, pitch);
+    SDL_UnlockTexture(texture);
+    stats.uploads++;
+
+    if (texture != current) release_pooled_texture(current);
+    return texture;
+}
+
+TexturePoolStats get_texture_pool_stats(void) {
+    return stats;
+}
+
+void print_texture_pool_stats(void) {
+    int requests = stats.hits + stats.misses;
+    printf("\n=== TEXTURE POOL STATS ===\n");
+    printf("Requests: %d (%d reused, %d created, hit rate %.1f%%), %d evictions\n",
+           requests, stats.hits, stats.misses,
+           requests > 0 ? 100.0 * stats.hits / requests : 0.0, stats.evictions);
+    printf("Uploads: %d | in use: %d | memory: %.1f KB (peak %.1f KB, budget %.0f KB)\n",
+           stats.uploads, stats.in_use, stats.bytes / 1024.0, stats.peak_bytes / 1024.0,
+           budget / 1024.0);
+    printf("==========================\n");
+}
+
+// Destroy every pooled texture (after the labels using them are gone)
+void cleanup_texture_pool(void) {
+    for (int i = 0; i < TEXTURE_POOL_MAX; i++) {
+        if (pool[i].texture) SDL_DestroyTexture(pool[i].texture);
+    }
+    memset(pool, 0, sizeof(pool));
+    memset(&stats, 0, sizeof(stats));
+}
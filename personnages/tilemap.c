@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "header.h"
+
+// =============================================================================
+// TILEMAP - large tile maps drawn from cached chunk textures
+// =============================================================================
+//
+// The map is split into chunks of TILEMAP_CHUNK_TILES x TILEMAP_CHUNK_TILES
+// tiles. A visible chunk is baked once into a render-target texture and then
+// drawn with a single copy, so a full screen costs about a dozen copies
+// instead of one per tile. Editing a tile bumps the version of its chunk and
+// the chunk is re-baked the next time it is drawn. Chunks that scroll away
+// stay cached until their slot is needed (least recently used first).
+
+// Global tilemap instance
+Tilemap tilemap;
+
+// Build a placeholder tileset: 16 colored, outlined squares
+static SDL_Texture* create_default_tileset(SDL_Renderer* renderer, int tile_size) {
+    const int count = 16;
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_TARGET, tile_size * count, tile_size);
+    if (!texture) return NULL;
+
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, texture);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    for (int i = 0; i < count; i++) {
+        SDL_Rect r = {i * tile_size, 0, tile_size, tile_size};
+        SDL_SetRenderDrawColor(renderer, (Uint8)(40 + i * 13), (Uint8)(90 + (i * 37) % 120),
+                               (Uint8)(160 - i * 7), 255);
+        SDL_RenderFillRect(renderer, &r);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderDrawRect(renderer, &r);
+    }
+    SDL_SetRenderTarget(renderer, previous);
+    return texture;
+}
+
+// Create an empty map of width x height tiles.
+// tileset_path = NULL uses a generated placeholder tileset.
+int init_tilemap(SDL_Renderer* renderer, const char* tileset_path, int tile_size,
+                 int width, int height) {
+    cleanup_tilemap();
+    if (tile_size <= 0 || width <= 0 || height <= 0) return -1;
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) != 0 || !(info.flags & SDL_RENDERER_TARGETTEXTURE)) {
+        printf("Error: Renderer does not support render targets, tilemap unavailable\n");
+        return -1;
+    }
+
+    if (tileset_path) {
+        tilemap.tileset = IMG_LoadTexture(renderer, tileset_path);
+        if (!tilemap.tileset) {
+            printf("Failed to load tileset '%s': %s\n", tileset_path, IMG_GetError());
+            return -1;
+        }
+    } else {
+        tilemap.tileset = create_default_tileset(renderer, tile_size);
+        if (!tilemap.tileset) {
+            printf("Failed to create tileset: %s\n", SDL_GetError());
+            return -1;
+        }
+    }
+    int tileset_w = 0;
+    SDL_QueryTexture(tilemap.tileset, NULL, NULL, &tileset_w, NULL);
+    tilemap.tileset_cols = tileset_w / tile_size;
+
+    tilemap.tile_size = tile_size;
+    tilemap.width = width;
+    tilemap.height = height;
+    tilemap.chunk_cols = (width + TILEMAP_CHUNK_TILES - 1) / TILEMAP_CHUNK_TILES;
+    tilemap.chunk_rows = (height + TILEMAP_CHUNK_TILES - 1) / TILEMAP_CHUNK_TILES;
+
+    tilemap.tiles = SDL_calloc((size_t)width * height, sizeof(Uint16));
+    tilemap.chunk_versions = SDL_malloc(sizeof(Uint32) * tilemap.chunk_cols * tilemap.chunk_rows);
+    if (!tilemap.tiles || !tilemap.chunk_versions) {
+        printf("Error: Out of memory for a %dx%d tilemap\n", width, height);
+        cleanup_tilemap();
+        return -1;
+    }
+    for (int i = 0; i < tilemap.chunk_cols * tilemap.chunk_rows; i++) {
+        tilemap.chunk_versions[i] = 1;  // Cached chunks start at 0 (never baked)
+    }
+    for (int i = 0; i < TILEMAP_CHUNK_CACHE; i++) {
+        tilemap.cache[i].chunk_x = -1;
+        tilemap.cache[i].chunk_y = -1;
+    }
+
+    printf("Tilemap created: %dx%d tiles of %dpx (%dx%d chunks)\n",
+           width, height, tile_size, tilemap.chunk_cols, tilemap.chunk_rows);
+    return 0;
+}
+
+// Change one tile (0 = empty, n = tileset tile n - 1) and mark its chunk dirty
+void set_tilemap_tile(int x, int y, Uint16 tile) {
+    if (!tilemap.tiles || x < 0 || y < 0 || x >= tilemap.width || y >= tilemap.height) return;
+
+    Uint16* slot = &tilemap.tiles[(size_t)y * tilemap.width + x];
+    if (*slot == tile) return;
+    *slot = tile;
+    tilemap.chunk_versions[(y / TILEMAP_CHUNK_TILES) * tilemap.chunk_cols + x / TILEMAP_CHUNK_TILES]++;
+}
+
+// Read one tile (0 outside the map)
+Uint16 get_tilemap_tile(int x, int y) {
+    if (!tilemap.tiles || x < 0 || y < 0 || x >= tilemap.width || y >= tilemap.height) return 0;
+    return tilemap.tiles[(size_t)y * tilemap.width + x];
+}
+
+// Top-left corner of the view in map pixels
+void set_tilemap_camera(float x, float y) {
+    tilemap.camera_x = x;
+    tilemap.camera_y = y;
+}
+
+// Source rect of a tile in the tileset
+static SDL_Rect tile_source(Uint16 tile) {
+    int index = tile - 1;
+    return (SDL_Rect){(index % tilemap.tileset_cols) * tilemap.tile_size,
+                      (index / tilemap.tileset_cols) * tilemap.tile_size,
+                      tilemap.tile_size, tilemap.tile_size};
+}
+
+// Render every tile of a chunk into its texture
+static void bake_chunk(SDL_Renderer* renderer, TilemapChunk* chunk) {
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, chunk->texture);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    int tx0 = chunk->chunk_x * TILEMAP_CHUNK_TILES;
+    int ty0 = chunk->chunk_y * TILEMAP_CHUNK_TILES;
+    for (int y = 0; y < TILEMAP_CHUNK_TILES && ty0 + y < tilemap.height; y++) {
+        const Uint16* row = &tilemap.tiles[(size_t)(ty0 + y) * tilemap.width];
+        for (int x = 0; x < TILEMAP_CHUNK_TILES && tx0 + x < tilemap.width; x++) {
+            Uint16 tile = row[tx0 + x];
+            if (tile == 0) continue;
+            SDL_Rect src = tile_source(tile);
+            SDL_Rect dest = {x * tilemap.tile_size, y * tilemap.tile_size,
+                             tilemap.tile_size, tilemap.tile_size};
+            SDL_RenderCopy(renderer, tilemap.tileset, &src, &dest);
+        }
+    }
+
+    SDL_SetRenderTarget(renderer, previous);
+    tilemap.chunk_bakes++;
+}
+
+// Find a chunk in the cache, baking it (into a free or least recently used
+// slot) when missing or out of date. Returns NULL if it cannot be cached.
+static TilemapChunk* get_chunk(SDL_Renderer* renderer, int chunk_x, int chunk_y) {
+    Uint32 version = tilemap.chunk_versions[chunk_y * tilemap.chunk_cols + chunk_x];
+    TilemapChunk* victim = NULL;
+
+    for (int i = 0; i < TILEMAP_CHUNK_CACHE; i++) {
+        TilemapChunk* chunk = &tilemap.cache[i];
+        if (chunk->chunk_x == chunk_x && chunk->chunk_y == chunk_y) {
+            if (chunk->version != version) {
+                bake_chunk(renderer, chunk);
+                chunk->version = version;
+            }
+            chunk->last_used = tilemap.frame;
+            return chunk;
+        }
+        // Prefer a free slot, otherwise the least recently used chunk
+        if (chunk->chunk_x < 0) {
+            if (!victim || victim->chunk_x >= 0) victim = chunk;
+        } else if (!victim || (victim->chunk_x >= 0 && chunk->last_used < victim->last_used)) {
+            victim = chunk;
+        }
+    }
+
+    // Every slot is already on screen this frame: the cache is too small
+    if (victim->chunk_x >= 0 && victim->last_used == tilemap.frame) return NULL;
+
+    if (!victim->texture) {
+        int size = TILEMAP_CHUNK_TILES * tilemap.tile_size;
+        victim->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_TARGET, size, size);
+        if (!victim->texture) {
+            printf("Failed to create chunk texture: %s\n", SDL_GetError());
+            return NULL;
+        }
+        SDL_SetTextureBlendMode(victim->texture, SDL_BLENDMODE_BLEND);
+    }
+
+    if (victim->chunk_x >= 0) tilemap.chunk_evictions++;
+    victim->chunk_x = chunk_x;
+    victim->chunk_y = chunk_y;
+    bake_chunk(renderer, victim);
+    victim->version = version;
+    victim->last_used = tilemap.frame;
+    return victim;
+}
+
+// Range of chunks (or tiles, for cell_size = tile size) covering the screen
+static void visible_range(int cell_size, int count_x, int count_y,
+                          int* x0, int* y0, int* x1, int* y1) {
+    *x0 = (int)floorf(tilemap.camera_x / cell_size);
+    *y0 = (int)floorf(tilemap.camera_y / cell_size);
+    *x1 = (int)floorf((tilemap.camera_x + SCREEN_WIDTH - 1) / cell_size);
+    *y1 = (int)floorf((tilemap.camera_y + SCREEN_HEIGHT - 1) / cell_size);
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 > count_x - 1) *x1 = count_x - 1;
+    if (*y1 > count_y - 1) *y1 = count_y - 1;
+}
+
+// Queue the visible chunks (one texture copy each)
+void draw_tilemap(SDL_Renderer* renderer) {
+    if (!tilemap.tiles) return;
+
+    tilemap.frame++;
+    int chunk_px = TILEMAP_CHUNK_TILES * tilemap.tile_size;
+    int cam_x = (int)floorf(tilemap.camera_x);
+    int cam_y = (int)floorf(tilemap.camera_y);
+
+    int cx0, cy0, cx1, cy1;
+    visible_range(chunk_px, tilemap.chunk_cols, tilemap.chunk_rows, &cx0, &cy0, &cx1, &cy1);
+
+    render_queue_set_layer(RENDER_LAYER_BACKGROUND);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            TilemapChunk* chunk = get_chunk(renderer, cx, cy);
+            if (!chunk) continue;
+            SDL_Rect dest = {cx * chunk_px - cam_x, cy * chunk_px - cam_y, chunk_px, chunk_px};
+            queue_texture(chunk->texture, NULL, &dest, 255);
+            tilemap.chunks_drawn++;
+        }
+    }
+}
+
+// Queue every visible tile individually (no chunk cache). Reference path
+// for the benchmark.
+void draw_tilemap_direct(SDL_Renderer* renderer) {
+    (void)renderer;
+    if (!tilemap.tiles) return;
+
+    int cam_x = (int)floorf(tilemap.camera_x);
+    int cam_y = (int)floorf(tilemap.camera_y);
+    int tx0, ty0, tx1, ty1;
+    visible_range(tilemap.tile_size, tilemap.width, tilemap.height, &tx0, &ty0, &tx1, &ty1);
+
+    render_queue_set_layer(RENDER_LAYER_BACKGROUND);
+    for (int y = ty0; y <= ty1; y++) {
+        for (int x = tx0; x <= tx1; x++) {
+            Uint16 tile = tilemap.tiles[(size_t)y * tilemap.width + x];
+            if (tile == 0) continue;
+            SDL_Rect src = tile_source(tile);
+            SDL_Rect dest = {x * tilemap.tile_size - cam_x, y * tilemap.tile_size - cam_y,
+                             tilemap.tile_size, tilemap.tile_size};
+            queue_texture(tilemap.tileset, &src, &dest, 255);
+        }
+    }
+}
+
+// Forget every baked chunk (render target contents are lost when the
+// renderer resets its targets)
+void invalidate_tilemap_cache(void) {
+    for (int i = 0; i < TILEMAP_CHUNK_CACHE; i++) {
+        tilemap.cache[i].version = 0;
+    }
+}
+
+// Print chunk cache statistics
+void print_tilemap_stats(void) {
+    if (tilemap.frame == 0) return;
+    printf("Tilemap: avg %.1f chunks drawn per frame, %d bakes, %d evictions over %u frames\n",
+           (double)tilemap.chunks_drawn / tilemap.frame, tilemap.chunk_bakes,
+           tilemap.chunk_evictions, tilemap.frame);
+}
+
+// Free the map, its tileset and every chunk texture
+void cleanup_tilemap(void) {
+    for (int i = 0; i < TILEMAP_CHUNK_CACHE; i++) {
+        if (tilemap.cache[i].texture) {
+            SDL_DestroyTexture(tilemap.cache[i].texture);
+        }
+    }
+    if (tilemap.tileset) SDL_DestroyTexture(tilemap.tileset);
+    SDL_free(tilemap.tiles);
+    SDL_free(tilemap.chunk_versions);
+    memset(&tilemap, 0, sizeof(tilemap));
+}
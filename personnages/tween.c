@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <math.h>
+#include "header.h"
+
+// =============================================================================
+// TWEENS - eased property animation for sequences and round sequences
+// =============================================================================
+//
+// Active tweens are packed at the front of structure-of-arrays storage, so
+// the per-frame work is a few straight loops over float arrays (clock,
+// easing, interpolation) followed by one pass writing the values back
+// through the usual setters, which mark the elements dirty. A finished tween
+// is swap-removed: the last active tween moves into its place, and its slot
+// goes back on the free list. Callers hold handles (slot + generation), which
+// stay valid while tweens move around in the packed arrays.
+
+#define TWEEN_CHANNELS 4
+#define TWEEN_PARALLEL_BATCH 1024      // Smallest slice handed to another worker
+
+// Packed tween data (indices 0 .. tween_count - 1 are active)
+static float tw_elapsed[TWEEN_MAX];
+static float tw_inv_duration[TWEEN_MAX];
+static float tw_progress[TWEEN_MAX];          // Normalized time, then eased
+static float tw_from[TWEEN_CHANNELS][TWEEN_MAX];
+static float tw_delta[TWEEN_CHANNELS][TWEEN_MAX];
+static float tw_value[TWEEN_CHANNELS][TWEEN_MAX];
+static Uint8 tw_ease[TWEEN_MAX];
+static Uint8 tw_property[TWEEN_MAX];
+static Uint8 tw_ping_pong[TWEEN_MAX];
+static Sequence* tw_sequence[TWEEN_MAX];
+static RoundSequence* tw_round[TWEEN_MAX];
+static int tw_slot[TWEEN_MAX];                // Handle slot of each packed tween
+static int tween_count = 0;
+
+// Handle slots
+static int slot_index[TWEEN_MAX];             // Packed index of a slot (-1 = free)
+static Uint16 slot_generation[TWEEN_MAX];
+static int free_slots[TWEEN_MAX];
+static int free_slot_count = -1;              // -1 = slots not initialized yet
+
+static void init_slots(void) {
+    for (int i = 0; i < TWEEN_MAX; i++) {
+        slot_index[i] = -1;
+        free_slots[i] = TWEEN_MAX - 1 - i;
+    }
+    free_slot_count = TWEEN_MAX;
+}
+
+// -----------------------------------------------------------------------------
+// Easing curves (t in [0, 1])
+// -----------------------------------------------------------------------------
+
+static float ease(int type, float t) {
+    switch (type) {
+        case EASE_IN_QUAD:
+            return t * t;
+        case EASE_OUT_QUAD:
+            return t * (2.0f - t);
+        case EASE_IN_OUT_QUAD:
+            return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+        case EASE_OUT_CUBIC: {
+            float u = t - 1.0f;
+            return u * u * u + 1.0f;
+        }
+        case EASE_IN_OUT_SINE:
+            return 0.5f - 0.5f * cosf(t * 3.14159265f);
+        case EASE_OUT_BACK: {
+            const float s = 1.70158f;
+            float u = t - 1.0f;
+            return u * u * ((s + 1.0f) * u + s) + 1.0f;
+        }
+        default:
+            return t;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Starting and stopping tweens
+// -----------------------------------------------------------------------------
+
+static int make_handle(int slot) {
+    return (slot_generation[slot] << 16) | slot;
+}
+
+// Packed index of a handle, or -1 if it is stale
+static int handle_index(int tween) {
+    if (tween < 0 || free_slot_count < 0) return -1;
+    int slot = tween & 0xFFFF;
+    if (slot >= TWEEN_MAX || slot_generation[slot] != (Uint16)(tween >> 16)) return -1;
+    return slot_index[slot];
+}
+
+// Swap-remove a packed tween and recycle its slot
+static void remove_tween(int i) {
+    int slot = tw_slot[i];
+    slot_index[slot] = -1;
+    slot_generation[slot]++;
+    free_slots[free_slot_count++] = slot;
+
+    int last = --tween_count;
+    if (i == last) return;
+
+    tw_elapsed[i] = tw_elapsed[last];
+    tw_inv_duration[i] = tw_inv_duration[last];
+    tw_progress[i] = tw_progress[last];
+    for (int c = 0; c < TWEEN_CHANNELS; c++) {
+        tw_from[c][i] = tw_from[c][last];
+        tw_delta[c][i] = tw_delta[c][last];
+        tw_value[c][i] = tw_value[c][last];
+    }
+    tw_ease[i] = tw_ease[last];
+    tw_property[i] = tw_property[last];
+    tw_ping_pong[i] = tw_ping_pong[last];
+    tw_sequence[i] = tw_sequence[last];
+    tw_round[i] = tw_round[last];
+    tw_slot[i] = tw_slot[last];
+    slot_index[tw_slot[i]] = i;
+}
+
+// Current value of a property, as floats
+static void read_property(Sequence* seq, RoundSequence* round, int property, float out[4]) {
+    Color color = seq ? seq->color : round->color;
+    out[0] = out[1] = out[2] = out[3] = 0.0f;
+
+    switch (property) {
+        case TWEEN_POSITION:
+            out[0] = seq ? seq->local_x : round->center_x;
+            out[1] = seq ? seq->local_y : round->center_y;
+            break;
+        case TWEEN_SIZE:
+            out[0] = seq ? seq->w : round->radius * 2;
+            out[1] = seq ? seq->h : round->radius * 2;
+            break;
+        case TWEEN_COLOR:
+            out[0] = color.r;
+            out[1] = color.g;
+            out[2] = color.b;
+            out[3] = color.a;
+            break;
+        case TWEEN_ALPHA:
+            out[0] = seq ? seq->opacity : color.a;
+            break;
+        case TWEEN_RADIUS:
+            out[0] = seq ? 0.0f : round->radius;
+            break;
+    }
+}
+
+static int start_tween(Sequence* seq, RoundSequence* round, TweenProperty property,
+                       const float to[4], float seconds, EaseType easing) {
+    if (free_slot_count < 0) init_slots();
+    if ((!seq && !round) || (seq && property == TWEEN_RADIUS)) return -1;
+
+    // A new tween replaces the one already driving the same property
+    int i;
+    for (i = 0; i < tween_count; i++) {
+        if (tw_sequence[i] == seq && tw_round[i] == round && tw_property[i] == property) break;
+    }
+    if (i == tween_count) {
+        if (free_slot_count == 0) {
+            printf("Error: Maximum tweens limit reached (%d)\n", TWEEN_MAX);
+            return -1;
+        }
+        int slot = free_slots[--free_slot_count];
+        slot_index[slot] = i;
+        tw_slot[i] = slot;
+        tween_count++;
+    }
+
+    float from[4];
+    read_property(seq, round, property, from);
+
+    tw_elapsed[i] = 0.0f;
+    tw_inv_duration[i] = seconds > 0.0f ? 1.0f / seconds : 1e9f;
+    tw_progress[i] = 0.0f;
+    for (int c = 0; c < TWEEN_CHANNELS; c++) {
+        tw_from[c][i] = from[c];
+        tw_delta[c][i] = to[c] - from[c];
+        tw_value[c][i] = from[c];
+    }
+    tw_ease[i] = (Uint8)easing;
+    tw_property[i] = (Uint8)property;
+    tw_ping_pong[i] = 0;
+    tw_sequence[i] = seq;
+    tw_round[i] = round;
+    return make_handle(tw_slot[i]);
+}
+
+// Tween a sequence property towards 'to' (unused channels are ignored).
+// Returns a tween handle, or -1 on failure.
+int tween_sequence(Sequence* seq, TweenProperty property, const float to[4],
+                   float seconds, EaseType easing) {
+    return start_tween(seq, NULL, property, to, seconds, easing);
+}
+
+// Tween a round sequence property (TWEEN_SIZE animates the diameter)
+int tween_round_sequence(RoundSequence* seq, TweenProperty property, const float to[4],
+                         float seconds, EaseType easing) {
+    return start_tween(NULL, seq, property, to, seconds, easing);
+}
+
+int tween_sequence_position(Sequence* seq, int x, int y, float seconds, EaseType easing) {
+    const float to[4] = {(float)x, (float)y, 0.0f, 0.0f};
+    return tween_sequence(seq, TWEEN_POSITION, to, seconds, easing);
+}
+
+int tween_sequence_size(Sequence* seq, int w, int h, float seconds, EaseType easing) {
+    const float to[4] = {(float)w, (float)h, 0.0f, 0.0f};
+    return tween_sequence(seq, TWEEN_SIZE, to, seconds, easing);
+}
+
+int tween_sequence_color(Sequence* seq, Color color, float seconds, EaseType easing) {
+    const float to[4] = {color.r, color.g, color.b, color.a};
+    return tween_sequence(seq, TWEEN_COLOR, to, seconds, easing);
+}
+
+int tween_sequence_alpha(Sequence* seq, Uint8 opacity, float seconds, EaseType easing) {
+    const float to[4] = {opacity, 0.0f, 0.0f, 0.0f};
+    return tween_sequence(seq, TWEEN_ALPHA, to, seconds, easing);
+}
+
+// Make a tween run back and forth until cancelled
+void set_tween_ping_pong(int tween, int ping_pong) {
+    int i = handle_index(tween);
+    if (i >= 0) tw_ping_pong[i] = ping_pong ? 1 : 0;
+}
+
+int is_tween_active(int tween) {
+    return handle_index(tween) >= 0;
+}
+
+// Stop a tween where it is
+void cancel_tween(int tween) {
+    int i = handle_index(tween);
+    if (i >= 0) remove_tween(i);
+}
+
+// Stop every tween driving a sequence
+void cancel_sequence_tweens(const Sequence* seq) {
+    for (int i = tween_count - 1; i >= 0; i--) {
+        if (tw_sequence[i] == seq) remove_tween(i);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Per-frame update
+// -----------------------------------------------------------------------------
+
+static Uint8 to_byte(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 255.0f) return 255;
+    return (Uint8)(v + 0.5f);
+}
+
+// Write the interpolated value of packed tween i to its element
+static void apply_tween(int i) {
+    Sequence* seq = tw_sequence[i];
+    RoundSequence* round = tw_round[i];
+    int a = (int)lroundf(tw_value[0][i]);
+    int b = (int)lroundf(tw_value[1][i]);
+
+    switch (tw_property[i]) {
+        case TWEEN_POSITION:
+            if (seq) update_sequence_position(seq, a, b);
+            else update_round_sequence_position(round, a, b);
+            break;
+        case TWEEN_SIZE:
+            if (seq) update_sequence_size(seq, a, b);
+            else update_round_sequence_radius(round, a / 2);
+            break;
+        case TWEEN_COLOR: {
+            Color color = create_color(to_byte(tw_value[0][i]), to_byte(tw_value[1][i]),
+                                       to_byte(tw_value[2][i]), to_byte(tw_value[3][i]));
+            if (seq) update_sequence_color(seq, color);
+            else update_round_sequence_color(round, color);
+            break;
+        }
+        case TWEEN_ALPHA:
+            if (seq) set_sequence_opacity(seq, to_byte(tw_value[0][i]));
+            else {
+                Color color = round->color;
+                color.a = to_byte(tw_value[0][i]);
+                update_round_sequence_color(round, color);
+            }
+            break;
+        case TWEEN_RADIUS:
+            update_round_sequence_radius(round, a);
+            break;
+    }
+}
+
+// Clock, easing and interpolation of packed tweens [begin, end)
+static void advance_tweens(int begin, int end, void* data) {
+    const float dt = *(const float*)data;
+
+    // Clock: normalized progress, folded back for ping-pong tweens
+    for (int i = begin; i < end; i++) {
+        tw_elapsed[i] += dt;
+        float t = tw_elapsed[i] * tw_inv_duration[i];
+        float folded = t - 2.0f * floorf(t * 0.5f);
+        folded = folded > 1.0f ? 2.0f - folded : folded;
+        t = t > 1.0f ? 1.0f : t;
+        tw_progress[i] = tw_ping_pong[i] ? folded : t;
+    }
+
+    // Easing (linear tweens keep their progress)
+    for (int i = begin; i < end; i++) {
+        if (tw_ease[i] != EASE_LINEAR) tw_progress[i] = ease(tw_ease[i], tw_progress[i]);
+    }
+
+    // Interpolation, one channel at a time
+    for (int c = 0; c < TWEEN_CHANNELS; c++) {
+        const float* from = tw_from[c];
+        const float* delta = tw_delta[c];
+        float* value = tw_value[c];
+        for (int i = begin; i < end; i++) {
+            value[i] = from[i] + delta[i] * tw_progress[i];
+        }
+    }
+}
+
+// Advance every tween by the frame time and apply the results. The math is
+// spread over the job workers; writing back stays on the calling thread.
+void update_tweens(double frame_seconds) {
+    float dt = (float)frame_seconds;
+    const int n = tween_count;
+
+    parallel_for(n, TWEEN_PARALLEL_BATCH, advance_tweens, &dt);
+
+    // Write back, retiring finished tweens from the end so that swapped-in
+    // tweens have already been applied
+    for (int i = n - 1; i >= 0; i--) {
+        apply_tween(i);
+        if (!tw_ping_pong[i] && tw_elapsed[i] * tw_inv_duration[i] >= 1.0f) {
+            remove_tween(i);
+        }
+    }
+}
+
+int get_active_tween_count(void) {
+    return tween_count;
+}
+
+// Drop every tween (elements keep their current values)
+void clear_tweens(void) {
+    if (free_slot_count < 0) return;
+    while (tween_count > 0) remove_tween(tween_count - 1);
+}